@@ -0,0 +1,92 @@
+// Copyright (c) 2026 Simons Foundation
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You may obtain a copy of the License at
+//     https://www.gnu.org/licenses/gpl-3.0.txt
+
+#include <benchmark/benchmark.h>
+#include <triqs/det_manip/det_manip.hpp>
+#include <cmath>
+#include <random>
+#include <vector>
+
+// Inverse stored in double vs single precision, for large matrices
+
+struct fun {
+  using result_type   = double;
+  using argument_type = double;
+  double operator()(double x, double y) const {
+    const double pi = std::acos(-1), beta = 10.0, epsi = 0.1;
+    double tau = x - y;
+    tau        = (tau > 0 ? tau : beta + tau);
+    return -2 * (pi / beta) / std::sin(pi * (epsi + tau / beta * (1 - 2 * epsi)));
+  }
+};
+
+template <typename D> D make_det(long N) {
+  std::mt19937 gen(12345);
+  std::uniform_real_distribution<> dis(0.0, 10.0);
+  std::vector<double> x(N), y(N);
+  for (long i = 0; i < N; ++i) {
+    x[i] = dis(gen);
+    y[i] = dis(gen);
+  }
+  auto d = D{fun{}, x, y};
+  d.set_n_operations_before_check(1000000);
+  return d;
+}
+
+// Insertion and removal of a row and a column: the rank-1 updates of the inverse (gemv, ger)
+template <typename D> static void DetManipInsertRemove(benchmark::State &state) {
+  long N = state.range(0);
+  auto d = make_det<D>(N);
+  std::mt19937 gen(23432);
+  std::uniform_real_distribution<> dis(0.0, 10.0);
+  for (auto _ : state) {
+    d.try_insert(gen() % (N + 1), gen() % (N + 1), dis(gen), dis(gen));
+    d.complete_operation();
+    d.try_remove(gen() % (N + 1), gen() % (N + 1));
+    d.complete_operation();
+  }
+  state.SetBytesProcessed(int64_t(state.iterations()) * 4 * N * N * sizeof(typename D::inv_value_type));
+}
+
+// Insertion and removal of 4 rows and columns: the rank-k updates of the inverse (gemm)
+template <typename D> static void DetManipInsertRemove4(benchmark::State &state) {
+  long N = state.range(0);
+  auto d = make_det<D>(N);
+  std::mt19937 gen(23432);
+  std::uniform_real_distribution<> dis(0.0, 10.0);
+  for (auto _ : state) {
+    std::vector<long> i(4), j(4);
+    std::vector<double> x(4), y(4);
+    for (int k = 0; k < 4; ++k) {
+      i[k] = N + k;
+      j[k] = N + k;
+      x[k] = dis(gen);
+      y[k] = dis(gen);
+    }
+    d.try_insert_k(i, j, x, y);
+    d.complete_operation();
+    d.try_remove_k(i, j);
+    d.complete_operation();
+  }
+  state.SetBytesProcessed(int64_t(state.iterations()) * 4 * N * N * sizeof(typename D::inv_value_type));
+}
+
+using det_d = triqs::det_manip::det_manip<fun>;
+using det_f = triqs::det_manip::det_manip<fun, float>;
+
+BENCHMARK_TEMPLATE(DetManipInsertRemove, det_d)->Arg(250)->Arg(500)->Arg(1000);
+BENCHMARK_TEMPLATE(DetManipInsertRemove, det_f)->Arg(250)->Arg(500)->Arg(1000);
+BENCHMARK_TEMPLATE(DetManipInsertRemove4, det_d)->Arg(250)->Arg(500)->Arg(1000);
+BENCHMARK_TEMPLATE(DetManipInsertRemove4, det_f)->Arg(250)->Arg(500)->Arg(1000);
@@ -20,6 +20,7 @@
 
 #pragma once
 
+#include <limits>
 #include <string>
 #include <vector>
 #include <map>
@@ -42,6 +43,37 @@ namespace triqs {
     template <bool C> void h5_write(h5::group, std::string const &, atom_diag<C> const &);
     template <bool C> void h5_read(h5::group, std::string const &, atom_diag<C> &);
 
+    /// Set the number of threads used in the construction of atom_diag objects (default 1).
+    /// The Hamiltonian blocks and the :math:`C`, :math:`C^\dagger` matrices of the invariant subspaces are built
+    /// and diagonalized concurrently, the largest subspaces first.
+    void set_atom_diag_threads(int n);
+
+    /// The number of threads used in the construction of atom_diag objects
+    int get_atom_diag_threads();
+
+    /// Distribute the invariant subspaces over the MPI ranks in the construction of atom_diag objects (default false).
+    /// The results are broadcast at the end, so that all ranks hold the complete object.
+    /// NB : The atom_diag objects must then be constructed collectively, on all ranks.
+    void set_atom_diag_mpi(bool distribute);
+
+    /// Are the invariant subspaces distributed over the MPI ranks in the construction of atom_diag objects ?
+    bool get_atom_diag_mpi();
+
+    /// Truncation of the spectrum in the construction of atom_diag objects, for Hilbert spaces too large for a full diagonalization.
+    /// Only the low-energy eigenstates of each invariant subspace are computed, by a Lanczos solver on the sparse Hamiltonian
+    /// of the subspace, and all the atom_diag methods work in this truncated eigenbasis.
+    /// The eigenstates of a degenerate multiplet are kept or discarded together, and the subspaces without any eigenstate kept are discarded.
+    struct atom_diag_truncation {
+      /// Keep the eigenstates of energy :math:`E \leq E_{gs} +` energy_window (no limit if infinite)
+      double energy_window = std::numeric_limits<double>::infinity();
+
+      /// Keep at most the n_lowest lowest eigenstates of each subspace (no limit if negative)
+      long n_lowest = -1;
+
+      /// The subspaces of dimension <= dense_dim are fully diagonalized, and then truncated
+      long dense_dim = 256;
+    };
+
     using indices_t = fundamental_operator_set::indices_t;
     // Quantum number operators are Hermitian, hence their eigenvalues are real
     using quantum_number_t = double;
@@ -159,6 +191,28 @@ namespace triqs {
       atom_diag(many_body_op_t const &h, fundamental_operator_set const &fops, std::initializer_list<many_body_op_t> const &init_lst)
          : atom_diag(h, fops, std::vector<many_body_op_t>{init_lst}){};
 
+      /// Reduce a given Hamiltonian to a block-diagonal form, and compute its low-energy eigenstates only
+      /**
+       * Same as the auto-partition constructor, with the spectrum truncated as specified by `truncation`.
+       *
+       * @param h Hamiltonian operator to be diagonalized.
+       * @param fops Fundamental operator set; Must at least contain all fundamental operators met in `h`.
+       * @param truncation Energy window and maximal number of eigenstates per subspace.
+       */
+      TRIQS_CPP2PY_IGNORE atom_diag(many_body_op_t const &h, fundamental_operator_set const &fops, atom_diag_truncation const &truncation);
+
+      /// Reduce a given Hamiltonian to a block-diagonal form with quantum numbers, and compute its low-energy eigenstates only
+      /**
+       * Same as the quantum number constructor, with the spectrum truncated as specified by `truncation`.
+       *
+       * @param h Hamiltonian operator to be diagonalized.
+       * @param fops Fundamental operator set; Must at least contain all fundamental operators met in `h`.
+       * @param qn_vector Vector of quantum number operators.
+       * @param truncation Energy window and maximal number of eigenstates per subspace.
+       */
+      TRIQS_CPP2PY_IGNORE atom_diag(many_body_op_t const &h, fundamental_operator_set const &fops, std::vector<many_body_op_t> const &qn_vector,
+                                    atom_diag_truncation const &truncation);
+
       /// The Hamiltonian used at construction
       many_body_op_t const &get_h_atomic() const { return h_atomic; }
 
@@ -24,12 +24,29 @@
 #include <triqs/arrays.hpp>
 #include <triqs/hilbert_space/state.hpp>
 #include <triqs/hilbert_space/imperative_operator.hpp>
+#include <atomic>
 
 using namespace triqs::arrays;
 
 namespace triqs {
   namespace atom_diag {
 
+    namespace {
+      std::atomic<int> atom_diag_threads = 1;
+      std::atomic<bool> atom_diag_mpi    = false;
+    } // namespace
+
+    void set_atom_diag_threads(int n) {
+      if (n < 1) TRIQS_RUNTIME_ERROR << "atom_diag : the number of threads must be >= 1, not " << n;
+      atom_diag_threads = n;
+    }
+
+    int get_atom_diag_threads() { return atom_diag_threads; }
+
+    void set_atom_diag_mpi(bool distribute) { atom_diag_mpi = distribute; }
+
+    bool get_atom_diag_mpi() { return atom_diag_mpi; }
+
 // Methods of atom_diag
 #define ATOM_DIAG_CONSTRUCTOR(ARGS) template <bool Complex> atom_diag<Complex>::atom_diag ARGS
 #define ATOM_DIAG_METHOD(RET, F) template <bool Complex> auto atom_diag<Complex>::F->RET
@@ -66,6 +83,21 @@ namespace triqs {
       compute_vacuum();
     }
 
+    ATOM_DIAG_CONSTRUCTOR((many_body_op_t const &h, fundamental_operator_set const &fops, atom_diag_truncation const &truncation))
+       : h_atomic(h), fops(fops), full_hs(fops), vacuum(full_hs.size()) {
+      atom_diag_worker<Complex>{this, 0, INT_MAX, truncation}.autopartition();
+      fill_first_eigenstate_of_subspace();
+      compute_vacuum();
+    }
+
+    ATOM_DIAG_CONSTRUCTOR((many_body_op_t const &h, fundamental_operator_set const &fops, std::vector<many_body_op_t> const &qn_vector,
+                           atom_diag_truncation const &truncation))
+       : h_atomic(h), fops(fops), full_hs(fops), vacuum(full_hs.size()) {
+      atom_diag_worker<Complex>{this, 0, INT_MAX, truncation}.partition_with_qn(qn_vector);
+      fill_first_eigenstate_of_subspace();
+      compute_vacuum();
+    }
+
     // -----------------------------------------------------------------
 
     ATOM_DIAG_METHOD(void, fill_first_eigenstate_of_subspace()) {
@@ -79,8 +111,9 @@ namespace triqs {
     // -----------------------------------------------------------------
 
     ATOM_DIAG_METHOD(void, compute_vacuum()) {
-      // Compute vacuum vector in the eigenbasis
-      vacuum() = 0;
+      // Compute vacuum vector in the eigenbasis (its projection on the eigenstates kept, if the spectrum is truncated)
+      vacuum()              = 0;
+      vacuum_subspace_index = -1;
       for (int sp : range(sub_hilbert_spaces.size())) {
         if (sub_hilbert_spaces[sp].has_state(fock_state_t(0))) {
           vacuum_subspace_index               = sp;
@@ -124,7 +157,7 @@ namespace triqs {
             if (sp.has_state(j)) {
               Bp = sp.get_index();
 
-              if (m.empty()) { m = matrix_t::zeros({get_subspace_dim(Bp), get_subspace_dim(B)}); }
+              if (m.empty()) { m = matrix_t::zeros({sub_hilbert_spaces[Bp].size(), sub_hilbert_spaces[B].size()}); }
 
               m(sp.get_state_index(j), i_idx) = x;
               break;
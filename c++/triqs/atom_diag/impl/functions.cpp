@@ -22,6 +22,7 @@
 #include <cmath>
 #include <algorithm>
 #include <limits>
+#include <map>
 #include <triqs/arrays.hpp>
 #include <triqs/utility/numeric_ops.hpp>
 #include <triqs/utility/legendre.hpp>
@@ -139,13 +140,6 @@ namespace triqs {
     template std::vector<std::vector<quantum_number_t>> quantum_number_eigenvalues(ATOM_DIAG_C::many_body_op_t const &, ATOM_DIAG_C const &);
 
     // -----------------------------------------------------------------
-    template <typename M>
-    // require (ImmutableMatrix<M>)
-    inline bool is_diagonal(M const &m) {
-      double static const threshold = 1.e-11;
-      return triqs::utility::is_zero(sum(abs(m)) - trace(abs(m)), threshold);
-    }
-
     template <bool Complex>
     auto quantum_number_eigenvalues_checked(ATOM_DIAG_T::many_body_op_t const &op, ATOM_DIAG const &atom)
        -> std::vector<std::vector<quantum_number_t>> {
@@ -153,25 +147,31 @@ namespace triqs {
       auto commutator = op * atom.get_h_atomic() - atom.get_h_atomic() * op;
       if (!commutator.is_almost_zero()) TRIQS_RUNTIME_ERROR << "The operator is not a quantum number";
 
-      auto d = atom.get_full_hilbert_space_dim();
-      matrix<quantum_number_t> M(d, d);
-      M() = 0;
       std::vector<std::vector<quantum_number_t>> result;
+      double off_diagonal = 0; // sum of the moduli of the off-diagonal elements of the operator in the eigenbasis
 
+      // The matrix of the operator in the eigenbasis, block by block : for each subspace sp, the blocks from sp to the subspaces
+      // connected to it by the monomials. Only the eigenstates of the subspaces are involved (the kept ones, for a truncated atom_diag).
       for (int sp = 0; sp < atom.n_subspaces(); ++sp) {
+        std::map<int, matrix<quantum_number_t>> blocks; // target subspace -> block
         for (auto const &x : op) {
           auto b_m = atom.get_matrix_element_of_monomial(x.monomial, sp);
           if (b_m.first == -1) continue;
-          M(atom.index_range_of_subspace(b_m.first), atom.index_range_of_subspace(sp)) += real(x.coef * b_m.second);
+          auto it = blocks.find(b_m.first);
+          if (it == blocks.end()) it = blocks.emplace(b_m.first, matrix<quantum_number_t>::zeros(b_m.second.shape())).first;
+          it->second += real(x.coef * b_m.second);
         }
-      }
-      if (!is_diagonal(M)) TRIQS_RUNTIME_ERROR << "The matrix of the operator is not diagonal !!!";
 
-      for (int sp = 0; sp < atom.n_subspaces(); ++sp) {
         auto dim = atom.get_subspace_dim(sp);
         result.push_back(std::vector<quantum_number_t>(dim, 0));
-        for (int i = 0; i < dim; ++i) result.back()[i] = M(atom.flatten_subspace_index(sp, i), atom.flatten_subspace_index(sp, i));
+        for (auto const &[target, m] : blocks) {
+          off_diagonal += sum(abs(m));
+          if (target != sp) continue;
+          off_diagonal -= trace(abs(m));
+          for (int i = 0; i < dim; ++i) result.back()[i] = m(i, i);
+        }
       }
+      if (!triqs::utility::is_zero(off_diagonal, 1.e-11)) TRIQS_RUNTIME_ERROR << "The matrix of the operator is not diagonal !!!";
 
       return result;
     }
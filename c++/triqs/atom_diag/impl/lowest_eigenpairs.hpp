@@ -0,0 +1,269 @@
+// Copyright (c) 2026 Simons Foundation
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You may obtain a copy of the License at
+//     https://www.gnu.org/licenses/gpl-3.0.txt
+
+#pragma once
+
+#include <triqs/arrays.hpp>
+#include <triqs/utility/exceptions.hpp>
+#include <nda/linalg/eigenelements.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <tuple>
+#include <vector>
+
+// Low-energy eigenpairs of the large subspace Hamiltonians of atom_diag (truncated mode), by thick-restart Lanczos
+namespace triqs::atom_diag::details {
+
+  template <typename T> T conj_if_complex(T const &x) {
+    if constexpr (nda::is_complex_v<T>)
+      return std::conj(x);
+    else
+      return x;
+  }
+
+  // <a|b>
+  template <typename T> T cdot(T const *a, T const *b, long n) {
+    T r = 0;
+    for (long i = 0; i < n; ++i) r += conj_if_complex(a[i]) * b[i];
+    return r;
+  }
+
+  template <typename T> double norm2(T const *a, long n) { return std::sqrt(std::real(cdot(a, a, n))); }
+
+  // A Hermitian matrix in compressed sparse row format
+  template <typename T> class csr_matrix {
+    long _dim = 0;
+    std::vector<long> row_start;
+    std::vector<int> cols;
+    std::vector<T> vals;
+
+    public:
+    // From (i, j, x) triplets adding x to the element (j, i). The triplets of the same element are summed.
+    csr_matrix(long dim, std::vector<std::tuple<int, int, T>> triplets) : _dim(dim), row_start(dim + 1, 0) {
+      std::sort(triplets.begin(), triplets.end(), [](auto const &a, auto const &b) {
+        return std::tie(std::get<1>(a), std::get<0>(a)) < std::tie(std::get<1>(b), std::get<0>(b));
+      });
+      for (auto const &[i, j, x] : triplets) {
+        if (not cols.empty() and row_start[j + 1] > 0 and cols.back() == i) {
+          vals.back() += x;
+          continue;
+        }
+        cols.push_back(i);
+        vals.push_back(x);
+        ++row_start[j + 1];
+      }
+      std::partial_sum(row_start.begin(), row_start.end(), row_start.begin());
+    }
+
+    long dim() const { return _dim; }
+
+    // y = A x
+    void apply(T const *x, T *y) const {
+      for (long j = 0; j < _dim; ++j) {
+        T r = 0;
+        for (long l = row_start[j]; l < row_start[j + 1]; ++l) r += vals[l] * x[cols[l]];
+        y[j] = r;
+      }
+    }
+
+    // Upper bound of the norm : the maximal absolute row sum
+    double norm_bound() const {
+      double r = 0;
+      for (long j = 0; j < _dim; ++j) {
+        double s = 0;
+        for (long l = row_start[j]; l < row_start[j + 1]; ++l) s += std::abs(vals[l]);
+        r = std::max(r, s);
+      }
+      return r;
+    }
+  };
+
+  // Eigenpairs, in no particular order
+  template <typename T> struct eigenpairs_t {
+    std::vector<double> values;
+    std::vector<std::vector<T>> vectors;
+    long size() const { return values.size(); }
+  };
+
+  // The k lowest eigenpairs of h restricted to the orthogonal complement of the locked eigenvectors,
+  // by Lanczos with full reorthogonalization, restarted from the wanted Ritz vectors (thick restart).
+  template <typename T> eigenpairs_t<T> lanczos_lowest(csr_matrix<T> const &h, eigenpairs_t<T> const &locked, long k, std::mt19937 &rng) {
+    long dim    = h.dim();
+    long n_free = dim - locked.size();
+    k           = std::min(k, n_free);
+    long m      = std::min(n_free, std::max(2 * k + 20, 40l)); // maximal dimension of the Krylov space
+    double tol  = 1.e-10 * std::max(1.0, h.norm_bound());
+
+    // Orthonormal basis (rows of V) of the Krylov space, and W = h V
+    std::vector<std::vector<T>> V, W;
+    V.reserve(m);
+    W.reserve(m);
+
+    // Orthogonalize w against the locked vectors and V (twice, for stability)
+    std::vector<std::vector<T>> const *bases[] = {&locked.vectors, &V};
+    auto orthogonalize                         = [&](std::vector<T> &w) {
+      for (int pass = 0; pass < 2; ++pass) {
+        for (auto const *basis : bases)
+          for (auto const &v : *basis) {
+            T c = cdot(v.data(), w.data(), dim);
+            for (long i = 0; i < dim; ++i) w[i] -= c * v[i];
+          }
+      }
+    };
+
+    // Add w to the basis, if it is not in the span of the locked vectors and V
+    auto add_to_basis = [&](std::vector<T> w) {
+      double n0 = norm2(w.data(), dim);
+      orthogonalize(w);
+      double n1 = norm2(w.data(), dim);
+      if (n1 <= 1.e-8 * n0 or n1 == 0) return false;
+      for (auto &x : w) x /= n1;
+      std::vector<T> hw(dim);
+      h.apply(w.data(), hw.data());
+      V.push_back(std::move(w));
+      W.push_back(std::move(hw));
+      return true;
+    };
+
+    auto random_vector = [&]() {
+      std::uniform_real_distribution<double> u(-1, 1);
+      std::vector<T> w(dim);
+      for (auto &x : w) {
+        if constexpr (nda::is_complex_v<T>)
+          x = T{u(rng), u(rng)};
+        else
+          x = u(rng);
+      }
+      return w;
+    };
+
+    // Expand the Krylov space from its last vector, or from a random vector if it is invariant
+    auto expand = [&]() {
+      while (long(V.size()) < m) {
+        if (not V.empty() and add_to_basis(W.back())) continue;
+        if (not add_to_basis(random_vector())) break;
+      }
+    };
+
+    constexpr int max_restarts = 10000;
+    for (int restart = 0; restart < max_restarts; ++restart) {
+      expand();
+      long j = V.size();
+
+      // Rayleigh-Ritz
+      auto t = nda::matrix<T>(j, j);
+      for (long a = 0; a < j; ++a)
+        for (long b = 0; b <= a; ++b) {
+          t(a, b) = cdot(V[a].data(), W[b].data(), dim);
+          t(b, a) = conj_if_complex(t(a, b));
+        }
+      for (long a = 0; a < j; ++a) t(a, a) = std::real(t(a, a));
+      auto [theta, S] = nda::linalg::eigenelements(t);
+
+      // The Ritz vectors kept on restart : the k wanted ones, and a few more to speed up the convergence
+      long p = std::min(j, k + std::max(k / 2, 5l));
+      std::vector<std::vector<T>> X(p, std::vector<T>(dim, 0)), HX(p, std::vector<T>(dim, 0));
+      for (long i = 0; i < p; ++i)
+        for (long a = 0; a < j; ++a) {
+          T s = S(a, i);
+          for (long l = 0; l < dim; ++l) {
+            X[i][l] += s * V[a][l];
+            HX[i][l] += s * W[a][l];
+          }
+        }
+
+      bool converged = true;
+      for (long i = 0; i < k and converged; ++i) {
+        double r = 0;
+        for (long l = 0; l < dim; ++l) r += std::norm(HX[i][l] - theta(i) * X[i][l]);
+        converged = (std::sqrt(r) <= tol);
+      }
+
+      if (converged or j == n_free) {
+        eigenpairs_t<T> res;
+        for (long i = 0; i < k; ++i) {
+          res.values.push_back(theta(i));
+          res.vectors.push_back(std::move(X[i]));
+        }
+        return res;
+      }
+
+      // Restart from the Ritz vectors, continued by the residual of the Krylov space, h applied to its last vector
+      // and orthogonalized against it : h X lies in the span of X and this residual
+      auto next = W.back();
+      orthogonalize(next);
+      V = std::move(X);
+      W         = std::move(HX);
+      if (not add_to_basis(std::move(next))) add_to_basis(random_vector());
+    }
+    TRIQS_RUNTIME_ERROR << "atom_diag : the Lanczos iterations did not converge in a subspace of dimension " << dim;
+  }
+
+  // The energy of the highest eigenstate kept, among those of the given energies :
+  // all those of energy <= e_max, and at most the n_max lowest ones (n_max < 0 : no limit)
+  inline double energy_cut(std::vector<double> values, double e_max, long n_max) {
+    std::sort(values.begin(), values.end());
+    if (n_max >= 0 and long(values.size()) >= n_max) return std::min(e_max, (n_max == 0 ? -std::numeric_limits<double>::infinity() : values[n_max - 1]));
+    return e_max;
+  }
+
+  // Degenerate eigenstates are kept or discarded together
+  inline double degeneracy_tolerance(double e) { return 1.e-8 * std::max(1.0, std::abs(e)); }
+
+  /**
+   * The low-energy eigenpairs of h : all those of energy <= energy_cut(spectrum, e_max, n_max), with all their degenerate partners.
+   *
+   * Runs of the Lanczos solver on h deflated by the eigenpairs already found, from random starting vectors, until the lowest
+   * remaining eigenvalue is above the cut : the eigenstates of a degenerate multiplet, which a single Krylov space
+   * can not resolve, are found by successive runs. The eigenpairs of previous calls can be passed in locked.
+   */
+  template <typename T> eigenpairs_t<T> lowest_eigenpairs(csr_matrix<T> const &h, double e_max, long n_max, eigenpairs_t<T> locked, unsigned seed) {
+    std::mt19937 rng(seed);
+    while (locked.size() < h.dim()) {
+      double cut = energy_cut(locked.values, e_max, n_max);
+      long k     = (n_max >= 0 and locked.size() < n_max) ? n_max - locked.size() : std::max(8l, locked.size());
+      auto found = lanczos_lowest(h, locked, std::max(1l, k), rng);
+      if (found.values[0] > cut + degeneracy_tolerance(cut)) break;
+      for (long i = 0; i < found.size(); ++i) {
+        locked.values.push_back(found.values[i]);
+        locked.vectors.push_back(std::move(found.vectors[i]));
+      }
+    }
+    return locked;
+  }
+
+  // Sort the eigenpairs, and keep those of energy <= energy_cut(values, e_max, n_max) and their degenerate partners
+  // Returns the eigenvalues and the unitary matrix (eigenvectors as columns)
+  template <typename T> std::pair<nda::vector<double>, nda::matrix<T>> truncate(eigenpairs_t<T> const &ep, long dim, double e_max, long n_max) {
+    double cut = energy_cut(ep.values, e_max, n_max);
+    std::vector<long> order;
+    for (long i = 0; i < ep.size(); ++i)
+      if (ep.values[i] <= cut + degeneracy_tolerance(cut)) order.push_back(i);
+    std::sort(order.begin(), order.end(), [&ep](long i, long j) { return ep.values[i] < ep.values[j]; });
+    auto values = nda::vector<double>(order.size());
+    auto U      = nda::matrix<T>(dim, order.size());
+    for (long c = 0; c < long(order.size()); ++c) {
+      values(c) = ep.values[order[c]];
+      for (long l = 0; l < dim; ++l) U(l, c) = ep.vectors[order[c]][l];
+    }
+    return {std::move(values), std::move(U)};
+  }
+
+} // namespace triqs::atom_diag::details
@@ -21,18 +21,69 @@
 #include "./worker.hpp"
 
 #include <vector>
+#include <algorithm>
+#include <atomic>
 #include <bitset>
+#include <cmath>
+#include <exception>
+#include <functional>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include <tuple>
+#include <utility>
 #include <triqs/hilbert_space/state.hpp>
 #include <triqs/hilbert_space/imperative_operator.hpp>
 #include <triqs/hilbert_space/space_partition.hpp>
 #include <nda/linalg/eigenelements.hpp>
+#include "./lowest_eigenpairs.hpp"
 
 using namespace triqs::hilbert_space;
 
 namespace triqs {
   namespace atom_diag {
 
+    namespace {
+
+      // The indices of the tasks, by decreasing cost
+      std::vector<long> largest_first(std::vector<double> const &cost) {
+        std::vector<long> order(cost.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&cost](long i, long j) { return cost[i] > cost[j]; });
+        return order;
+      }
+
+      // Run f(t) for the tasks t = rank, rank + n_ranks, ... of [0, n_tasks), on get_atom_diag_threads() threads.
+      // Each thread takes the next task as soon as it is done with the previous one : with the tasks ordered by decreasing cost,
+      // the large tasks are started first and the small ones fill the gaps.
+      void run_tasks(long n_tasks, int n_ranks, int rank, std::function<void(long)> const &f) {
+        long n_local = (n_tasks > rank ? (n_tasks - rank - 1) / n_ranks + 1 : 0);
+        std::atomic<long> next = 0;
+        std::exception_ptr error;
+        std::mutex error_mutex;
+        auto work = [&]() {
+          for (long i = next++; i < n_local; i = next++) {
+            try {
+              f(rank + i * n_ranks);
+            } catch (...) {
+              std::lock_guard lock{error_mutex};
+              if (!error) error = std::current_exception();
+              next = n_local;
+            }
+          }
+        };
+        long n_threads = std::min<long>(get_atom_diag_threads(), n_local);
+        std::vector<std::thread> threads;
+        for (long th = 1; th < n_threads; ++th) threads.emplace_back(work);
+        work();
+        for (auto &th : threads) th.join();
+        if (error) std::rethrow_exception(error);
+      }
+
+    } // namespace
+
 // Methods of atom_diag_worker
 #define ATOM_DIAG_WORKER_METHOD(RET, F) template <bool Complex> auto atom_diag_worker<Complex>::F->RET
 
@@ -59,7 +110,7 @@ namespace triqs {
 
       using space_partition_t = space_partition<state<class hilbert_space, scalar_t, true>, imperative_operator_t>;
       // Split the Hilbert space
-      space_partition_t SP(st, hamiltonian, false, hybridization);
+      space_partition_t SP(st, hamiltonian, false, hybridization, get_atom_diag_threads());
 
       std::vector<typename space_partition_t::matrix_element_map_t> creation_melem(fops.size());
       std::vector<typename space_partition_t::matrix_element_map_t> annihilation_melem(fops.size());
@@ -149,11 +200,12 @@ namespace triqs {
       std::vector<imperative_operator<class hilbert_space, scalar_t>> qsize;
       for (auto &qn : qn_vector) qsize.emplace_back(qn, fops);
 
-      // Helper function to get quantum numbers
-      auto get_quantum_numbers = [&qsize](state<class hilbert_space, scalar_t, false> const &s) {
+      // Helper function to get the quantum numbers of a Fock state : the diagonal elements of the operators, computed on the bits of the state
+      auto get_quantum_numbers = [&qsize](fock_state_t fs) {
         std::vector<quantum_number_t> qn;
+        qn.reserve(qsize.size());
         for (auto const &op : qsize) {
-          auto y = dot_product(s, op(s));
+          auto y = op.diagonal_element(fs);
           if (std::abs(std::imag(y)) > 1.e-10) TRIQS_RUNTIME_ERROR << "Quantum number is complex !";
           qn.push_back(std::real(y));
         }
@@ -162,89 +214,47 @@ namespace triqs {
 
       // The first part consists in dividing the full Hilbert space
       // into smaller subspaces using the quantum numbers
+      std::vector<int> subspace_of_state(full_hs.size());
       for (int r = 0; r < full_hs.size(); ++r) {
 
-        // fock_state corresponding to r
-        fock_state_t fs = full_hs.get_fock_state(r);
-
-        // The state we'll act on
-        state<class hilbert_space, scalar_t, false> s(full_hs);
-        s(r) = 1.0;
-
-        // Create the vector with the quantum numbers
-        std::vector<quantum_number_t> qn = get_quantum_numbers(s);
+        // fock_state corresponding to r, and its quantum numbers
+        fock_state_t fs                  = full_hs.get_fock_state(r);
+        std::vector<quantum_number_t> qn = get_quantum_numbers(fs);
 
         // If first time we meet these quantum numbers create partial Hilbert space
-        if (map_qn_n.count(qn) == 0) {
-          auto n_blocks = hdiag->sub_hilbert_spaces.size();
-          hdiag->sub_hilbert_spaces.emplace_back(n_blocks); // a new sub_hilbert_space
+        auto [it, is_new] = map_qn_n.try_emplace(qn, hdiag->sub_hilbert_spaces.size());
+        if (is_new) {
+          hdiag->sub_hilbert_spaces.emplace_back(it->second); // a new sub_hilbert_space
           hdiag->quantum_numbers.push_back(qn);
-          map_qn_n[qn] = n_blocks;
         }
 
         // Add fock state to partial Hilbert space
-        hdiag->sub_hilbert_spaces[map_qn_n[qn]].add_fock_state(fs);
+        hdiag->sub_hilbert_spaces[it->second].add_fock_state(fs);
+        subspace_of_state[r] = it->second;
       }
 
       // ---- Now make the creation/annihilation maps -----
 
-      auto creation_map     = std::vector<std::vector<int>>(fops.size(), std::vector<int>(hdiag->sub_hilbert_spaces.size(), -1));
-      auto annihilation_map = creation_map;
-
       // init the mapping tables
       hdiag->creation_connection.resize(fops.size(), hdiag->sub_hilbert_spaces.size());
       hdiag->annihilation_connection.resize(fops.size(), hdiag->sub_hilbert_spaces.size());
       hdiag->creation_connection.as_array_view()     = -1;
       hdiag->annihilation_connection.as_array_view() = -1;
 
+      // C^\dagger_n |fs> is nonzero iff the bit n of fs is not set, C_n |fs> iff it is set, and both give the Fock state fs ^ (1 << n)
       for (auto const &x : fops) {
-
-        // Get the operators and their index
-        int n        = x.linear_index;
-        auto create  = many_body_op_t::make_canonical(true, x.index);
-        auto destroy = many_body_op_t::make_canonical(false, x.index);
-
-        // Construct their imperative counterpart
-        imperative_operator<class hilbert_space, scalar_t> op_c_dag(create, fops), op_c(destroy, fops);
-
-        // to avoid declaring every time in the loop below
-        std::vector<quantum_number_t> qn_before, qn_after;
-
-        // Now act on the state with the c, c_dag to see how quantum numbers change
+        int n             = x.linear_index;
+        fock_state_t mask = fock_state_t(1) << n;
         for (int r = 0; r < full_hs.size(); ++r) {
-
-          // The state we'll act on and its quantum numbers
-          state<class hilbert_space, scalar_t, false> s(full_hs);
-          s(r)      = 1.0;
-          qn_before = get_quantum_numbers(s);
-
-          // Apply creation on state to figure quantum numbers
-          qn_after = get_quantum_numbers(op_c_dag(s));
-
-          // Insert in creation map checking whether it was already there
-          if (!triqs::utility::is_zero(dot_product(op_c_dag(s), op_c_dag(s)))) {
-            auto origin = hdiag->sub_hilbert_spaces[map_qn_n[qn_before]].get_index();
-            auto target = hdiag->sub_hilbert_spaces[map_qn_n[qn_after]].get_index();
-            if (creation_map[n][origin] == -1)
-              creation_map[n][origin] = target;
-            else if (creation_map[n][origin] != target)
-              TRIQS_RUNTIME_ERROR << "partition_with_qn(): internal error while filling creation_connection";
-            hdiag->creation_connection(n, map_qn_n[qn_before]) = map_qn_n[qn_after];
-          }
-
-          // apply annihilation on state to figure quantum numbers
-          qn_after = get_quantum_numbers(op_c(s));
-
-          // insert in annihilation map checking whether it was already there
-          if (!triqs::utility::is_zero(dot_product(op_c(s), op_c(s)))) {
-            auto origin = hdiag->sub_hilbert_spaces[map_qn_n[qn_before]].get_index();
-            auto target = hdiag->sub_hilbert_spaces[map_qn_n[qn_after]].get_index();
-            if (annihilation_map[n][origin] == -1)
-              annihilation_map[n][origin] = target;
-            else if (annihilation_map[n][origin] != target)
-              TRIQS_RUNTIME_ERROR << "partition_with_qn(): internal error while filling annihilation_connection";
-            hdiag->annihilation_connection(n, map_qn_n[qn_before]) = map_qn_n[qn_after];
-          }
+          fock_state_t fs  = full_hs.get_fock_state(r);
+          bool occupied    = (fs & mask);
+          auto &connection = (occupied ? hdiag->annihilation_connection : hdiag->creation_connection);
+          long origin      = subspace_of_state[r];
+          long target      = subspace_of_state[full_hs.get_state_index(fs ^ mask)];
+          if (connection(n, origin) == -1)
+            connection(n, origin) = target;
+          else if (connection(n, origin) != target)
+            TRIQS_RUNTIME_ERROR << "partition_with_qn(): internal error while filling " << (occupied ? "annihilation" : "creation") << "_connection";
         }
       }
       complete();
@@ -255,24 +265,18 @@ namespace triqs {
     ATOM_DIAG_WORKER_METHOD(matrix_t, make_op_matrix(many_body_op_t const &op, int from_spn, int to_spn) const) {
 
       fundamental_operator_set const &fops = hdiag->get_fops();
-      class hilbert_space const &full_hs   = hdiag->full_hs;
       auto const &from_sp                  = hdiag->sub_hilbert_spaces[from_spn];
       auto const &to_sp                    = hdiag->sub_hilbert_spaces[to_spn];
 
       imperative_operator<class hilbert_space, scalar_t> imp_op(op, fops);
 
-      auto M = matrix_t::zeros({to_sp.size(), from_sp.size()});
+      // op * U_from, accumulated row by row from the nonzero elements of op, which is very sparse
+      // (e.g. a single element per column for C, C^\dagger) : only the result is dense
+      auto const &U_from = hdiag->eigensystems[from_spn].unitary_matrix;
+      auto opU           = matrix_t::zeros({to_sp.size(), second_dim(U_from)});
+      imp_op.for_each_matrix_element(from_sp, to_sp, [&](int i, int j, scalar_t x) { opU(j, range::all) += x * U_from(i, range::all); });
 
-      for (int i = 0; i < from_sp.size(); ++i) { // loop on all fock states of the blocks
-        state<class hilbert_space, scalar_t, true> from_s(full_hs);
-        from_s(from_sp.get_fock_state(i)) = 1.0;
-        auto to_s                         = imp_op(from_s);
-        auto proj_s                       = project<state<sub_hilbert_space, scalar_t, true>>(to_s, to_sp);
-        foreach (proj_s, [&](int j, scalar_t ampl) { M(j, i) = ampl; })
-          ;
-      }
-
-      return dagger(hdiag->eigensystems[to_spn].unitary_matrix) * M * hdiag->eigensystems[from_spn].unitary_matrix;
+      return dagger(hdiag->eigensystems[to_spn].unitary_matrix) * opU;
     }
 
     // -----------------------------------------------------------------
@@ -284,86 +288,166 @@ namespace triqs {
 
       imperative_operator<class hilbert_space, scalar_t, false> hamiltonian(h, fops);
 
-      //  Compute energy levels and eigenvectors of the local Hamiltonian
+      auto c          = mpi::communicator{};
+      bool distribute = get_atom_diag_mpi() and mpi::has_env and c.size() > 1;
+      int n_ranks     = (distribute ? c.size() : 1);
+      int rank        = (distribute ? c.rank() : 0);
+      auto owner      = [n_ranks](long t) { return int(t % n_ranks); };
+
+      //  Compute energy levels and eigenvectors of the local Hamiltonian, the largest subspaces first
       int n_subspaces = hdiag->sub_hilbert_spaces.size();
       hdiag->eigensystems.resize(n_subspaces);
       hdiag->gs_energy = std::numeric_limits<double>::infinity();
 
-      // Prepare the eigensystem in a temporary map to sort them by energy !
-      std::map<std::pair<double, int>, typename atom_diag<Complex>::eigensystem_t> eign_map;
-      double energy_split = 1.e-10; // to split the eigenvalues, which are numerically very close
+      // In truncated mode, the subspaces larger than dense_dim are diagonalized iteratively, on their sparse Hamiltonian
+      bool truncated = std::isfinite(truncation.energy_window) or truncation.n_lowest >= 0;
+      auto is_sparse = [&](int spn) { return truncated and hdiag->sub_hilbert_spaces[spn].size() > truncation.dense_dim; };
+      std::vector<std::unique_ptr<details::csr_matrix<scalar_t>>> sparse_h(n_subspaces);
+      std::vector<details::eigenpairs_t<scalar_t>> sparse_eigenpairs(n_subspaces);
+
+      std::vector<double> subspace_cost(n_subspaces);
       for (int spn = 0; spn < n_subspaces; ++spn) {
-        auto const &sp = hdiag->sub_hilbert_spaces[spn];
-        typename atom_diag<Complex>::eigensystem_t eigensystem;
+        double d           = hdiag->sub_hilbert_spaces[spn].size();
+        subspace_cost[spn] = (is_sparse(spn) ? d * d : d * d * d);
+      }
+      auto subspace_order = largest_first(subspace_cost);
 
-        state<sub_hilbert_space, scalar_t, false> i_state(sp);
-        auto h_matrix = matrix_t(sp.size(), sp.size());
+      run_tasks(subspace_order.size(), n_ranks, rank, [&](long t) {
+        int spn        = subspace_order[t];
+        auto const &sp = hdiag->sub_hilbert_spaces[spn];
 
-        for (int i = 0; i < sp.size(); ++i) {
-          i_state.amplitudes()()  = 0;
-          i_state(i)              = 1;
-          auto f_state            = hamiltonian(i_state);
-          h_matrix(range::all, i) = f_state.amplitudes();
+        if (is_sparse(spn)) {
+          std::vector<std::tuple<int, int, scalar_t>> triplets;
+          hamiltonian.for_each_matrix_element(sp, sp, [&triplets](int i, int j, scalar_t x) { triplets.emplace_back(i, j, x); });
+          sparse_h[spn] = std::make_unique<details::csr_matrix<scalar_t>>(sp.size(), std::move(triplets));
+          // Only the lowest multiplet at this stage, to find the ground state energy
+          sparse_eigenpairs[spn] = details::lowest_eigenpairs(*sparse_h[spn], std::numeric_limits<double>::infinity(), 1, {}, spn);
+          auto const &e          = sparse_eigenpairs[spn].values;
+          hdiag->eigensystems[spn].eigenvalues = vector<double>{*std::min_element(e.begin(), e.end())};
+          return;
         }
 
-        auto eig                   = linalg::eigenelements(h_matrix);
-        eigensystem.eigenvalues    = eig.first;
-        eigensystem.unitary_matrix = eig.second;
-        hdiag->gs_energy           = std::min(hdiag->gs_energy, eigensystem.eigenvalues[0]);
+        auto h_matrix = matrix_t::zeros({sp.size(), sp.size()});
+        hamiltonian.for_each_matrix_element(sp, sp, [&h_matrix](int i, int j, scalar_t x) { h_matrix(j, i) += x; });
+
+        auto eig                                = linalg::eigenelements(h_matrix);
+        hdiag->eigensystems[spn].eigenvalues    = eig.first;
+        hdiag->eigensystems[spn].unitary_matrix = eig.second;
+      });
+
+      // Truncation of the spectrum : every rank works on the subspaces it has diagonalized above, with the ground state energy of all of them
+      if (truncated) {
+        double gs_energy = std::numeric_limits<double>::infinity();
+        for (long t = rank; t < subspace_order.size(); t += n_ranks) gs_energy = std::min(gs_energy, hdiag->eigensystems[subspace_order[t]].eigenvalues(0));
+        if (distribute) gs_energy = mpi::all_reduce(gs_energy, c, MPI_MIN);
+        double e_max = gs_energy + truncation.energy_window;
+
+        run_tasks(subspace_order.size(), n_ranks, rank, [&](long t) {
+          int spn          = subspace_order[t];
+          auto &eigensystem = hdiag->eigensystems[spn];
+          if (is_sparse(spn)) {
+            auto pairs = details::lowest_eigenpairs(*sparse_h[spn], e_max, truncation.n_lowest, std::move(sparse_eigenpairs[spn]), spn);
+            sparse_h[spn].reset();
+            std::tie(eigensystem.eigenvalues, eigensystem.unitary_matrix) =
+               details::truncate(pairs, hdiag->sub_hilbert_spaces[spn].size(), e_max, truncation.n_lowest);
+          } else {
+            auto const &e = eigensystem.eigenvalues;
+            double cut    = details::energy_cut(std::vector<double>(e.begin(), e.end()), e_max, truncation.n_lowest);
+            long n_kept   = 0;
+            while (n_kept < e.size() and e(n_kept) <= cut + details::degeneracy_tolerance(cut)) ++n_kept;
+            eigensystem.eigenvalues    = vector<double>(eigensystem.eigenvalues(range(n_kept)));
+            eigensystem.unitary_matrix = matrix_t(eigensystem.unitary_matrix(range::all, range(n_kept)));
+          }
+        });
+      }
+      if (distribute)
+        for (long t = 0; t < subspace_order.size(); ++t) mpi_broadcast(hdiag->eigensystems[subspace_order[t]], c, owner(t));
 
-        eign_map.insert({{eigensystem.eigenvalues(0) + energy_split * spn, spn}, eigensystem});
+      // Sort the eigensystems by energy. The subspaces left empty by the truncation are discarded.
+      std::map<std::pair<double, int>, int> eign_map;
+      double energy_split = 1.e-10; // to split the eigenvalues, which are numerically very close
+      for (int spn = 0; spn < n_subspaces; ++spn) {
+        auto const &eigensystem = hdiag->eigensystems[spn];
+        if (eigensystem.eigenvalues.size() == 0) continue;
+        hdiag->gs_energy = std::min(hdiag->gs_energy, eigensystem.eigenvalues[0]);
+        eign_map.insert({{eigensystem.eigenvalues(0) + energy_split * spn, spn}, spn});
       }
 
       // Reorder the block along their minimal energy
       {
-        auto tmp = hdiag->sub_hilbert_spaces;
+        auto tmp      = std::vector<sub_hilbert_space>(eign_map.size());
+        auto eigs_tmp = std::exchange(hdiag->eigensystems, std::vector<typename atom_diag<Complex>::eigensystem_t>(eign_map.size()));
         std::map<int, int> remap;
         int i = 0;
         for (auto const &x : eign_map) { // in order of min energy !
-          hdiag->eigensystems[i] = x.second;
-          tmp[i]                 = hdiag->sub_hilbert_spaces[x.first.second];
+          hdiag->eigensystems[i] = std::move(eigs_tmp[x.second]);
+          tmp[i]                 = hdiag->sub_hilbert_spaces[x.second];
           tmp[i].set_index(i);
-          remap[x.first.second] = i;
+          remap[x.second] = i;
           ++i;
         }
         std::swap(tmp, hdiag->sub_hilbert_spaces);
+        auto new_index        = [&remap](long j) -> long { auto it = remap.find(j); return (it == remap.end() ? -1 : it->second); };
         auto remap_connection = [&](matrix<long> &connection) {
           auto c2 = connection;
-          for (int n = 0; n < first_dim(connection); ++n)
-            for (int j = 0; j < second_dim(connection); ++j) connection(n, remap[j]) = (c2(n, j) == -1 ? -1 : remap[c2(n, j)]);
+          connection.resize(first_dim(c2), remap.size());
+          for (int n = 0; n < first_dim(c2); ++n)
+            for (int j = 0; j < second_dim(c2); ++j)
+              if (new_index(j) != -1) connection(n, new_index(j)) = (c2(n, j) == -1 ? -1 : new_index(c2(n, j)));
         };
         remap_connection(hdiag->creation_connection);
         remap_connection(hdiag->annihilation_connection);
+
+        // Drop the quantum numbers of the discarded subspaces
+        auto &qn = hdiag->quantum_numbers;
+        if (not qn.empty() and remap.size() < qn.size()) {
+          std::vector<std::vector<quantum_number_t>> qn_kept;
+          for (int j = 0; j < qn.size(); ++j)
+            if (remap.count(j)) qn_kept.push_back(std::move(qn[j]));
+          qn = std::move(qn_kept);
+        }
       } // end reordering
+      n_subspaces = hdiag->sub_hilbert_spaces.size();
 
       // Shift the ground state energy of the local Hamiltonian to zero.
       for (auto &eigensystem : hdiag->eigensystems) eigensystem.eigenvalues() -= hdiag->get_gs_energy();
 
+      // Compute the matrices of c, c dagger in the diagonalization base of H_loc : one task per operator and connected subspace.
+      // n = x.linear_index is guaranteed to be 0, 1, 2, 3, ... by the fundamental_operator_set class
+      struct c_mat_task {
+        int n, B, Bp;
+        bool dagger;
+      };
+      std::vector<c_mat_task> tasks;
+      std::vector<many_body_op_t> c_ops(fops.size()), cdag_ops(fops.size());
       for (auto const &x : fops) {
-        // get the operators and their index
-        int n = x.linear_index;
-        // n is guaranteed to be 0, 1, 2, 3, ... by the fundamental_operator_set class ... but it is very weird...
-        // otherwise the push_back below is false.
-        auto create  = many_body_op_t::make_canonical(true, x.index);
-        auto destroy = many_body_op_t::make_canonical(false, x.index);
-
-        // Compute the matrices of c, c dagger in the diagonalization base of H_loc
-        // first a lambda, since it is almost the same code for c and cdag
-        auto make_c_mat = [&](int m, matrix<long> const &connection, many_body_op_t const &op) {
-          std::vector<matrix_t> cmat(second_dim(connection));
-          for (int B = 0; B < second_dim(connection); ++B) {
-            auto Bp = connection(m, B);
-            if (Bp == -1) continue;
-            cmat[B] = make_op_matrix(op, B, Bp);
-          }
-          return cmat;
-        };
-
-        // now execute code...
-        hdiag->c_matrices.push_back(make_c_mat(n, hdiag->annihilation_connection, destroy));
-        hdiag->cdag_matrices.push_back(make_c_mat(n, hdiag->creation_connection, create));
+        int n       = x.linear_index;
+        c_ops[n]    = many_body_op_t::make_canonical(false, x.index);
+        cdag_ops[n] = many_body_op_t::make_canonical(true, x.index);
+        for (int B = 0; B < n_subspaces; ++B) {
+          if (auto Bp = hdiag->annihilation_connection(n, B); Bp != -1) tasks.push_back({n, B, int(Bp), false});
+          if (auto Bp = hdiag->creation_connection(n, B); Bp != -1) tasks.push_back({n, B, int(Bp), true});
+        }
+      }
 
-      } // end of loop on operators
+      // the cost of the construction is dominated by the products with the unitary matrices
+      std::vector<double> task_cost(tasks.size());
+      for (long t = 0; t < tasks.size(); ++t) {
+        double d1 = hdiag->get_subspace_dim(tasks[t].B), d2 = hdiag->get_subspace_dim(tasks[t].Bp);
+        task_cost[t] = d1 * d2 * (d1 + d2);
+      }
+      auto task_order = largest_first(task_cost);
+
+      hdiag->c_matrices.assign(fops.size(), std::vector<matrix_t>(n_subspaces));
+      hdiag->cdag_matrices.assign(fops.size(), std::vector<matrix_t>(n_subspaces));
+      auto c_matrix = [&](c_mat_task const &ta) -> matrix_t & { return (ta.dagger ? hdiag->cdag_matrices : hdiag->c_matrices)[ta.n][ta.B]; };
+
+      run_tasks(task_order.size(), n_ranks, rank, [&](long t) {
+        auto const &ta = tasks[task_order[t]];
+        c_matrix(ta)   = make_op_matrix(ta.dagger ? cdag_ops[ta.n] : c_ops[ta.n], ta.B, ta.Bp);
+      });
+      if (distribute)
+        for (long t = 0; t < task_order.size(); ++t) mpi::broadcast(c_matrix(tasks[task_order[t]]), c, owner(t));
     }
 
     // -----------------------------------------------------------------
@@ -37,7 +37,8 @@ namespace triqs {
       using matrix_t       = typename atom_diag<Complex>::matrix_t;
       using many_body_op_t = typename atom_diag<Complex>::many_body_op_t;
 
-      atom_diag_worker(atom_diag<Complex> *hdiag, int n_min = 0, int n_max = INT_MAX) : hdiag(hdiag), n_min(n_min), n_max(n_max) {}
+      atom_diag_worker(atom_diag<Complex> *hdiag, int n_min = 0, int n_max = INT_MAX, atom_diag_truncation truncation = {})
+         : hdiag(hdiag), n_min(n_min), n_max(n_max), truncation(truncation) {}
 
       //void autopartition();
       void autopartition(many_body_op_t const &hyb = many_body_op_t());
@@ -46,6 +47,7 @@ namespace triqs {
       private:
       atom_diag<Complex> *hdiag;
       int n_min, n_max;
+      atom_diag_truncation truncation;
 
       // Create matrix of an operator acting from one subspace to another
       matrix_t make_op_matrix(many_body_op_t const &op, int from_sp, int to_sp) const;
@@ -24,6 +24,7 @@
 #include <vector>
 #include <iterator>
 #include <numeric>
+#include <algorithm>
 #include <cmath>
 #include <triqs/arrays.hpp>
 #include <triqs/utility/function_arg_ret_type.hpp>
@@ -32,18 +33,186 @@
 namespace triqs {
   namespace det_manip {
 
-    namespace blas = nda::blas;
+    // Thin layer over nda::blas.
+    // Dispatch to nda::blas when all arrays have the same double or complex<double> value type,
+    // and to the single precision BLAS routines (s/c) when they all have the float or complex<float> value type.
+    // Otherwise (e.g. a product of a single precision panel with a double precision ksi matrix), use plain loops accumulating in double precision.
+    namespace blas {
+
+      template <typename T> constexpr bool is_blas_type = std::is_same_v<T, double> or std::is_same_v<T, std::complex<double>>;
+
+      template <typename T> constexpr bool is_single_blas_type = std::is_same_v<T, float> or std::is_same_v<T, std::complex<float>>;
+
+      template <typename A0, typename... A>
+      constexpr bool use_nda_blas = is_blas_type<nda::get_value_t<A0>> and (std::is_same_v<nda::get_value_t<A0>, nda::get_value_t<A>> and ...);
+
+      template <typename A0, typename... A>
+      constexpr bool use_single_blas =
+         is_single_blas_type<nda::get_value_t<A0>> and (std::is_same_v<nda::get_value_t<A0>, nda::get_value_t<A>> and ...);
+
+      // Accumulation type
+      template <typename T> using acc_t = std::conditional_t<nda::is_complex_v<T>, std::complex<double>, double>;
+
+      // The single precision routines of the BLAS library linked by nda (which only wraps the double precision ones)
+      // NB : they accumulate in single precision, i.e. the rounding error of a product of length N is up to ~ N * 6e-8
+      // (~ sqrt(N) * 6e-8 typically), while the loops below accumulate in double. This is the precision of the inverse
+      // stored in single precision anyway, which is monitored by the periodic checks against a double precision inverse.
+      namespace f77 {
+        using cfloat = std::complex<float>;
+        extern "C" {
+        void sgemv_(char const *, int const *, int const *, float const *, float const *, int const *, float const *, int const *, float const *,
+                    float *, int const *);
+        void cgemv_(char const *, int const *, int const *, cfloat const *, cfloat const *, int const *, cfloat const *, int const *, cfloat const *,
+                    cfloat *, int const *);
+        void sger_(int const *, int const *, float const *, float const *, int const *, float const *, int const *, float *, int const *);
+        void cgeru_(int const *, int const *, cfloat const *, cfloat const *, int const *, cfloat const *, int const *, cfloat *, int const *);
+        void sgemm_(char const *, char const *, int const *, int const *, int const *, float const *, float const *, int const *, float const *,
+                    int const *, float const *, float *, int const *);
+        void cgemm_(char const *, char const *, int const *, int const *, int const *, cfloat const *, cfloat const *, int const *, cfloat const *,
+                    int const *, cfloat const *, cfloat *, int const *);
+        }
+
+        inline void gemv(char t, int m, int n, float alpha, float const *a, int lda, float const *x, int incx, float beta, float *y, int incy) {
+          sgemv_(&t, &m, &n, &alpha, a, &lda, x, &incx, &beta, y, &incy);
+        }
+        inline void gemv(char t, int m, int n, cfloat alpha, cfloat const *a, int lda, cfloat const *x, int incx, cfloat beta, cfloat *y, int incy) {
+          cgemv_(&t, &m, &n, &alpha, a, &lda, x, &incx, &beta, y, &incy);
+        }
+        inline void ger(int m, int n, float alpha, float const *x, int incx, float const *y, int incy, float *a, int lda) {
+          sger_(&m, &n, &alpha, x, &incx, y, &incy, a, &lda);
+        }
+        inline void ger(int m, int n, cfloat alpha, cfloat const *x, int incx, cfloat const *y, int incy, cfloat *a, int lda) {
+          cgeru_(&m, &n, &alpha, x, &incx, y, &incy, a, &lda);
+        }
+        inline void gemm(char ta, char tb, int m, int n, int k, float alpha, float const *a, int lda, float const *b, int ldb, float beta, float *c,
+                         int ldc) {
+          sgemm_(&ta, &tb, &m, &n, &k, &alpha, a, &lda, b, &ldb, &beta, c, &ldc);
+        }
+        inline void gemm(char ta, char tb, int m, int n, int k, cfloat alpha, cfloat const *a, int lda, cfloat const *b, int ldb, cfloat beta,
+                         cfloat *c, int ldc) {
+          cgemm_(&ta, &tb, &m, &n, &k, &alpha, a, &lda, b, &ldb, &beta, c, &ldc);
+        }
+      } // namespace f77
+
+      // A matrix m as a BLAS operand op(X), with X in Fortran order : X = m ('N') or X = transpose(m) ('T') for m in C order.
+      // Returns false if m has no unit stride.
+      struct blas_operand {
+        char trans;
+        int ld;
+      };
+      template <typename M> bool as_blas_operand(M const &m, blas_operand &op) {
+        auto [s0, s1] = m.indexmap().strides();
+        long n0 = m.extent(0), n1 = m.extent(1);
+        if (s1 == 1 or n1 == 1) {
+          op = {'T', int(std::max({long(s0), n1, 1l}))};
+          return true;
+        }
+        if (s0 == 1 or n0 == 1) {
+          op = {'N', int(std::max({long(s1), n0, 1l}))};
+          return true;
+        }
+        return false;
+      }
+      inline char flip(char t) { return (t == 'N' ? 'T' : 'N'); }
+      template <typename X> int inc(X const &x) { return std::max(1, int(x.indexmap().strides()[0])); }
+
+      template <typename X, typename Y> auto dot(X const &x, Y const &y) {
+        if constexpr (use_nda_blas<X, Y>) {
+          return nda::blas::dot(x, y);
+        } else {
+          using T = acc_t<nda::get_value_t<X>>;
+          T r     = 0;
+          for (long i = 0; i < x.size(); ++i) r += T(x(i)) * T(y(i));
+          return r;
+        }
+      }
+
+      template <typename A, typename X, typename Y> void gemv(auto alpha, A const &a, X const &x, auto beta, Y &&y) {
+        if constexpr (use_nda_blas<A, X, std::decay_t<Y>>) {
+          nda::blas::gemv(alpha, a, x, beta, std::forward<Y>(y));
+        } else {
+          using S = nda::get_value_t<std::decay_t<Y>>;
+          if constexpr (use_single_blas<A, X, std::decay_t<Y>>) {
+            blas_operand op;
+            if (a.size() > 0 and as_blas_operand(a, op)) {
+              long m = (op.trans == 'N' ? a.extent(0) : a.extent(1)), n = (op.trans == 'N' ? a.extent(1) : a.extent(0));
+              f77::gemv(op.trans, m, n, S(alpha), a.data(), op.ld, x.data(), inc(x), S(beta), y.data(), inc(y));
+              return;
+            }
+          }
+          using T = acc_t<S>;
+          for (long i = 0; i < a.extent(0); ++i) {
+            T r = 0;
+            for (long j = 0; j < a.extent(1); ++j) r += T(a(i, j)) * T(x(j));
+            y(i) = static_cast<S>(beta == 0.0 ? T(alpha) * r : T(alpha) * r + T(beta) * T(y(i)));
+          }
+        }
+      }
+
+      template <typename X, typename Y, typename M> void ger(auto alpha, X const &x, Y const &y, M &&m) {
+        if constexpr (use_nda_blas<X, Y, std::decay_t<M>>) {
+          nda::blas::ger(alpha, x, y, std::forward<M>(m));
+        } else {
+          using S = nda::get_value_t<std::decay_t<M>>;
+          if constexpr (use_single_blas<X, Y, std::decay_t<M>>) {
+            blas_operand op;
+            if (m.size() > 0 and as_blas_operand(m, op)) {
+              if (op.trans == 'N') // m += alpha x y^T
+                f77::ger(m.extent(0), m.extent(1), S(alpha), x.data(), inc(x), y.data(), inc(y), m.data(), op.ld);
+              else // transpose(m) += alpha y x^T, in Fortran order
+                f77::ger(m.extent(1), m.extent(0), S(alpha), y.data(), inc(y), x.data(), inc(x), m.data(), op.ld);
+              return;
+            }
+          }
+          using T = acc_t<S>;
+          for (long i = 0; i < m.extent(0); ++i) {
+            T ax = T(alpha) * T(x(i));
+            for (long j = 0; j < m.extent(1); ++j) m(i, j) += static_cast<S>(ax * T(y(j)));
+          }
+        }
+      }
+
+      template <typename A, typename B, typename C> void gemm(auto alpha, A const &a, B const &b, auto beta, C &&c) {
+        if constexpr (use_nda_blas<A, B, std::decay_t<C>>) {
+          nda::blas::gemm(alpha, a, b, beta, std::forward<C>(c));
+        } else {
+          using S = nda::get_value_t<std::decay_t<C>>;
+          if constexpr (use_single_blas<A, B, std::decay_t<C>>) {
+            blas_operand opa, opb, opc;
+            if (a.size() > 0 and c.size() > 0 and as_blas_operand(a, opa) and as_blas_operand(b, opb) and as_blas_operand(c, opc)) {
+              if (opc.trans == 'N') // c = alpha op(A) op(B) + beta c
+                f77::gemm(opa.trans, opb.trans, c.extent(0), c.extent(1), a.extent(1), S(alpha), a.data(), opa.ld, b.data(), opb.ld, S(beta),
+                          c.data(), opc.ld);
+              else // transpose(c) = alpha transpose(b) transpose(a) + beta transpose(c), in Fortran order
+                f77::gemm(flip(opb.trans), flip(opa.trans), c.extent(1), c.extent(0), a.extent(1), S(alpha), b.data(), opb.ld, a.data(), opa.ld,
+                          S(beta), c.data(), opc.ld);
+              return;
+            }
+          }
+          using T = acc_t<S>;
+          for (long i = 0; i < c.extent(0); ++i)
+            for (long j = 0; j < c.extent(1); ++j) c(i, j) = (beta == 0.0 ? S(0) : static_cast<S>(T(beta) * T(c(i, j))));
+          for (long i = 0; i < c.extent(0); ++i)
+            for (long l = 0; l < a.extent(1); ++l) {
+              T ail = T(alpha) * T(a(i, l));
+              for (long j = 0; j < c.extent(1); ++j) c(i, j) += static_cast<S>(ail * T(b(l, j)));
+            }
+        }
+      }
+
+    } // namespace blas
 
     // ================ Work Data Types =====================
 
     // For single-row/column operations
-    template <typename x_type, typename y_type, typename value_type> struct work_data_type1 {
+    // The vectors are stored with the value type of the inverse matrix (storage_type), the ratio in value_type
+    template <typename x_type, typename y_type, typename value_type, typename storage_type = value_type> struct work_data_type1 {
       x_type x;
       y_type y;
       long i, j, ireal, jreal;
       // MB = A^(-1)*B,
       // MC = C*A^(-1)
-      nda::vector<value_type> MB, MC, B, C;
+      nda::vector<storage_type> MB, MC, B, C;
       // ksi = newdet/det
       value_type ksi;
       void resize(long N) {
@@ -55,13 +224,21 @@ namespace triqs {
     };
 
     // For multiple-row/column operations
-    template <typename x_type, typename y_type, typename value_type> struct work_data_typek {
+    template <typename x_type, typename y_type, typename value_type, typename storage_type = value_type> struct work_data_typek {
       std::vector<x_type> x;
       std::vector<y_type> y;
       std::vector<long> i, j, ireal, jreal;
       // MB = A^(-1)*B,
       // MC = C*A^(-1)
-      nda::matrix<value_type> MB, MC, B, C, ksi;
+      nda::matrix<storage_type> MB, MC, B, C;
+      nda::matrix<value_type> ksi;
+      // ksi, or a product added to it, in the storage type, for the BLAS of the storage type (mixed precision only)
+      nda::matrix<storage_type> ksi_s;
+      // For a number K <= k_fixed_max of rows/columns known at compile time (try_insert_k<K>, try_remove_k<K>),
+      // the K x K block ksi is kept in C order in ksi_fixed instead of the heap matrix ksi, between the try and the completion.
+      static constexpr long k_fixed_max = 4;
+      long fixed_k                      = 0; // K of the pending operation, 0 for the runtime k operations
+      std::array<value_type, k_fixed_max * k_fixed_max> ksi_fixed;
       void resize(long N, long k) {
         if (k < 2) return;
         x.resize(k);
@@ -75,6 +252,7 @@ namespace triqs {
         B.resize(N, k);
         C.resize(k, N);
         ksi.resize(k, k);
+        if constexpr (not std::is_same_v<value_type, storage_type>) ksi_s.resize(k, k);
       }
       value_type det_ksi(long k) const {
         if (k == 2) {
@@ -92,8 +270,123 @@ namespace triqs {
           return nda::determinant(ksi(Rk, Rk));
         };
       }
+      // ksi <- ksi^(-1), hand-unrolled for k = 2, 3 (no allocation, no lapack call)
+      void invert_ksi(long k) {
+        if (k == 2) {
+          value_type d = det_ksi(2);
+          value_type a = ksi(0, 0);
+          ksi(0, 0)    = ksi(1, 1) / d;
+          ksi(1, 1)    = a / d;
+          ksi(0, 1)    = -ksi(0, 1) / d;
+          ksi(1, 0)    = -ksi(1, 0) / d;
+        } else if (k == 3) {
+          value_type d = det_ksi(3);
+          value_type a = ksi(0, 0), b = ksi(0, 1), c = ksi(0, 2);
+          value_type e = ksi(1, 0), f = ksi(1, 1), g = ksi(1, 2);
+          value_type h = ksi(2, 0), l = ksi(2, 1), m = ksi(2, 2);
+          ksi(0, 0)    = (f * m - g * l) / d;
+          ksi(0, 1)    = (c * l - b * m) / d;
+          ksi(0, 2)    = (b * g - c * f) / d;
+          ksi(1, 0)    = (g * h - e * m) / d;
+          ksi(1, 1)    = (a * m - c * h) / d;
+          ksi(1, 2)    = (c * e - a * g) / d;
+          ksi(2, 0)    = (e * l - f * h) / d;
+          ksi(2, 1)    = (b * h - a * l) / d;
+          ksi(2, 2)    = (a * f - b * e) / d;
+        } else {
+          auto Rk      = range(k);
+          ksi(Rk, Rk) = inverse(ksi(Rk, Rk));
+        }
+      }
     };
 
+    namespace details {
+      // Stable argsort of a small fixed size array, without allocation (insertion sort)
+      template <typename T, size_t K> std::array<long, K> small_argsort(std::array<T, K> const &vec) {
+        std::array<long, K> idx;
+        for (long l = 0; l < long(K); ++l) {
+          long p = l;
+          while (p > 0 and vec[l] < vec[idx[p - 1]]) {
+            idx[p] = idx[p - 1];
+            --p;
+          }
+          idx[p] = l;
+        }
+        return idx;
+      }
+
+      // Determinant of a K x K matrix stored in C order, hand-unrolled for K = 2, 3, by LU with partial pivoting otherwise
+      template <long K, typename T> T small_det(std::array<T, K * K> a) {
+        if constexpr (K == 1) {
+          return a[0];
+        } else if constexpr (K == 2) {
+          return a[0] * a[3] - a[1] * a[2];
+        } else if constexpr (K == 3) {
+          return a[0] * (a[4] * a[8] - a[5] * a[7]) - a[1] * (a[3] * a[8] - a[5] * a[6]) + a[2] * (a[3] * a[7] - a[4] * a[6]);
+        } else {
+          T d = 1;
+          for (long c = 0; c < K; ++c) {
+            long p = c;
+            for (long r = c + 1; r < K; ++r)
+              if (std::abs(a[r * K + c]) > std::abs(a[p * K + c])) p = r;
+            if (a[p * K + c] == T(0)) return T(0);
+            if (p != c) {
+              for (long l = c; l < K; ++l) std::swap(a[c * K + l], a[p * K + l]);
+              d = -d;
+            }
+            d *= a[c * K + c];
+            for (long r = c + 1; r < K; ++r) {
+              T x = a[r * K + c] / a[c * K + c];
+              for (long l = c + 1; l < K; ++l) a[r * K + l] -= x * a[c * K + l];
+            }
+          }
+          return d;
+        }
+      }
+
+      // a <- a^(-1) for a K x K matrix stored in C order. Hand-unrolled for K = 2, 3, Gauss-Jordan with partial pivoting otherwise
+      template <long K, typename T> void small_inverse(std::array<T, K * K> &a) {
+        if constexpr (K == 1) {
+          a[0] = T(1) / a[0];
+        } else if constexpr (K == 2) {
+          T d = small_det<2>(a);
+          a   = {a[3] / d, -a[1] / d, -a[2] / d, a[0] / d};
+        } else if constexpr (K == 3) {
+          T d = small_det<3>(a);
+          a   = {(a[4] * a[8] - a[5] * a[7]) / d, (a[2] * a[7] - a[1] * a[8]) / d, (a[1] * a[5] - a[2] * a[4]) / d,
+                 (a[5] * a[6] - a[3] * a[8]) / d, (a[0] * a[8] - a[2] * a[6]) / d, (a[2] * a[3] - a[0] * a[5]) / d,
+                 (a[3] * a[7] - a[4] * a[6]) / d, (a[1] * a[6] - a[0] * a[7]) / d, (a[0] * a[4] - a[1] * a[3]) / d};
+        } else {
+          std::array<T, K * K> b{};
+          for (long l = 0; l < K; ++l) b[l * K + l] = 1;
+          for (long c = 0; c < K; ++c) {
+            long p = c;
+            for (long r = c + 1; r < K; ++r)
+              if (std::abs(a[r * K + c]) > std::abs(a[p * K + c])) p = r;
+            if (p != c)
+              for (long l = 0; l < K; ++l) {
+                std::swap(a[c * K + l], a[p * K + l]);
+                std::swap(b[c * K + l], b[p * K + l]);
+              }
+            T x = T(1) / a[c * K + c];
+            for (long l = 0; l < K; ++l) {
+              a[c * K + l] *= x;
+              b[c * K + l] *= x;
+            }
+            for (long r = 0; r < K; ++r) {
+              if (r == c) continue;
+              T y = a[r * K + c];
+              for (long l = 0; l < K; ++l) {
+                a[r * K + l] -= y * a[c * K + l];
+                b[r * K + l] -= y * b[c * K + l];
+              }
+            }
+          }
+          a = b;
+        }
+      }
+    } // namespace details
+
     // For refill operations
     template <typename x_type, typename y_type, typename value_type> struct work_data_type_refill {
       std::vector<x_type> x_values;
@@ -106,12 +399,71 @@ namespace triqs {
       }
     };
 
+    // For batches of single-row/column operations
+    template <typename x_type, typename y_type, typename value_type, typename storage_type = value_type> struct work_data_type_batch {
+      std::vector<x_type> x;
+      std::vector<y_type> y;
+      std::vector<long> i, j;
+      // MB = A^(-1)*B, one column per candidate
+      nda::matrix<storage_type> MB, B, C;
+      std::vector<value_type> ksi;
+      void resize(long N, long M) {
+        if (MB.extent(0) >= N and MB.extent(1) >= M) return;
+        N = std::max(N, MB.extent(0));
+        M = std::max(M, MB.extent(1));
+        MB.resize(N, M);
+        B.resize(N, M);
+        C.resize(M, N);
+      }
+    };
+
+    // For delayed updates
+    // The true inverse is mat_inv + U * V, where only the first m columns of U (rows of V) are used.
+    template <typename value_type> struct work_data_type_delayed {
+      long kmax = 0; // maximal number of delayed columns before a flush. 0 : delayed updates are disabled
+      long m    = 0; // number of pending columns
+      nda::matrix<value_type> U, V;
+      nda::vector<value_type> t;
+      nda::matrix<value_type> T; // scratch for the products of V (resp. U) with the k columns (resp. rows) of the rank-k and batch operations
+      void resize(long N, long k) {
+        U.resize(N, k);
+        V.resize(k, N);
+        t.resize(k);
+      }
+      // m x k view of the scratch, grown if needed
+      auto scratch(long k) {
+        if (T.extent(0) < U.extent(1) or T.extent(1) < k) T.resize(std::max(T.extent(0), U.extent(1)), std::max(T.extent(1), k));
+        return T(range(m), range(k));
+      }
+      // M(RN,RN) += U(RN,Rm) * V(Rm,RN)
+      template <typename M> void apply_to(M &&mat, long N) const {
+        if (m == 0) return;
+        range RN(N), Rm(m);
+        blas::gemm(1.0, U(RN, Rm), V(Rm, RN), 1.0, mat(RN, RN));
+      }
+      // Correction to the (i,j) element of the inverse
+      value_type correction(long i, long j) const {
+        if (m == 0) return 0;
+        range Rm(m);
+        return blas::dot(U(i, Rm), V(Rm, j));
+      }
+    };
+
     // ================ det_manip implementation =====================
 
     /**
      * @brief Standard matrix/det manipulations used in several QMC.
+     *
+     * @tparam FunctionType The function f(x,y) giving the matrix elements.
+     * @tparam InvValueType The value type used to store the inverse matrix and the work vectors.
+     *                      It can be float (resp. complex<float>) for a function returning double (resp. complex<double>),
+     *                      to halve the memory traffic for large matrices. The products with the inverse and its updates then use
+     *                      the single precision BLAS routines, the det ratios are still accumulated in double,
+     *                      and the inverse is periodically recomputed in double precision (cf set_n_operations_before_check).
+     *                      The check period shortens when the deviation exceeds the warning threshold, down to
+     *                      n_opts_min_before_check, where the warnings are reported (cf get_n_operations_before_check).
      */
-    template <typename FunctionType> class det_manip {
+    template <typename FunctionType, typename InvValueType = typename utility::function_arg_ret_type<FunctionType>::result_type> class det_manip {
       private:
       using f_tr = utility::function_arg_ret_type<FunctionType>;
       static_assert(f_tr::arity == 2, "det_manip : the function must take two arguments !");
@@ -126,6 +478,17 @@ namespace triqs {
 
       using matrix_type = nda::matrix<value_type>;
 
+      using inv_value_type  = InvValueType;
+      using inv_matrix_type = nda::matrix<inv_value_type>;
+      static_assert((std::is_floating_point_v<inv_value_type> || nda::is_complex_v<inv_value_type>)
+                       and std::is_same_v<blas::acc_t<inv_value_type>, blas::acc_t<value_type>>,
+                    "det_manip : the inverse must be stored as a floating number (resp. complex number) if the function returns a floating (resp. complex) number");
+      static constexpr bool is_mixed_precision = not std::is_same_v<value_type, inv_value_type>;
+
+      // In mixed precision, the smallest period the check can be shortened to after warnings.
+      // A warning at this period means the single precision storage is not accurate enough for the matrix : it is reported.
+      static constexpr uint64_t n_opts_min_before_check = 10;
+
       protected: // the data
       FunctionType f;
 
@@ -141,24 +504,34 @@ namespace triqs {
         ChangeRowCol,
         InsertK,
         RemoveK,
-        Refill
+        Refill,
+        InsertBatch,
+        RemoveBatch
       } last_try = NoTry; // keep in memory the last operation not completed
       std::vector<long> row_num, col_num;
       std::vector<x_type> x_values;
       std::vector<y_type> y_values;
       int sign = 1;
-      matrix_type mat_inv;
+      // mutable : flushing the pending delayed updates into mat_inv does not change the inverse, cf flush_delayed_updates
+      mutable inv_matrix_type mat_inv;
       uint64_t n_opts                  = 0;   // count the number of operation
       uint64_t n_opts_max_before_check = 100; // max number of ops before the test of deviation of the det, M^-1 is performed.
+      uint64_t n_opts_check_period     = 100; // period set by the user. In mixed precision, n_opts_max_before_check adapts below it.
       double singular_threshold = -1; // the test to see if the matrix is singular is abs(det) > singular_threshold. If <0, it is !isnormal(abs(det))
-      double precision_warning  = 1.e-8; // bound for warning message in check for singular matrix
-      double precision_error    = 1.e-5; // bound for throwing error in check for singular matrix
+      double precision_warning  = (is_mixed_precision ? 1.e-5 : 1.e-8); // bound for warning message in check for singular matrix
+      double precision_error    = (is_mixed_precision ? 1.e-2 : 1.e-5); // bound for throwing error in check for singular matrix
 
       /// Write into HDF5
       friend void h5_write(h5::group fg, std::string subgroup_name, det_manip const &g) {
         auto gr = fg.create_group(subgroup_name);
         h5_write(gr, "N", g.N);
-        h5_write(gr, "mat_inv", g.mat_inv);
+        if (g.wdl.m == 0)
+          h5_write(gr, "mat_inv", g.mat_inv);
+        else { // write the inverse including the pending delayed updates
+          inv_matrix_type m = g.mat_inv;
+          g.wdl.apply_to(m, g.N);
+          h5_write(gr, "mat_inv", m);
+        }
         h5_write(gr, "det", g.det);
         h5_write(gr, "sign", g.sign);
         h5_write(gr, "row_num", g.row_num);
@@ -167,6 +540,7 @@ namespace triqs {
         h5_write(gr, "y_values", g.y_values);
         h5_write(gr, "n_opts", g.n_opts);
         h5_write(gr, "n_opts_max_before_check", g.n_opts_max_before_check);
+        h5_write(gr, "n_opts_check_period", g.n_opts_check_period);
         h5_write(gr, "singular_threshold", g.singular_threshold);
       }
 
@@ -177,6 +551,8 @@ namespace triqs {
         h5_read(gr, "mat_inv", g.mat_inv);
         g.Nmax     = first_dim(g.mat_inv); // restore Nmax
         g.last_try = NoTry;
+        g.wdl.m    = 0;
+        if (g.wdl.kmax > 0) g.wdl.resize(g.Nmax, g.wdl.kmax);
         h5_read(gr, "det", g.det);
         h5_read(gr, "sign", g.sign);
         h5_read(gr, "row_num", g.row_num);
@@ -185,13 +561,17 @@ namespace triqs {
         h5_read(gr, "y_values", g.y_values);
         h5_read(gr, "n_opts", g.n_opts);
         h5_read(gr, "n_opts_max_before_check", g.n_opts_max_before_check);
+        if (not h5::try_read(gr, "n_opts_check_period", g.n_opts_check_period)) g.n_opts_check_period = g.n_opts_max_before_check; // Backward Compat
         h5_read(gr, "singular_threshold", g.singular_threshold);
       }
 
       private:
-      work_data_type1<x_type, y_type, value_type> w1;
-      work_data_typek<x_type, y_type, value_type> wk;
+      work_data_type1<x_type, y_type, value_type, inv_value_type> w1;
+      using work_data_typek_t = work_data_typek<x_type, y_type, value_type, inv_value_type>;
+      work_data_typek_t wk;
       work_data_type_refill<x_type, y_type, value_type> w_refill;
+      work_data_type_batch<x_type, y_type, value_type, inv_value_type> wb;
+      mutable work_data_type_delayed<inv_value_type> wdl; // mutable, cf mat_inv
       det_type newdet;
       int newsign;
 
@@ -211,8 +591,11 @@ namespace triqs {
         SW(mat_inv);
         SW(n_opts);
         SW(n_opts_max_before_check);
+        SW(n_opts_check_period);
         SW(w1);
         SW(wk);
+        SW(wb);
+        SW(wdl);
         SW(newdet);
         SW(newsign);
 #undef SW
@@ -240,7 +623,11 @@ namespace triqs {
         if (new_N > Nmax) {
           Nmax = 2 * new_N;
 
-          matrix_type mcpy(mat_inv);
+          // the delayed updates are flushed before the reallocation
+          flush_delayed_updates();
+          if (wdl.kmax > 0) wdl.resize(Nmax, wdl.kmax);
+
+          inv_matrix_type mcpy(mat_inv);
           mat_inv.resize(Nmax, Nmax);
           auto Rcpy           = range(mcpy.extent(0));
           mat_inv(Rcpy, Rcpy) = mcpy;
@@ -261,11 +648,16 @@ namespace triqs {
       /// Sets the number below which abs(det) is considered 0. Cf get_is_singular_threshold
       void set_singular_threshold(double threshold) { singular_threshold = threshold; }
 
-      /// Gets the number of operations done before a check in the dets.
+      /**
+       * Gets the number of operations done before a check in the dets.
+       *
+       * In mixed precision, this is the current period : it is halved after each check above the warning threshold,
+       * down to min(n_opts_min_before_check, n), and doubled back after each clean check, up to the period n set by the user.
+       */
       double get_n_operations_before_check() const { return n_opts_max_before_check; }
 
       /// Sets the number of operations done before a check in the dets.
-      void set_n_operations_before_check(uint64_t n) { n_opts_max_before_check = n; }
+      void set_n_operations_before_check(uint64_t n) { n_opts_max_before_check = n_opts_check_period = n; }
 
       /// Get the bound for warning messages in the singular tests
       double get_precision_warning() const { return precision_warning; }
@@ -279,6 +671,38 @@ namespace triqs {
       /// Set the bound for throwing error in the singular tests
       void set_precision_error(double threshold) { precision_error = threshold; }
 
+      /// Get the maximal number of delayed updates (0 if the delayed updates are disabled)
+      long get_n_delayed_updates() const { return wdl.kmax; }
+
+      /**
+       * Enable the delayed updates of the inverse matrix.
+       *
+       * The completed operations are not applied immediately to the inverse matrix M^{-1}.
+       * They are accumulated as a low rank correction U * V, and the try_xxx are computed with M^{-1} + U * V.
+       * When K columns are accumulated, the correction is applied to M^{-1} at once with a single gemm.
+       * For large matrices, this replaces many memory bound rank-1 updates by one compute bound matrix product.
+       *
+       * @param K The maximal number of accumulated columns. K = 0 disables the delayed updates.
+       */
+      void set_n_delayed_updates(long K) {
+        TRIQS_ASSERT(last_try == NoTry);
+        TRIQS_ASSERT(K >= 0);
+        flush_delayed_updates();
+        wdl.kmax = K;
+        if (K > 0)
+          wdl.resize(Nmax, K);
+        else
+          wdl.resize(0, 0);
+      }
+
+      /// Apply all pending delayed updates to the inverse matrix.
+      /// It does not change the inverse, only its storage, hence it is const (like the accessors calling it).
+      /// NB : Hence, as long as updates are pending, concurrent calls of the const accessors on the same object are not thread safe.
+      void flush_delayed_updates() const {
+        wdl.apply_to(mat_inv, N);
+        wdl.m = 0;
+      }
+
       /**
        * @brief Constructor.
        *
@@ -313,14 +737,15 @@ namespace triqs {
         std::copy(X.begin(), X.end(), std::back_inserter(x_values));
         std::copy(Y.begin(), Y.end(), std::back_inserter(y_values));
         mat_inv() = 0;
+        matrix_type M(N, N); // det and inverse are computed in double precision, even if mat_inv is stored in single precision
         for (long i = 0; i < N; ++i) {
           row_num.push_back(i);
           col_num.push_back(i);
-          for (long j = 0; j < N; ++j) mat_inv(i, j) = f(x_values[i], y_values[j]);
+          for (long j = 0; j < N; ++j) M(i, j) = f(x_values[i], y_values[j]);
         }
         range RN(N);
-        det             = nda::determinant(mat_inv(RN, RN));
-        mat_inv(RN, RN) = inverse(mat_inv(RN, RN));
+        det             = nda::determinant(M);
+        mat_inv(RN, RN) = inverse(M);
       }
 
       det_manip(det_manip const &) = default;
@@ -341,6 +766,7 @@ namespace triqs {
         sign     = 1;
         det      = 1;
         last_try = NoTry;
+        wdl.m    = 0;
         row_num.clear();
         col_num.clear();
         x_values.clear();
@@ -399,7 +825,7 @@ namespace triqs {
 
       /** Returns M^{-1}(i,j) */
       // warning : need to invert the 2 permutations: (AP)^-1= P^-1 A^-1.
-      value_type inverse_matrix(int i, int j) const { return mat_inv(col_num[i], row_num[j]); }
+      value_type inverse_matrix(int i, int j) const { return inverse_matrix_internal_order(col_num[i], row_num[j]); }
 
       /// Returns the inverse matrix. Warning : this is slow, since it create a new copy, and reorder the lines/cols
       matrix_type inverse_matrix() const {
@@ -413,13 +839,17 @@ namespace triqs {
        * Advanced: Returns the inverse matrix using the INTERNAL STORAGE ORDER.
        * See doc of get_x_internal_order.
        */
-      value_type inverse_matrix_internal_order(int i, int j) const { return mat_inv(i, j); }
+      value_type inverse_matrix_internal_order(int i, int j) const { return mat_inv(i, j) + wdl.correction(i, j); }
 
       /**
        * Advanced: Returns the inverse matrix using the INTERNAL STORAGE ORDER.
        * See doc of get_x_internal_order.
+       * The pending delayed updates are flushed first (cf flush_delayed_updates).
        */
-      nda::matrix_const_view<value_type> inverse_matrix_internal_order() const { return mat_inv(range(N), range(N)); }
+      nda::matrix_const_view<inv_value_type> inverse_matrix_internal_order() const {
+        flush_delayed_updates();
+        return mat_inv(range(N), range(N));
+      }
 
       /// Rebuild the matrix. Warning : this is slow, since it create a new matrix and re-evaluate the function.
       matrix_type matrix() const {
@@ -432,9 +862,131 @@ namespace triqs {
       // Given a lambda fn : x,y,M, it calls fn(x_i,y_j,M_ji) for all i,j
       // Order of iteration is NOT fixed, it is optimised (for memory traversal)
       template <typename LambdaType> friend void foreach (det_manip const &d, LambdaType const &fn) {
-        nda::for_each(std::array{d.N, d.N}, [&fn, &d](int i, int j) { return fn(d.x_values[i], d.y_values[j], d.mat_inv(j, i)); });
+        if (d.wdl.m == 0) {
+          nda::for_each(std::array{d.N, d.N}, [&fn, &d](int i, int j) { return fn(d.x_values[i], d.y_values[j], d.mat_inv(j, i)); });
+        } else { // include the pending delayed updates
+          matrix_type m = d.mat_inv(range(d.N), range(d.N));
+          d.wdl.apply_to(m, d.N);
+          nda::for_each(std::array{d.N, d.N}, [&fn, &d, &m](int i, int j) { return fn(d.x_values[i], d.y_values[j], m(j, i)); });
+        }
+      }
+
+      // ------------------------- DELAYED UPDATES -------------------------------------------
+      // The inverse is mat_inv + U * V (cf work_data_type_delayed).
+      // All functions are no-op (or reduce to the non-delayed operations) when no update is pending.
+      private:
+      // MB += U * (V * B)
+      template <typename V1, typename V2> void _delayed_gemv(V1 const &B, V2 &&MB) {
+        if (wdl.m == 0) return;
+        range RN(N), Rm(wdl.m);
+        blas::gemv(1.0, wdl.V(Rm, RN), B, 0.0, wdl.t(Rm));
+        blas::gemv(1.0, wdl.U(RN, Rm), wdl.t(Rm), 1.0, std::forward<V2>(MB));
+      }
+
+      // MC += transpose(U * V) * C
+      template <typename V1, typename V2> void _delayed_gemv_t(V1 const &C, V2 &&MC) {
+        if (wdl.m == 0) return;
+        range RN(N), Rm(wdl.m);
+        blas::gemv(1.0, transpose(wdl.U(RN, Rm)), C, 0.0, wdl.t(Rm));
+        blas::gemv(1.0, transpose(wdl.V(Rm, RN)), wdl.t(Rm), 1.0, std::forward<V2>(MC));
+      }
+
+      // MB += U * (V * B)
+      template <typename M1, typename M2> void _delayed_gemm(M1 const &B, M2 &&MB) {
+        if (wdl.m == 0) return;
+        range RN(N), Rm(wdl.m);
+        auto VB = wdl.scratch(B.extent(1));
+        blas::gemm(1.0, wdl.V(Rm, RN), B, 0.0, VB);
+        blas::gemm(1.0, wdl.U(RN, Rm), VB, 1.0, std::forward<M2>(MB));
+      }
+
+      // MC += (C * U) * V, with C * U computed transposed in the m x k scratch
+      template <typename M1, typename M2> void _delayed_gemm_t(M1 const &C, M2 &&MC) {
+        if (wdl.m == 0) return;
+        range RN(N), Rm(wdl.m);
+        auto UC = wdl.scratch(C.extent(0));
+        blas::gemm(1.0, transpose(wdl.U(RN, Rm)), transpose(C), 0.0, UC);
+        blas::gemm(1.0, transpose(UC), wdl.V(Rm, RN), 1.0, std::forward<M2>(MC));
+      }
+
+      // out = column i of the inverse
+      template <typename V1> void _inverse_col(long i, V1 &&out) {
+        range RN(N), Rm(wdl.m);
+        out = mat_inv(RN, i);
+        if (wdl.m > 0) blas::gemv(1.0, wdl.U(RN, Rm), wdl.V(Rm, i), 1.0, out);
       }
 
+      // out = row j of the inverse
+      template <typename V1> void _inverse_row(long j, V1 &&out) {
+        range RN(N), Rm(wdl.m);
+        out = mat_inv(j, RN);
+        if (wdl.m > 0) blas::gemv(1.0, transpose(wdl.V(Rm, RN)), wdl.U(j, Rm), 1.0, out);
+      }
+
+      // out = ksi * p, for a k x N panel p of the storage type. In mixed precision, ksi is rounded to the storage type
+      // (as the panels and the inverse), so that the product goes through the BLAS of the storage type.
+      template <typename P, typename Out> void _ksi_times_panel(P const &p, Out &&out) {
+        range Rk(k);
+        if constexpr (is_mixed_precision) {
+          for (long l1 = 0; l1 < k; ++l1)
+            for (long l2 = 0; l2 < k; ++l2) wk.ksi_s(l1, l2) = static_cast<inv_value_type>(wk.ksi(l1, l2));
+          blas::gemm(1.0, wk.ksi_s(Rk, Rk), p, 0.0, std::forward<Out>(out));
+        } else {
+          blas::gemm(1.0, wk.ksi(Rk, Rk), p, 0.0, std::forward<Out>(out));
+        }
+      }
+
+      // ksi += alpha * a * b, for a, b of the storage type. In mixed precision, the product goes through the BLAS of the storage type.
+      template <typename A, typename B> void _ksi_add_product(double alpha, A const &a, B const &b) {
+        range Rk(k);
+        if constexpr (is_mixed_precision) {
+          blas::gemm(alpha, a, b, 0.0, wk.ksi_s(Rk, Rk));
+          for (long l1 = 0; l1 < k; ++l1)
+            for (long l2 = 0; l2 < k; ++l2) wk.ksi(l1, l2) += wk.ksi_s(l1, l2);
+        } else {
+          blas::gemm(alpha, a, b, 1.0, wk.ksi(Rk, Rk));
+        }
+      }
+
+      // Swap the columns (resp. rows) a and b of the pending correction
+      void _delayed_swap_col(long a, long b) {
+        if (wdl.m > 0) deep_swap(wdl.V(range(wdl.m), a), wdl.V(range(wdl.m), b));
+      }
+      void _delayed_swap_row(long a, long b) {
+        if (wdl.m > 0) deep_swap(wdl.U(a, range(wdl.m)), wdl.U(b, range(wdl.m)));
+      }
+
+      // Set the rows and columns R of the pending correction to 0 (for new rows/cols)
+      void _delayed_zero(range R) {
+        if (wdl.m == 0) return;
+        range Rm(wdl.m);
+        wdl.U(R, Rm) = 0;
+        wdl.V(Rm, R) = 0;
+      }
+
+      // Make room for r new columns in U (rows in V), flushing if necessary. Returns the first new column.
+      long _delayed_reserve(long r) {
+        if (wdl.m + r > wdl.kmax) flush_delayed_updates();
+        if (r > wdl.U.extent(1)) wdl.resize(Nmax, r);
+        return wdl.m;
+      }
+
+      // Validate the r new columns. The queue is flushed with a single gemm when it is full.
+      void _delayed_commit(long r) {
+        wdl.m += r;
+        if (wdl.m >= wdl.kmax) flush_delayed_updates();
+      }
+
+      // Delayed version of mat_inv(RN,RN) += alpha * u * v
+      template <typename V1, typename V2> void _delayed_push(value_type alpha, V1 const &u, V2 const &v) {
+        range RN(N);
+        long m0       = _delayed_reserve(1);
+        wdl.U(RN, m0) = inv_value_type(alpha) * u;
+        wdl.V(m0, RN) = v;
+        _delayed_commit(1);
+      }
+
+      public:
       // ------------------------- OPERATIONS -----------------------------------------------
 
       /** Simply swap two lines
@@ -509,7 +1061,8 @@ namespace triqs {
         range RN(N);
         //w1.MB(R) = mat_inv(R,R) * w1.B(R);// OPTIMIZE BELOW
         blas::gemv(1.0, mat_inv(RN, RN), w1.B(RN), 0.0, w1.MB(RN));
-        w1.ksi  = f(x, y) - nda::blas::dot(w1.C(RN), w1.MB(RN));
+        _delayed_gemv(w1.B(RN), w1.MB(RN));
+        w1.ksi  = f(x, y) - blas::dot(w1.C(RN), w1.MB(RN));
         newdet  = det * w1.ksi;
         newsign = ((i + j) % 2 == 0 ? sign : -sign); // since N-i0 + N-j0  = i0+j0 [2]
         return w1.ksi * (newsign * sign);            // sign is unity, hence 1/sign == sign
@@ -543,7 +1096,8 @@ namespace triqs {
         range RN(N);
         //w1.MB(R) = mat_inv(R,R) * w1.B(R);// OPTIMIZE BELOW
         blas::gemv(1.0, mat_inv(RN, RN), w1.B(RN), 0.0, w1.MB(RN));
-        w1.ksi  = ksi - nda::blas::dot(w1.C(RN), w1.MB(RN));
+        _delayed_gemv(w1.B(RN), w1.MB(RN));
+        w1.ksi  = ksi - blas::dot(w1.C(RN), w1.MB(RN));
         newdet  = det * w1.ksi;
         newsign = ((i + j) % 2 == 0 ? sign : -sign); // since N-i0 + N-j0  = i0+j0 [2]
         return w1.ksi * (newsign * sign);            // sign is unity, hence 1/sign == sign
@@ -568,6 +1122,7 @@ namespace triqs {
         range RN(N);
         //w1.MC(R1) = transpose(mat_inv(R1,R1)) * w1.C(R1); //OPTIMIZE BELOW
         blas::gemv(1.0, transpose(mat_inv(RN, RN)), w1.C(RN), 0.0, w1.MC(RN));
+        _delayed_gemv_t(w1.C(RN), w1.MC(RN));
         w1.MC(N) = -1;
         w1.MB(N) = -1;
 
@@ -590,8 +1145,12 @@ namespace triqs {
         // M += w1.ksi w1.MB w1.MC with BLAS. first put the 0
         mat_inv(RN, N - 1) = 0;
         mat_inv(N - 1, RN) = 0;
+        _delayed_zero(range(N - 1, N));
         //mat_inv(R,R) += w1.ksi* w1.MB(R) * w1.MC(R)// OPTIMIZE BELOW
-        blas::ger(w1.ksi, w1.MB(RN), w1.MC(RN), mat_inv(RN, RN));
+        if (wdl.kmax == 0)
+          blas::ger(w1.ksi, w1.MB(RN), w1.MC(RN), mat_inv(RN, RN));
+        else
+          _delayed_push(w1.ksi, w1.MB(RN), w1.MC(RN));
       }
 
       public:
@@ -618,7 +1177,8 @@ namespace triqs {
 
         k = i.size();
         reserve(N + k, k);
-        last_try = InsertK;
+        last_try   = InsertK;
+        wk.fixed_k = 0;
 
         auto const argsort = [](auto const &vec) {
           std::vector<long> idx(vec.size());
@@ -637,6 +1197,48 @@ namespace triqs {
           wk.y[l] = y[idy[l]];
         };
 
+        return _try_insert_k();
+      }
+
+      /**
+       * Same as try_insert_k, for a number K of rows/columns known at compile time.
+       *
+       * For K <= 4, the K x K block ksi and its inverse are std::array of size K * K, with hand-unrolled determinant
+       * and inverse, and the K-wide panels and the rank-K update of the inverse are loops of fixed size K.
+       * Only the products with the N x N inverse go through BLAS. For K > 4, it is the same as try_insert_k.
+       * @category Operations
+       */
+      template <size_t K>
+      value_type try_insert_k(std::array<long, K> const &i, std::array<long, K> const &j, std::array<x_type, K> const &x,
+                              std::array<y_type, K> const &y) {
+        static_assert(K >= 2, "det_manip : try_insert_k<K> requires K >= 2. Use try_insert");
+        TRIQS_ASSERT(last_try == NoTry);
+
+        k = K;
+        reserve(N + K, K);
+        last_try   = InsertK;
+        wk.fixed_k = (long(K) <= work_data_typek_t::k_fixed_max ? long(K) : 0);
+
+        auto idx = details::small_argsort(i);
+        auto idy = details::small_argsort(j);
+
+        // store it for complete_operation
+        for (size_t l = 0; l < K; ++l) {
+          wk.i[l] = i[idx[l]];
+          wk.x[l] = x[idx[l]];
+          wk.j[l] = j[idy[l]];
+          wk.y[l] = y[idy[l]];
+        };
+
+        if constexpr (long(K) <= work_data_typek_t::k_fixed_max)
+          return _try_insert_fixed_k<long(K)>();
+        else
+          return _try_insert_k();
+      }
+
+      private:
+      // try_insert_k, once wk.i, wk.j, wk.x, wk.y are set and sorted
+      value_type _try_insert_k() {
         // check consistency
         for (int l = 0; l < k - 1; ++l) {
           TRIQS_ASSERT(wk.i[l] != wk.i[l + 1] and 0 <= wk.i[l] and wk.i[l] < N + k);
@@ -666,8 +1268,9 @@ namespace triqs {
         range RN(N), Rk(k);
         //wk.MB(RN,Rk) = mat_inv(RN,N) * wk.B(RN,Rk); // OPTIMIZE BELOW
         blas::gemm(1.0, mat_inv(RN, RN), wk.B(RN, Rk), 0.0, wk.MB(RN, Rk));
+        _delayed_gemm(wk.B(RN, Rk), wk.MB(RN, Rk));
         //ksi -= wk.C (Rk, RN) * wk.MB(RN, Rk); // OPTIMIZE BELOW
-        blas::gemm(-1.0, wk.C(Rk, RN), wk.MB(RN, Rk), 1.0, wk.ksi(Rk, Rk));
+        _ksi_add_product(-1.0, wk.C(Rk, RN), wk.MB(RN, Rk));
         auto ksi     = wk.det_ksi(k);
         newdet       = det * ksi;
         long idx_sum = 0;
@@ -675,27 +1278,75 @@ namespace triqs {
         newsign = (idx_sum % 2 == 0 ? sign : -sign); // since N-i0 + N-j0 + N + 1 -i1 + N+1 -j1 = i0+j0 [2]
         return ksi * (newsign * sign);               // sign is unity, hence 1/sign == sign
       }
+
+      // _try_insert_k for K known at compile time : ksi on the stack, panels filled and contracted with loops of size K
+      template <long K> value_type _try_insert_fixed_k() {
+        for (long l = 0; l < K - 1; ++l) {
+          TRIQS_ASSERT(wk.i[l] != wk.i[l + 1] and 0 <= wk.i[l] and wk.i[l] < N + K);
+          TRIQS_ASSERT(wk.j[l] != wk.j[l + 1] and 0 <= wk.j[l] and wk.j[l] < N + K);
+        }
+
+        std::array<value_type, K * K> ksi;
+        for (long m = 0; m < K; ++m)
+          for (long n = 0; n < K; ++n) ksi[m * K + n] = f(wk.x[m], wk.y[n]);
+
+        if (N > 0) {
+          for (long n = 0; n < N; n++) {
+            for (long l = 0; l < K; ++l) {
+              wk.B(n, l) = f(x_values[n], wk.y[l]);
+              wk.C(l, n) = f(wk.x[l], y_values[n]);
+            }
+          }
+          range RN(N), Rk(K);
+          blas::gemm(1.0, mat_inv(RN, RN), wk.B(RN, Rk), 0.0, wk.MB(RN, Rk));
+          _delayed_gemm(wk.B(RN, Rk), wk.MB(RN, Rk));
+          // ksi -= C * MB, accumulated in value_type
+          for (long n = 0; n < N; n++) {
+            std::array<value_type, K> c, mb;
+            for (long l = 0; l < K; ++l) {
+              c[l]  = wk.C(l, n);
+              mb[l] = wk.MB(n, l);
+            }
+            for (long l1 = 0; l1 < K; ++l1)
+              for (long l2 = 0; l2 < K; ++l2) ksi[l1 * K + l2] -= c[l1] * mb[l2];
+          }
+        }
+        std::copy(ksi.begin(), ksi.end(), wk.ksi_fixed.begin());
+
+        auto det_ksi = details::small_det<K>(ksi);
+        if (N == 0) {
+          newdet  = det_ksi;
+          newsign = 1;
+          return det_ksi;
+        }
+        newdet       = det * det_ksi;
+        long idx_sum = 0;
+        for (long l = 0; l < K; ++l) { idx_sum += wk.i[l] + wk.j[l]; }
+        newsign = (idx_sum % 2 == 0 ? sign : -sign);
+        return det_ksi * (newsign * sign);
+      }
+
+      public:
       value_type try_insert2(long i0, long i1, long j0, long j1, x_type const &x0, x_type const &x1, y_type const &y0, y_type const &y1) {
-        return try_insert_k({i0, i1}, {j0, j1}, {x0, x1}, {y0, y1});
+        return try_insert_k<2>({i0, i1}, {j0, j1}, {x0, x1}, {y0, y1});
       }
 
       //------------------------------------------------------------------------------------------
       private:
       void complete_insert_k() {
-
-        // store the new value of x,y. They are seen through the same permutations as rows and cols resp.
-        for (int l = 0; l < k; ++l) {
-          x_values.push_back(wk.x[l]);
-          y_values.push_back(wk.y[l]);
-          row_num.push_back(0);
-          col_num.push_back(0);
+        switch (wk.fixed_k) {
+          case 2: _complete_insert_fixed_k<2>(); return;
+          case 3: _complete_insert_fixed_k<3>(); return;
+          case 4: _complete_insert_fixed_k<4>(); return;
         }
+        _insert_k_push_values();
 
         range Rk(0, k);
         // treat empty matrix separately
         if (N == 0) {
           N               = k;
-          mat_inv(Rk, Rk) = inverse(wk.ksi(Rk, Rk));
+          wk.invert_ksi(k);
+          mat_inv(Rk, Rk) = wk.ksi(Rk, Rk);
           for (long l = 0; l < k; ++l) {
             row_num[wk.i[l]] = l;
             col_num[wk.j[l]] = l;
@@ -706,13 +1357,91 @@ namespace triqs {
         range RN(N);
         //wk.MC(Rk,RN) = wk.C(Rk,RN) * mat_inv(RN,RN);// OPTIMIZE BELOW
         blas::gemm(1.0, wk.C(Rk, RN), mat_inv(RN, RN), 0.0, wk.MC(Rk, RN));
+        _delayed_gemm_t(wk.C(Rk, RN), wk.MC(Rk, RN));
         wk.MC(Rk, range(N, N + k)) = -1; // -identity matrix
         wk.MB(range(N, N + k), Rk) = -1; // -identity matrix !
 
-        // keep the real position of the row/col
-        // since we insert a col/row, we have first to push the col at the right
-        // and then say that col wk.i[0] is stored in N, the last col.
-        // same for rows
+        _insert_k_permutations();
+        RN = range(N);
+
+        wk.invert_ksi(k);
+        mat_inv(RN, range(N - k, N)) = 0;
+        mat_inv(range(N - k, N), RN) = 0;
+        _delayed_zero(range(N - k, N));
+        //mat_inv(RN,RN) += wk.MB(RN,Rk) * (wk.ksi(Rk, Rk) * wk.MC(Rk,RN)); // OPTIMIZE BELOW
+        if (wdl.kmax == 0) {
+          // wk.C is free : use it for wk.ksi * wk.MC
+          _ksi_times_panel(wk.MC(Rk, RN), wk.C(Rk, RN));
+          blas::gemm(1.0, wk.MB(RN, Rk), wk.C(Rk, RN), 1.0, mat_inv(RN, RN));
+        } else {
+          long m0 = _delayed_reserve(k);
+          range Rq(m0, m0 + k);
+          wdl.U(RN, Rq) = wk.MB(RN, Rk);
+          _ksi_times_panel(wk.MC(Rk, RN), wdl.V(Rq, RN));
+          _delayed_commit(k);
+        }
+      }
+
+      // complete_insert_k for K known at compile time
+      template <long K> void _complete_insert_fixed_k() {
+        _insert_k_push_values();
+
+        std::array<value_type, K * K> ksi;
+        std::copy_n(wk.ksi_fixed.begin(), K * K, ksi.begin());
+        details::small_inverse<K>(ksi);
+
+        // treat empty matrix separately
+        if (N == 0) {
+          N = K;
+          for (long l1 = 0; l1 < K; ++l1)
+            for (long l2 = 0; l2 < K; ++l2) mat_inv(l1, l2) = ksi[l1 * K + l2];
+          for (long l = 0; l < K; ++l) {
+            row_num[wk.i[l]] = l;
+            col_num[wk.j[l]] = l;
+          }
+          return;
+        }
+
+        range RN(N), Rk(K);
+        blas::gemm(1.0, wk.C(Rk, RN), mat_inv(RN, RN), 0.0, wk.MC(Rk, RN));
+        _delayed_gemm_t(wk.C(Rk, RN), wk.MC(Rk, RN));
+        for (long l1 = 0; l1 < K; ++l1)
+          for (long l2 = 0; l2 < K; ++l2) wk.MC(l1, N + l2) = wk.MB(N + l1, l2) = inv_value_type(l1 == l2 ? -1 : 0); // -identity matrix
+
+        _insert_k_permutations();
+        RN = range(N);
+
+        mat_inv(RN, range(N - K, N)) = 0;
+        mat_inv(range(N - K, N), RN) = 0;
+        _delayed_zero(range(N - K, N));
+        if (wdl.kmax == 0) {
+          // mat_inv += MB * (ksi * MC), with wk.C free for ksi * MC
+          _small_times_panel<K>(ksi, wk.MC(Rk, RN), wk.C(Rk, RN));
+          _rank_k_update<K>(1, wk.MB(RN, Rk), wk.C(Rk, RN));
+        } else {
+          long m0 = _delayed_reserve(K);
+          range Rq(m0, m0 + K);
+          wdl.U(RN, Rq) = wk.MB(RN, Rk);
+          _small_times_panel<K>(ksi, wk.MC(Rk, RN), wdl.V(Rq, RN));
+          _delayed_commit(K);
+        }
+      }
+
+      // store the new values of x, y. They are seen through the same permutations as rows and cols resp.
+      void _insert_k_push_values() {
+        for (int l = 0; l < k; ++l) {
+          x_values.push_back(wk.x[l]);
+          y_values.push_back(wk.y[l]);
+          row_num.push_back(0);
+          col_num.push_back(0);
+        }
+      }
+
+      // keep the real position of the row/col
+      // since we insert a col/row, we have first to push the col at the right
+      // and then say that col wk.i[0] is stored in N, the last col.
+      // same for rows
+      void _insert_k_permutations() {
         for (int l = 0; l < k; ++l) {
           N++;
           for (long i = N - 2; i >= wk.i[l]; i--) row_num[i + 1] = row_num[i];
@@ -720,13 +1449,36 @@ namespace triqs {
           for (long i = N - 2; i >= wk.j[l]; i--) col_num[i + 1] = col_num[i];
           col_num[wk.j[l]] = N - 1;
         }
-        RN = range(N);
+      }
 
-        wk.ksi(Rk, Rk)               = inverse(wk.ksi(Rk, Rk));
-        mat_inv(RN, range(N - k, N)) = 0;
-        mat_inv(range(N - k, N), RN) = 0;
-        //mat_inv(RN,RN) += wk.MB(RN,Rk) * (wk.ksi(Rk, Rk) * wk.MC(Rk,RN)); // OPTIMIZE BELOW
-        blas::gemm(1.0, wk.MB(RN, Rk), (wk.ksi(Rk, Rk) * wk.MC(Rk, RN)), 1.0, mat_inv(RN, RN));
+      // out(l, j) = sum_m ksi(l, m) * P(m, j), for a K x K block ksi and a K x N panel P
+      template <long K, typename P, typename Out> void _small_times_panel(std::array<value_type, K * K> const &ksi, P const &p, Out &&out) {
+        using S = nda::get_value_t<std::decay_t<Out>>;
+        for (long j = 0; j < p.extent(1); ++j) {
+          std::array<value_type, K> c;
+          for (long m = 0; m < K; ++m) c[m] = p(m, j);
+          for (long l = 0; l < K; ++l) {
+            value_type r = 0;
+            for (long m = 0; m < K; ++m) r += ksi[l * K + m] * c[m];
+            out(l, j) = static_cast<S>(r);
+          }
+        }
+      }
+
+      // mat_inv(RN, RN) += alpha * A * T, for a N x K panel A and a K x N panel T, in one pass over mat_inv
+      template <long K, typename A, typename T> void _rank_k_update(inv_value_type alpha, A const &a, T const &t) {
+        std::array<inv_value_type const *, K> tl;
+        for (long l = 0; l < K; ++l) tl[l] = &t(l, 0);
+        for (long i = 0; i < N; ++i) {
+          std::array<inv_value_type, K> c;
+          for (long l = 0; l < K; ++l) c[l] = alpha * a(i, l);
+          inv_value_type *row = &mat_inv(i, 0);
+          for (long j = 0; j < N; ++j) {
+            inv_value_type r = 0;
+            for (long l = 0; l < K; ++l) r += c[l] * tl[l][j];
+            row[j] += r;
+          }
+        }
       }
       void complete_insert2() { complete_insert_k(); }
 
@@ -751,7 +1503,7 @@ namespace triqs {
         // compute the newdet
         // first we resolve the w1.ireal,w1.jreal, with the permutation of the Minv, then we pick up what
         // will become the 'corner' coefficient, if the move is accepted, after the exchange of row and col.
-        w1.ksi   = mat_inv(w1.jreal, w1.ireal);
+        w1.ksi   = inverse_matrix_internal_order(w1.jreal, w1.ireal);
         auto ksi = w1.ksi;
         newdet   = det * ksi;
         newsign  = ((i + j) % 2 == 0 ? sign : -sign);
@@ -772,6 +1524,7 @@ namespace triqs {
         range RN(N);
         if (w1.ireal != N - 1) {
           deep_swap(mat_inv(RN, w1.ireal), mat_inv(RN, N - 1));
+          _delayed_swap_col(w1.ireal, N - 1);
           x_values[w1.ireal] = x_values[N - 1];
           auto iitr          = std::find(row_num.begin(), row_num.end(), w1.ireal);
           auto titr          = std::find(row_num.begin(), row_num.end(), N - 1);
@@ -779,6 +1532,7 @@ namespace triqs {
         }
         if (w1.jreal != N - 1) {
           deep_swap(mat_inv(w1.jreal, RN), mat_inv(N - 1, RN));
+          _delayed_swap_row(w1.jreal, N - 1);
           y_values[w1.jreal] = y_values[N - 1];
           auto jitr          = std::find(col_num.begin(), col_num.end(), w1.jreal);
           auto titr          = std::find(col_num.begin(), col_num.end(), N - 1);
@@ -796,11 +1550,17 @@ namespace triqs {
         y_values.pop_back();
 
         // M <- a - d^-1 b c with BLAS
-        w1.ksi = -1 / mat_inv(N, N);
+        w1.ksi = -1 / inverse_matrix_internal_order(N, N);
         ASSERT(std::isfinite(std::abs(w1.ksi)));
 
         //mat_inv(RN,RN) += w1.ksi, * mat_inv(RN,N) * mat_inv(N,RN);
-        blas::ger(w1.ksi, mat_inv(RN, N), mat_inv(N, RN), mat_inv(RN, RN));
+        if (wdl.kmax == 0) {
+          blas::ger(w1.ksi, mat_inv(RN, N), mat_inv(N, RN), mat_inv(RN, RN));
+        } else {
+          _inverse_col(N, w1.MB(RN));
+          _inverse_row(N, w1.MC(RN));
+          _delayed_push(w1.ksi, w1.MB(RN), w1.MC(RN));
+        }
       }
 
       public:
@@ -823,24 +1583,63 @@ namespace triqs {
 
         k = i.size();
         reserve(N - k, k);
-        last_try = RemoveK;
+        last_try   = RemoveK;
+        wk.fixed_k = 0;
 
+        for (long l = 0; l < k; ++l) {
+          wk.i[l] = i[l];
+          wk.j[l] = j[l];
+        }
+        return _try_remove_k();
+      }
+
+      /**
+       * Same as try_remove_k, for a number K of rows/columns known at compile time.
+       *
+       * As for try_insert_k<K>, for K <= 4 the K x K block is a std::array with hand-unrolled determinant and inverse,
+       * and the rank-K update of the inverse is a loop of fixed size K.
+       */
+      template <size_t K> value_type try_remove_k(std::array<long, K> i, std::array<long, K> j) {
+        static_assert(K >= 2, "det_manip : try_remove_k<K> requires K >= 2. Use try_remove");
+
+        std::sort(i.begin(), i.end());
+        std::sort(j.begin(), j.end());
+
+        TRIQS_ASSERT(last_try == NoTry);
+        TRIQS_ASSERT(N >= 2);
+
+        k = K;
+        reserve(N - K, K);
+        last_try   = RemoveK;
+        wk.fixed_k = (long(K) <= work_data_typek_t::k_fixed_max ? long(K) : 0);
+
+        for (size_t l = 0; l < K; ++l) {
+          wk.i[l] = i[l];
+          wk.j[l] = j[l];
+        }
+        if constexpr (long(K) <= work_data_typek_t::k_fixed_max)
+          return _try_remove_fixed_k<long(K)>();
+        else
+          return _try_remove_k();
+      }
+
+      private:
+      // try_remove_k, once wk.i, wk.j are set and sorted
+      value_type _try_remove_k() {
         // check inputs
         for (int l = 0; l < k - 1; ++l) {
-          TRIQS_ASSERT(i[l] != i[l + 1] and 0 <= i[l] and i[l] < N);
-          TRIQS_ASSERT(j[l] != j[l + 1] and 0 <= j[l] and j[l] < N);
+          TRIQS_ASSERT(wk.i[l] != wk.i[l + 1] and 0 <= wk.i[l] and wk.i[l] < N);
+          TRIQS_ASSERT(wk.j[l] != wk.j[l + 1] and 0 <= wk.j[l] and wk.j[l] < N);
         }
 
         for (long l = 0; l < k; ++l) {
-          wk.i[l]     = i[l];
-          wk.j[l]     = j[l];
           wk.ireal[l] = row_num[wk.i[l]];
           wk.jreal[l] = col_num[wk.j[l]];
         }
 
         // compute the newdet
         for (long l1 = 0; l1 < k; ++l1) {
-          for (long l2 = 0; l2 < k; ++l2) { wk.ksi(l1, l2) = mat_inv(wk.jreal[l1], wk.ireal[l2]); }
+          for (long l2 = 0; l2 < k; ++l2) { wk.ksi(l1, l2) = inverse_matrix_internal_order(wk.jreal[l1], wk.ireal[l2]); }
         }
         auto det_ksi = wk.det_ksi(k);
         newdet       = det * det_ksi;
@@ -850,7 +1649,32 @@ namespace triqs {
 
         return det_ksi * (newsign * sign); // sign is unity, hence 1/sign == sign
       }
-      value_type try_remove2(long i0, long i1, long j0, long j1) { return try_remove_k({i0, i1}, {j0, j1}); }
+
+      // _try_remove_k for K known at compile time
+      template <long K> value_type _try_remove_fixed_k() {
+        for (long l = 0; l < K - 1; ++l) {
+          TRIQS_ASSERT(wk.i[l] != wk.i[l + 1] and 0 <= wk.i[l] and wk.i[l] < N);
+          TRIQS_ASSERT(wk.j[l] != wk.j[l + 1] and 0 <= wk.j[l] and wk.j[l] < N);
+        }
+
+        for (long l = 0; l < K; ++l) {
+          wk.ireal[l] = row_num[wk.i[l]];
+          wk.jreal[l] = col_num[wk.j[l]];
+        }
+
+        std::array<value_type, K * K> ksi;
+        for (long l1 = 0; l1 < K; ++l1)
+          for (long l2 = 0; l2 < K; ++l2) ksi[l1 * K + l2] = inverse_matrix_internal_order(wk.jreal[l1], wk.ireal[l2]);
+        auto det_ksi = details::small_det<K>(ksi);
+        newdet       = det * det_ksi;
+        long idx_sum = 0;
+        for (long l = 0; l < K; ++l) { idx_sum += wk.i[l] + wk.j[l]; }
+        newsign = (idx_sum % 2 == 0 ? sign : -sign);
+        return det_ksi * (newsign * sign);
+      }
+
+      public:
+      value_type try_remove2(long i0, long i1, long j0, long j1) { return try_remove_k<2>({i0, i1}, {j0, j1}); }
       //------------------------------------------------------------------------------------------
       private:
       void complete_remove_k() {
@@ -859,8 +1683,83 @@ namespace triqs {
           return;
         } // put the sign to 1 also .... Change complete_remove...
 
-        std::vector<long> ireal = wk.ireal;
-        std::vector<long> jreal = wk.jreal;
+        switch (wk.fixed_k) {
+          case 2: _complete_remove_fixed_k<2>(); return;
+          case 3: _complete_remove_fixed_k<3>(); return;
+          case 4: _complete_remove_fixed_k<4>(); return;
+        }
+        _remove_k_move_to_end();
+
+        // M <- a - d^-1 b c with BLAS
+        range RN(N), Rl(N, N + k), Rk(k);
+        if (wdl.kmax == 0) {
+          wk.ksi(Rk, Rk) = mat_inv(Rl, Rl);
+          wk.invert_ksi(k);
+
+          //mat_inv(RN,RN) -= mat_inv(RN,Rl) * (wk.ksi * mat_inv(Rl,RN)); // OPTIMIZE BELOW
+          // wk.MC is free : use it for wk.ksi * mat_inv(Rl,RN)
+          _ksi_times_panel(mat_inv(Rl, RN), wk.MC(Rk, RN));
+          blas::gemm(-1.0, mat_inv(RN, Rl), wk.MC(Rk, RN), 1.0, mat_inv(RN, RN));
+        } else {
+          // the blocks of the inverse, including the pending updates
+          range Rm(wdl.m);
+          wk.MB(RN, Rk)  = mat_inv(RN, Rl);
+          wk.MC(Rk, RN)  = mat_inv(Rl, RN);
+          wk.ksi(Rk, Rk) = mat_inv(Rl, Rl);
+          if (wdl.m > 0) {
+            blas::gemm(1.0, wdl.U(RN, Rm), wdl.V(Rm, Rl), 1.0, wk.MB(RN, Rk));
+            blas::gemm(1.0, wdl.U(Rl, Rm), wdl.V(Rm, RN), 1.0, wk.MC(Rk, RN));
+            _ksi_add_product(1.0, wdl.U(Rl, Rm), wdl.V(Rm, Rl));
+          }
+          wk.invert_ksi(k);
+
+          long m0 = _delayed_reserve(k);
+          range Rq(m0, m0 + k);
+          wdl.U(RN, Rq) = -wk.MB(RN, Rk);
+          _ksi_times_panel(wk.MC(Rk, RN), wdl.V(Rq, RN));
+          _delayed_commit(k);
+        }
+      }
+
+      // complete_remove_k for K known at compile time
+      template <long K> void _complete_remove_fixed_k() {
+        _remove_k_move_to_end();
+
+        range RN(N), Rl(N, N + K), Rk(K);
+        std::array<value_type, K * K> ksi;
+        if (wdl.kmax == 0) {
+          // mat_inv(RN,RN) -= mat_inv(RN,Rl) * (ksi^-1 * mat_inv(Rl,RN)), with wk.MC free for ksi^-1 * mat_inv(Rl,RN)
+          for (long l1 = 0; l1 < K; ++l1)
+            for (long l2 = 0; l2 < K; ++l2) ksi[l1 * K + l2] = mat_inv(N + l1, N + l2);
+          details::small_inverse<K>(ksi);
+          _small_times_panel<K>(ksi, mat_inv(Rl, RN), wk.MC(Rk, RN));
+          _rank_k_update<K>(-1, mat_inv(RN, Rl), wk.MC(Rk, RN));
+        } else {
+          // the blocks of the inverse, including the pending updates
+          range Rm(wdl.m);
+          wk.MB(RN, Rk) = mat_inv(RN, Rl);
+          wk.MC(Rk, RN) = mat_inv(Rl, RN);
+          for (long l1 = 0; l1 < K; ++l1)
+            for (long l2 = 0; l2 < K; ++l2) ksi[l1 * K + l2] = inverse_matrix_internal_order(N + l1, N + l2);
+          if (wdl.m > 0) {
+            blas::gemm(1.0, wdl.U(RN, Rm), wdl.V(Rm, Rl), 1.0, wk.MB(RN, Rk));
+            blas::gemm(1.0, wdl.U(Rl, Rm), wdl.V(Rm, RN), 1.0, wk.MC(Rk, RN));
+          }
+          details::small_inverse<K>(ksi);
+
+          long m0 = _delayed_reserve(K);
+          range Rq(m0, m0 + K);
+          wdl.U(RN, Rq) = -wk.MB(RN, Rk);
+          _small_times_panel<K>(ksi, wk.MC(Rk, RN), wdl.V(Rq, RN));
+          _delayed_commit(K);
+        }
+      }
+
+      // Move the rows and cols to be removed to the end of mat_inv, and remove them from the permutations and the x, y values.
+      void _remove_k_move_to_end() {
+        // wk.ireal, wk.jreal are not used after the completion : sort them in place
+        auto &ireal = wk.ireal;
+        auto &jreal = wk.jreal;
         std::sort(ireal.begin(), ireal.begin() + k);
         std::sort(jreal.begin(), jreal.begin() + k);
 
@@ -872,6 +1771,7 @@ namespace triqs {
         for (long m = k - 1, target = N - 1; m >= 0; --m, --target) {
           if (ireal[m] != target) {
             deep_swap(mat_inv(RN, ireal[m]), mat_inv(RN, target));
+            _delayed_swap_col(ireal[m], target);
             x_values[ireal[m]] = x_values[target];
             auto iitr          = std::find(row_num.begin(), row_num.end(), ireal[m]);
             auto titr          = std::find(row_num.begin(), row_num.end(), target);
@@ -879,6 +1779,7 @@ namespace triqs {
           }
           if (jreal[m] != target) {
             deep_swap(mat_inv(jreal[m], RN), mat_inv(target, RN));
+            _delayed_swap_row(jreal[m], target);
             y_values[jreal[m]] = y_values[target];
             auto jitr          = std::find(col_num.begin(), col_num.end(), jreal[m]);
             auto titr          = std::find(col_num.begin(), col_num.end(), target);
@@ -886,7 +1787,6 @@ namespace triqs {
           }
         }
         N -= k;
-        RN = range(N);
 
         // Clean up removed elements from row_num and col_num
         auto gtN = [&](auto i) { return i >= N; };
@@ -898,15 +1798,8 @@ namespace triqs {
         col_num.resize(N);
         x_values.resize(N);
         y_values.resize(N);
-
-        // M <- a - d^-1 b c with BLAS
-        range Rl(N, N + k), Rk(k);
-        wk.ksi(Rk, Rk) = inverse(mat_inv(Rl, Rl));
-
-        // write explicitely the second product on ksi for speed ?
-        //mat_inv(RN,RN) -= mat_inv(RN,Rl) * (wk.ksi * mat_inv(Rl,RN)); // OPTIMIZE BELOW
-        blas::gemm(-1.0, mat_inv(RN, Rl), wk.ksi(Rk, Rk) * mat_inv(Rl, RN), 1.0, mat_inv(RN, RN));
       }
+
       void complete_remove2() { complete_remove_k(); }
 
       //------------------------------------------------------------------------------------------
@@ -930,9 +1823,10 @@ namespace triqs {
         range RN(N);
         //w1.MB(R) = mat_inv(R,R) * w1.MC(R);// OPTIMIZE BELOW
         blas::gemv(1.0, mat_inv(RN, RN), w1.MC(RN), 0.0, w1.MB(RN));
+        _delayed_gemv(w1.MC(RN), w1.MB(RN));
 
         // compute the newdet
-        w1.ksi   = (1 + w1.MB(w1.jreal));
+        w1.ksi   = (1 + value_type(w1.MB(w1.jreal)));
         auto ksi = w1.ksi;
         newdet   = det * ksi;
         newsign  = sign;
@@ -949,11 +1843,16 @@ namespace triqs {
         // using Shermann Morrison formula.
         // implemented in 2 times : first Bn=0 so that Mnj is not modified ! and then change Mnj
         // Cf notes : simply multiply by -w1.ksi
+        if (wdl.kmax > 0) { // M <- M - MB * M(jreal, :) / ksi
+          _inverse_row(w1.jreal, w1.C(RN));
+          _delayed_push(-1 / w1.ksi, w1.MB(RN), w1.C(RN));
+          return;
+        }
         w1.ksi          = -1 / w1.ksi;
         w1.MB(w1.jreal) = 0;
         //mat_inv(R,R) += w1.ksi * w1.MB(R) * mat_inv(w1.jreal,R)); // OPTIMIZE BELOW
         blas::ger(w1.ksi, w1.MB(RN), mat_inv(w1.jreal, RN), mat_inv(RN, RN));
-        mat_inv(w1.jreal, RN) *= -w1.ksi;
+        mat_inv(w1.jreal, RN) *= inv_value_type(-w1.ksi);
       }
 
       //------------------------------------------------------------------------------------------
@@ -977,9 +1876,10 @@ namespace triqs {
         range RN(N);
         //w1.MC(R) = transpose(mat_inv(R,R)) * w1.MB(R); // OPTIMIZE BELOW
         blas::gemv(1.0, transpose(mat_inv(RN, RN)), w1.MB(RN), 0.0, w1.MC(RN));
+        _delayed_gemv_t(w1.MB(RN), w1.MC(RN));
 
         // compute the newdet
-        w1.ksi   = (1 + w1.MC(w1.ireal));
+        w1.ksi   = (1 + value_type(w1.MC(w1.ireal)));
         auto ksi = w1.ksi;
         newdet   = det * ksi;
         newsign  = sign;
@@ -994,11 +1894,16 @@ namespace triqs {
         // modifying M : M ij += w1.ksi Min Cj
         // using Shermann Morrison formula.
         // impl. Cf case 3
+        if (wdl.kmax > 0) { // M <- M - M(:, ireal) * MC / ksi
+          _inverse_col(w1.ireal, w1.B(RN));
+          _delayed_push(-1 / w1.ksi, w1.B(RN), w1.MC(RN));
+          return;
+        }
         w1.ksi          = -1 / w1.ksi;
         w1.MC(w1.ireal) = 0;
         //mat_inv(R,R) += w1.ksi * mat_inv(R,w1.ireal) * w1.MC(R);
         blas::ger(w1.ksi, mat_inv(RN, w1.ireal), w1.MC(RN), mat_inv(RN, RN));
-        mat_inv(RN, w1.ireal) *= -w1.ksi;
+        mat_inv(RN, w1.ireal) *= inv_value_type(-w1.ksi);
       }
 
       //------------------------------------------------------------------------------------------
@@ -1034,14 +1939,16 @@ namespace triqs {
         // C : X, B : Y
         //w1.C(R) = mat_inv(R,R) * w1.MC(R);// OPTIMIZE BELOW
         blas::gemv(1.0, mat_inv(RN, RN), w1.MC(RN), 0.0, w1.C(RN));
+        _delayed_gemv(w1.MC(RN), w1.C(RN));
         //w1.B(R) = transpose(mat_inv(R,R)) * w1.MB(R); // OPTIMIZE BELOW
         blas::gemv(1.0, transpose(mat_inv(RN, RN)), w1.MB(RN), 0.0, w1.B(RN));
+        _delayed_gemv_t(w1.MB(RN), w1.B(RN));
 
         // compute the det_ratio
-        auto Xn        = w1.C(w1.jreal);
-        auto Yn        = w1.B(w1.ireal);
-        auto Z         = nda::blas::dot(w1.MB(RN), w1.C(RN));
-        auto Mnn       = mat_inv(w1.jreal, w1.ireal);
+        value_type Xn  = w1.C(w1.jreal);
+        value_type Yn  = w1.B(w1.ireal);
+        auto Z         = blas::dot(w1.MB(RN), w1.C(RN));
+        auto Mnn       = inverse_matrix_internal_order(w1.jreal, w1.ireal);
         auto det_ratio = (1 + Xn) * (1 + Yn) - Mnn * Z;
         w1.ksi         = det_ratio;
         newdet         = det * det_ratio;
@@ -1056,27 +1963,156 @@ namespace triqs {
         y_values[w1.jreal] = w1.y;
 
         // FIXME : Use blas for this ? Is it better
-        auto Xn  = w1.C(w1.jreal);
-        auto Yn  = w1.B(w1.ireal);
-        auto Mnn = mat_inv(w1.jreal, w1.ireal);
+        value_type Xn = w1.C(w1.jreal);
+        value_type Yn = w1.B(w1.ireal);
+        auto Mnn = inverse_matrix_internal_order(w1.jreal, w1.ireal);
 
         auto D    = w1.ksi;        // get back
         auto a    = -(1 + Yn) / D; // D in the notes
         auto b    = -(1 + Xn) / D;
-        auto Z    = nda::blas::dot(w1.MB(RN), w1.C(RN));
+        auto Z    = blas::dot(w1.MB(RN), w1.C(RN));
         Z         = Z / D;
         Mnn       = Mnn / D;
-        w1.MB(RN) = mat_inv(w1.jreal, RN); // Mnj
-        w1.MC(RN) = mat_inv(RN, w1.ireal); // Min
+        _inverse_row(w1.jreal, w1.MB(RN)); // Mnj
+        _inverse_col(w1.ireal, w1.MC(RN)); // Min
+
+        if (wdl.kmax > 0) { // rank 2 update : M += X * (a Mn. + Mnn Y) + M.n * (b Y + Z Mn.)
+          long m0           = _delayed_reserve(2);
+          wdl.U(RN, m0)     = w1.C(RN);
+          wdl.V(m0, RN)     = inv_value_type(a) * w1.MB(RN) + inv_value_type(Mnn) * w1.B(RN);
+          wdl.U(RN, m0 + 1) = w1.MC(RN);
+          wdl.V(m0 + 1, RN) = inv_value_type(b) * w1.B(RN) + inv_value_type(Z) * w1.MB(RN);
+          _delayed_commit(2);
+          return;
+        }
 
         for (long i = 0; i < N; ++i)
           for (long j = 0; j < N; ++j) {
-            auto Xi  = w1.C(i);
-            auto Yj  = w1.B(j);
-            auto Mnj = w1.MB(j);
-            auto Min = w1.MC(i);
-            mat_inv(i, j) += a * Xi * Mnj + b * Min * Yj + Mnn * Xi * Yj + Z * Min * Mnj;
+            value_type Xi  = w1.C(i);
+            value_type Yj  = w1.B(j);
+            value_type Mnj = w1.MB(j);
+            value_type Min = w1.MC(i);
+            mat_inv(i, j) += static_cast<inv_value_type>(a * Xi * Mnj + b * Min * Yj + Mnn * Xi * Yj + Z * Min * Mnj);
+          }
+      }
+
+      //------------------------------------------------------------------------------------------
+      public:
+      /**
+       * Consider M candidates for the insertion of a row and a column.
+       *
+       * Candidate c consists in adding the column f(x_l, y[c]) at j[c] and the row f(x[c], y_l) at i[c],
+       * cf try_insert. The products A^(-1) * B of all candidates are computed at once with a single gemm.
+       *
+       * Returns the vector of the ratios det M_new / det M for all candidates.
+       * This routine does NOT make any modification. It has to be completed with complete_batch_operation(c)
+       * for the chosen candidate c, or rejected with reject_last_try().
+       */
+      std::vector<value_type> try_insert_batch(std::vector<long> const &i, std::vector<long> const &j, std::vector<x_type> const &x,
+                                               std::vector<y_type> const &y) {
+        TRIQS_ASSERT(last_try == NoTry);
+        TRIQS_ASSERT(i.size() == j.size());
+        TRIQS_ASSERT(j.size() == x.size());
+        TRIQS_ASSERT(x.size() == y.size());
+
+        long M = x.size();
+        for (long c = 0; c < M; ++c) {
+          TRIQS_ASSERT(0 <= i[c] and i[c] <= N);
+          TRIQS_ASSERT(0 <= j[c] and j[c] <= N);
+        }
+        reserve(N + 1);
+        wb.resize(Nmax, M);
+        last_try = InsertBatch;
+        wb.i     = i;
+        wb.j     = j;
+        wb.x     = x;
+        wb.y     = y;
+        wb.ksi.resize(M);
+
+        for (long c = 0; c < M; ++c) wb.ksi[c] = f(x[c], y[c]);
+
+        if (N > 0) {
+          for (long l = 0; l < N; l++) {
+            for (long c = 0; c < M; ++c) {
+              wb.B(l, c) = f(x_values[l], y[c]);
+              wb.C(c, l) = f(x[c], y_values[l]);
+            }
           }
+          range RN(N), RM(M);
+          //wb.MB(RN,RM) = mat_inv(RN,RN) * wb.B(RN,RM); // OPTIMIZE BELOW
+          blas::gemm(1.0, mat_inv(RN, RN), wb.B(RN, RM), 0.0, wb.MB(RN, RM));
+          _delayed_gemm(wb.B(RN, RM), wb.MB(RN, RM));
+          for (long c = 0; c < M; ++c) wb.ksi[c] -= blas::dot(wb.C(c, RN), wb.MB(RN, c));
+        }
+
+        std::vector<value_type> res(M);
+        for (long c = 0; c < M; ++c) {
+          int s  = (N == 0 ? 1 : ((i[c] + j[c]) % 2 == 0 ? sign : -sign));
+          res[c] = wb.ksi[c] * (s * sign);
+        }
+        return res;
+      }
+
+      /**
+       * Consider M candidates for the removal of row i[c] and column j[c], cf try_remove.
+       *
+       * Returns the vector of the ratios det M_new / det M for all candidates.
+       * This routine does NOT make any modification. It has to be completed with complete_batch_operation(c)
+       * for the chosen candidate c, or rejected with reject_last_try().
+       */
+      std::vector<value_type> try_remove_batch(std::vector<long> const &i, std::vector<long> const &j) {
+        TRIQS_ASSERT(last_try == NoTry);
+        TRIQS_ASSERT(i.size() == j.size());
+        long M = i.size();
+        last_try = RemoveBatch;
+        wb.i     = i;
+        wb.j     = j;
+        wb.ksi.resize(M);
+
+        std::vector<value_type> res(M);
+        for (long c = 0; c < M; ++c) {
+          TRIQS_ASSERT(0 <= i[c] and i[c] < N);
+          TRIQS_ASSERT(0 <= j[c] and j[c] < N);
+          wb.ksi[c] = inverse_matrix_internal_order(col_num[j[c]], row_num[i[c]]);
+          res[c]    = wb.ksi[c] * ((i[c] + j[c]) % 2 == 0 ? 1 : -1);
+        }
+        return res;
+      }
+
+      /**
+       *  Finish the operation of the candidate c of the last try_insert_batch or try_remove_batch.
+       */
+      void complete_batch_operation(long c) {
+        TRIQS_ASSERT(0 <= c and c < long(wb.i.size()));
+        w1.i = wb.i[c];
+        w1.j = wb.j[c];
+        switch (last_try) {
+          case (InsertBatch): {
+            w1.x = wb.x[c];
+            w1.y = wb.y[c];
+            if (N > 0) {
+              range RN(N);
+              w1.MB(RN) = wb.MB(RN, c);
+              w1.C(RN)  = wb.C(c, RN);
+            }
+            w1.ksi   = wb.ksi[c];
+            newdet   = det * w1.ksi;
+            newsign  = (N == 0 ? 1 : ((w1.i + w1.j) % 2 == 0 ? sign : -sign));
+            last_try = Insert;
+            break;
+          }
+          case (RemoveBatch): {
+            w1.ireal = row_num[w1.i];
+            w1.jreal = col_num[w1.j];
+            w1.ksi   = wb.ksi[c];
+            newdet   = det * w1.ksi;
+            newsign  = ((w1.i + w1.j) % 2 == 0 ? sign : -sign);
+            last_try = Remove;
+            break;
+          }
+          default: TRIQS_RUNTIME_ERROR << "det_manip : complete_batch_operation called without try_insert_batch or try_remove_batch";
+        }
+        complete_operation();
       }
 
       //------------------------------------------------------------------------------------------
@@ -1134,6 +2170,7 @@ namespace triqs {
         }
 
         reserve(N);
+        wdl.m = 0;
         std::swap(x_values, w_refill.x_values);
         std::swap(y_values, w_refill.y_values);
 
@@ -1149,6 +2186,12 @@ namespace triqs {
       //------------------------------------------------------------------------------------------
       private:
       void _regenerate_with_check(bool do_check, double prec_warning, double prec_error) {
+        // mat_inv is recomputed : the pending delayed updates are only needed for the check
+        if (do_check)
+          flush_delayed_updates();
+        else
+          wdl.m = 0;
+
         if (N == 0) {
           det  = 1;
           sign = 1;
@@ -1166,10 +2209,30 @@ namespace triqs {
 
         if (do_check) { // check that mat_inv is close to res
           const bool relative = true;
-          double r            = max_element(abs(res - mat_inv(RN, RN)));
-          double r2           = max_element(abs(res + mat_inv(RN, RN)));
-          bool err            = !(r < (relative ? prec_error * r2 : prec_error));
-          bool war            = !(r < (relative ? prec_warning * r2 : prec_warning));
+          auto minv           = [&]() {
+            if constexpr (is_mixed_precision)
+              return matrix_type{mat_inv(RN, RN)};
+            else
+              return mat_inv(RN, RN);
+          }();
+          double r  = max_element(abs(res - minv));
+          double r2 = max_element(abs(res + minv));
+          bool err  = !(r < (relative ? prec_error * r2 : prec_error));
+          bool war  = !(r < (relative ? prec_warning * r2 : prec_warning));
+          // single precision storage : a deviation above the warning threshold is first handled by refreshing the inverse
+          // more often, down to a minimal period. A clean check lets the period grow back to the one set by the user.
+          bool at_min_period = false;
+          if constexpr (is_mixed_precision) {
+            auto n_min = std::min(n_opts_min_before_check, n_opts_check_period);
+            if (war and not err) {
+              at_min_period = (n_opts_max_before_check <= n_min);
+              if (not at_min_period) {
+                n_opts_max_before_check = std::max(n_min, n_opts_max_before_check / 2);
+                war                     = false;
+              }
+            } else if (not war)
+              n_opts_max_before_check = std::min(n_opts_check_period, 2 * n_opts_max_before_check);
+          }
           if (err || war) {
             std::cerr << "matrix  = " << matrix() << std::endl;
             std::cerr << "inverse_matrix = " << inverse_matrix() << std::endl;
@@ -1180,6 +2243,9 @@ namespace triqs {
                       << "N = " << N << "  "
                       << "\n   max(abs(M^-1 - M^-1_true)) = " << r
                       << "\n   precision*max(abs(M^-1 + M^-1_true)) = " << (relative ? prec_warning * r2 : prec_warning) << " " << std::endl;
+          if (at_min_period)
+            std::cerr << "   the inverse is stored in single precision and already checked every " << n_opts_max_before_check
+                      << " operations : consider storing it in double precision" << std::endl;
           if (err) TRIQS_RUNTIME_ERROR << "Error : det_manip deviation above critical threshold !! ";
         }
 
@@ -1223,6 +2289,8 @@ namespace triqs {
           case (InsertK): complete_insert_k(); break;
           case (RemoveK): complete_remove_k(); break;
           case (Refill): complete_refill(); break;
+          case (InsertBatch):
+          case (RemoveBatch): TRIQS_RUNTIME_ERROR << "det_manip : use complete_batch_operation to complete a batch operation"; break;
           case (NoTry): return; break;
           default: TRIQS_RUNTIME_ERROR << "Misuing det_manip"; // Never used?
         }
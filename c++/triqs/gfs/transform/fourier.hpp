@@ -27,6 +27,43 @@ namespace triqs::gfs {
   // trait for error messages later
   template <typename V> using _mesh_fourier_image = decltype(make_adjoint_mesh(V()));
 
+  /*------------------------------------------------------------------------------------------------------
+            FFTW plans
+  *-----------------------------------------------------------------------------------------------------*/
+
+  /// Effort of FFTW in planning the transforms, cf FFTW_ESTIMATE, FFTW_MEASURE and FFTW_PATIENT.
+  /// measure and patient time the candidate algorithms on scratch arrays: the planning is slower, the transforms faster.
+  enum class fftw_planning { estimate, measure, patient };
+
+  /// Set the planning effort for the FFTW plans made from now on. Default is estimate.
+  /// The plans are cached for the whole process, by geometry of the transform and planning effort,
+  /// so that repeated transforms of the same shape are planned only once.
+  void set_fftw_planning(fftw_planning p);
+
+  /// The planning effort for the FFTW plans
+  fftw_planning get_fftw_planning();
+
+  /// Set the number of threads of the Fourier transforms. Default is 1.
+  /// They are used for the preparation of the data around the FFT (e.g. the subtraction of the tail),
+  /// parallelized over the target indices, and for the FFT itself if TRIQS is linked with fftw3_threads.
+  void set_fftw_threads(int n);
+
+  /// The number of threads of the Fourier transforms
+  int get_fftw_threads();
+
+  /// Number of FFTW plans in the cache
+  long fftw_plan_cache_size();
+
+  /// Destroy all the cached FFTW plans
+  void clear_fftw_plan_cache();
+
+  /// Import FFTW wisdom (the result of measure/patient planning of previous runs) from a file.
+  /// Returns false if the file can not be read. Call it before the first transforms, e.g. at the start of the run.
+  bool import_fftw_wisdom(std::string const &filename);
+
+  /// Export the FFTW wisdom accumulated by the planning of this process to a file. Throws if the file can not be written.
+  void export_fftw_wisdom(std::string const &filename);
+
   /*------------------------------------------------------------------------------------------------------
             Implementation
   *-----------------------------------------------------------------------------------------------------*/
@@ -47,6 +84,17 @@ namespace triqs::gfs {
   gf_vec_t<cyclat> _fourier_impl(cyclat const &r_mesh, gf_vec_cvt<brzone> gk);
   gf_vec_t<brzone> _fourier_impl(brzone const &k_mesh, gf_vec_cvt<cyclat> gr);
 
+  // lattice, on the data of a Green function with several meshes, reshaped to (A, M, B) with M the points of the lattice mesh :
+  // the transform acts directly with the strides of the data, without flattening
+  void _fourier_impl_strided(cyclat const &r_mesh, brzone const &k_mesh, array_const_view<dcomplex, 3> gk, array_view<dcomplex, 3> gr);
+  void _fourier_impl_strided(brzone const &k_mesh, cyclat const &r_mesh, array_const_view<dcomplex, 3> gr, array_view<dcomplex, 3> gk);
+
+  template <typename M> constexpr bool _is_lattice_mesh = std::is_same_v<M, cyclat> or std::is_same_v<M, brzone>;
+
+  // lattice, distributed : g holds the local chunk of rows of the (n_points, B) data, transformed in place
+  void _fourier_impl_distributed(cyclat const &r_mesh, brzone const &k_mesh, array_view<dcomplex, 2> g, mpi::communicator c);
+  void _fourier_impl_distributed(brzone const &k_mesh, cyclat const &r_mesh, array_view<dcomplex, 2> g, mpi::communicator c);
+
   /*------------------------------------------------------------------------------------------------------
    *
    * The general Fourier function
@@ -71,6 +119,20 @@ namespace triqs::gfs {
         return gout.mesh();
     }();
 
+    // Lattice transform on one mesh of a product : no flatten/unflatten copies when the data are contiguous.
+    // NB : the single mesh case keeps the flattened path, which detects real and Hermitian data
+    if constexpr (mesh::is_product<M1> and _is_lattice_mesh<std::decay_t<decltype(out_mesh)>> and std::is_same_v<typename T1::complex_t, T1>) {
+      if (gin.data().indexmap().is_contiguous() and gout.data().indexmap().is_contiguous()) {
+        auto sh = gin.data().shape();
+        long A = 1, B = 1;
+        for (int i = 0; i < N; ++i) A *= sh[i];
+        for (int i = N + 1; i < int(sh.size()); ++i) B *= sh[i];
+        auto shape_3d = std::array{A, sh[N], B};
+        _fourier_impl_strided(out_mesh, get_mesh<N>(gin), reshape(gin.data(), shape_3d), reshape(gout.data(), shape_3d));
+        return;
+      }
+    }
+
     // FIXME : Code failed with nda optimisation relaxing assumption on iterator order.
     // between nda::for_each and the flatten which were not inverse of each other any more
     // TODO : put back the optimisation in nda (MACRO ??)
@@ -244,6 +306,43 @@ namespace triqs::gfs {
     //    return make_gf_from_fourier<N, Ns...>(make_const_view(gin), std::forward<Args>(args)...);
   }
 
+  /* *-----------------------------------------------------------------------------------------------------
+   *
+   * Distributed lattice transform
+   *
+   * *-----------------------------------------------------------------------------------------------------*/
+
+  /**
+   * Lattice Fourier transform of the data of a Green function whose first mesh is a lattice mesh (brzone or cyclat),
+   * distributed over the lattice points, e.g. G(k, iw) on a k-mesh too large for a single node.
+   *
+   * Each rank holds the chunk of the lattice points given to it by mpi::scatter of the full data, i.e. the points
+   * itertools::chunk_range(0, in_mesh.size(), c.size(), c.rank()), and all the other dimensions (other meshes, target).
+   * The result is distributed in the same way over out_mesh. No rank ever holds the full data : the data are
+   * redistributed over the other dimensions by all-to-all communications, transformed locally, and redistributed back.
+   *
+   * NB : When another mesh is distributed instead, e.g. the frequencies of G(k, iw),
+   * the transform of the local part (make_gf_from_fourier<0>) needs no communication.
+   *
+   * @param data The local part of the data, of first dimension the size of the chunk of the rank
+   * @param in_mesh The full lattice mesh of the data
+   * @param out_mesh The full adjoint mesh of in_mesh
+   * @param c The communicator
+   * @return The local part of the transformed data, of the same shape as data
+   */
+  template <typename M1, typename M2, nda::MemoryArray A>
+  array<dcomplex, nda::get_rank<A>> make_array_from_distributed_fourier(A const &data, M1 const &in_mesh, M2 const &out_mesh, mpi::communicator c = {}) {
+    static_assert(_is_lattice_mesh<M1> and std::is_same_v<M2, _mesh_fourier_image<M1>>, "There is no distributed Fourier transform between these two meshes");
+    auto [first, last] = itertools::chunk_range(0, in_mesh.size(), c.size(), c.rank());
+    if (data.extent(0) != last - first)
+      TRIQS_RUNTIME_ERROR << "Distributed Fourier : the rank " << c.rank() << " has " << data.extent(0) << " lattice points instead of " << last - first;
+    auto res = array<dcomplex, nda::get_rank<A>>{data};
+    long n_others = 1;
+    for (int i = 1; i < nda::get_rank<A>; ++i) n_others *= res.extent(i);
+    _fourier_impl_distributed(out_mesh, in_mesh, reshape(res, std::array{res.extent(0), n_others}), c);
+    return res;
+  }
+
   /*------------------------------------------------------------------------------------------------------
   *                                  Lazy transformation
   *-----------------------------------------------------------------------------------------------------*/
@@ -19,51 +19,252 @@
 
 #include <triqs/gfs.hpp>
 #include "./fourier_common.hpp"
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 namespace triqs::gfs {
 
+  namespace {
+
+    // complex-to-complex, real-to-complex (forward) and complex-to-real (backward) transforms
+    enum class fft_kind { c2c, r2c, c2r };
+
+    // A plan is determined by the geometry of the transform, and can then be executed on any arrays
+    // with the same geometry (fftw_execute_dft...), provided they have the alignment of the arrays of the planning.
+    struct plan_key {
+      fft_kind kind;
+      std::vector<int> dims;
+      int howmany, in_stride, out_stride, in_dist, out_dist, sign, n_threads;
+      bool in_place, aligned;
+      unsigned flags;
+      auto operator<=>(plan_key const &) const = default;
+    };
+
+    struct plan_cache_t {
+      std::mutex mutex; // the FFTW planner is not thread-safe, the execution of the plans is
+      std::map<plan_key, fftw_plan> plans;
+      fftw_planning planning = fftw_planning::estimate;
+      int n_threads          = 1;
+      bool threads_init      = false;
+      ~plan_cache_t() {
+        for (auto &[k, p] : plans) fftw_destroy_plan(p);
+      }
+    };
+
+    plan_cache_t &plan_cache() {
+      static plan_cache_t c;
+      return c;
+    }
+
+    unsigned planner_flags(fftw_planning p) {
+      switch (p) {
+        case fftw_planning::measure: return FFTW_MEASURE;
+        case fftw_planning::patient: return FFTW_PATIENT;
+        default: return FFTW_ESTIMATE;
+      }
+    }
+
+    // Get the plan for the key from the cache, or make it. Planning with FFTW_ESTIMATE leaves the arrays untouched and
+    // is done on in/out directly, the other planners overwrite the arrays and work on scratch arrays of the same size.
+    fftw_plan get_plan(plan_key const &k, void *in, void *out) {
+      auto &c = plan_cache();
+      std::lock_guard lock{c.mutex};
+      if (auto it = c.plans.find(k); it != c.plans.end()) return it->second;
+
+      // number of points of the real and complex (half of the last dimension for r2c and c2r) sides
+      long n = 1;
+      for (auto d : k.dims) n *= d;
+      long n_half  = n / k.dims.back() * (k.dims.back() / 2 + 1);
+      long n_in    = (k.kind == fft_kind::c2r ? n_half : n);
+      long n_out   = (k.kind == fft_kind::r2c ? n_half : n);
+      auto size_in = (k.kind == fft_kind::r2c ? sizeof(double) : sizeof(fftw_complex));
+      auto size_out = (k.kind == fft_kind::c2r ? sizeof(double) : sizeof(fftw_complex));
+
+      auto flags = k.flags | (k.aligned ? 0u : unsigned(FFTW_UNALIGNED));
+      void *in_s = in, *out_s = out;
+      if (k.flags != FFTW_ESTIMATE) {
+        in_s  = fftw_malloc(((n_in - 1) * k.in_stride + (k.howmany - 1) * k.in_dist + 1) * size_in);
+        out_s = (k.in_place ? in_s : fftw_malloc(((n_out - 1) * k.out_stride + (k.howmany - 1) * k.out_dist + 1) * size_out));
+      }
+
+#ifdef TRIQS_FFTW_THREADS
+      if (not c.threads_init) c.threads_init = (fftw_init_threads() != 0);
+      if (c.threads_init) fftw_plan_with_nthreads(k.n_threads);
+#endif
+
+      int rank = k.dims.size();
+      fftw_plan p;
+      switch (k.kind) {
+        case fft_kind::c2c:
+          p = fftw_plan_many_dft(rank,                                // rank
+                                 k.dims.data(),                       // the dimension
+                                 k.howmany,                           // how many FFT
+                                 static_cast<fftw_complex *>(in_s),   // in data
+                                 NULL,                                // embed : unused. Doc unclear ?
+                                 k.in_stride,                         // stride of the in data
+                                 k.in_dist,                           // in : shift for multi fft.
+                                 static_cast<fftw_complex *>(out_s),  // out data
+                                 NULL,                                // embed : unused. Doc unclear ?
+                                 k.out_stride,                        // stride of the out data
+                                 k.out_dist,                          // out : shift for multi fft.
+                                 k.sign, flags);
+          break;
+        case fft_kind::r2c:
+          p = fftw_plan_many_dft_r2c(rank, k.dims.data(), k.howmany, static_cast<double *>(in_s), NULL, k.in_stride, k.in_dist,
+                                     static_cast<fftw_complex *>(out_s), NULL, k.out_stride, k.out_dist, flags);
+          break;
+        case fft_kind::c2r:
+          p = fftw_plan_many_dft_c2r(rank, k.dims.data(), k.howmany, static_cast<fftw_complex *>(in_s), NULL, k.in_stride, k.in_dist,
+                                     static_cast<double *>(out_s), NULL, k.out_stride, k.out_dist, flags);
+          break;
+      }
+
+      if (in_s != in) {
+        if (out_s != in_s) fftw_free(out_s);
+        fftw_free(in_s);
+      }
+      if (p == NULL) TRIQS_RUNTIME_ERROR << "Fourier : FFTW could not make a plan";
+      c.plans.emplace(k, p);
+      return p;
+    }
+
+  } // namespace
+
+  void set_fftw_planning(fftw_planning p) {
+    auto &c = plan_cache();
+    std::lock_guard lock{c.mutex};
+    c.planning = p;
+  }
+
+  fftw_planning get_fftw_planning() {
+    auto &c = plan_cache();
+    std::lock_guard lock{c.mutex};
+    return c.planning;
+  }
+
+  void set_fftw_threads(int n) {
+    if (n < 1) TRIQS_RUNTIME_ERROR << "Fourier : the number of threads must be >= 1, not " << n;
+    auto &c = plan_cache();
+    std::lock_guard lock{c.mutex};
+    c.n_threads = n;
+  }
+
+  int get_fftw_threads() {
+    auto &c = plan_cache();
+    std::lock_guard lock{c.mutex};
+    return c.n_threads;
+  }
+
+  void _fourier_parallel_for(long n, long work_per_index, std::function<void(long, long)> const &f) {
+    constexpr long min_work_per_thread = 1 << 15;
+    long n_threads                     = std::clamp<long>(n * work_per_index / min_work_per_thread, 1, std::max<long>(std::min<long>(get_fftw_threads(), n), 1));
+    if (n_threads == 1) return f(0, n);
+    std::vector<std::thread> threads;
+    for (long t = 1; t < n_threads; ++t) threads.emplace_back(f, n * t / n_threads, n * (t + 1) / n_threads);
+    f(0, n / n_threads);
+    for (auto &th : threads) th.join();
+  }
+
+  long fftw_plan_cache_size() {
+    auto &c = plan_cache();
+    std::lock_guard lock{c.mutex};
+    return c.plans.size();
+  }
+
+  void clear_fftw_plan_cache() {
+    auto &c = plan_cache();
+    std::lock_guard lock{c.mutex};
+    for (auto &[k, p] : c.plans) fftw_destroy_plan(p);
+    c.plans.clear();
+  }
+
+  bool import_fftw_wisdom(std::string const &filename) {
+    auto &c = plan_cache();
+    std::lock_guard lock{c.mutex};
+    return fftw_import_wisdom_from_filename(filename.c_str()) != 0;
+  }
+
+  void export_fftw_wisdom(std::string const &filename) {
+    auto &c = plan_cache();
+    std::lock_guard lock{c.mutex};
+    if (fftw_export_wisdom_to_filename(filename.c_str()) == 0) TRIQS_RUNTIME_ERROR << "Fourier : can not write the FFTW wisdom to " << filename;
+  }
+
   void _fourier_base(array_const_view<dcomplex, 2> in, array_view<dcomplex, 2> out, int rank, int *dims, int fftw_count, int fftw_backward_forward) {
 
     auto in_fft  = reinterpret_cast<fftw_complex *>(const_cast<dcomplex *>(in.data()));
     auto out_fft = reinterpret_cast<fftw_complex *>(out.data());
 
-    auto p = fftw_plan_many_dft(rank,                        // rank
-                                dims,                        // the dimension
-                                fftw_count,                  // how many FFT : here 1
-                                in_fft,                      // in data
-                                NULL,                        // embed : unused. Doc unclear ?
-                                in.indexmap().strides()[0],  // stride of the in data
-                                1,                           // in : shift for multi fft.
-                                out_fft,                     // out data
-                                NULL,                        // embed : unused. Doc unclear ?
-                                out.indexmap().strides()[0], // stride of the out data
-                                1,                           // out : shift for multi fft.
-                                fftw_backward_forward, FFTW_ESTIMATE);
-
-    fftw_execute(p);
-    fftw_destroy_plan(p);
+    auto k = plan_key{.kind       = fft_kind::c2c,
+                      .dims       = std::vector<int>(dims, dims + rank),
+                      .howmany    = fftw_count,
+                      .in_stride  = int(in.indexmap().strides()[0]),
+                      .out_stride = int(out.indexmap().strides()[0]),
+                      .in_dist    = 1,
+                      .out_dist   = 1,
+                      .sign       = fftw_backward_forward,
+                      .n_threads  = 1,
+                      .in_place   = (in_fft == out_fft),
+                      .aligned    = (fftw_alignment_of(reinterpret_cast<double *>(in_fft)) == 0)
+                         and (fftw_alignment_of(reinterpret_cast<double *>(out_fft)) == 0),
+                      .flags = planner_flags(get_fftw_planning())};
+#ifdef TRIQS_FFTW_THREADS
+    k.n_threads = get_fftw_threads();
+#endif
+
+    fftw_execute_dft(get_plan(k, in_fft, out_fft), in_fft, out_fft);
   }
 
-  //void _fourier_base(array_const_view<double, 2> in, array_view<dcomplex, 2> out, int rank, int *dims, int fftw_count) {
-
-  //auto in_fft  = reinterpret_cast<fftw_real *>(in.data());
-  //auto out_fft = reinterpret_cast<fftw_complex *>(out.data());
-
-  //auto p = fftw_plan_many_dft(rank,                        // rank
-  //dims,                        // the dimension
-  //fftw_count,                  // how many FFT : here 1
-  //in_fft,                      // in data
-  //NULL,                        // embed : unused. Doc unclear ?
-  //in.indexmap().strides()[0],  // stride of the in data
-  //1,                           // in : shift for multi fft.
-  //out_fft,                     // out data
-  //NULL,                        // embed : unused. Doc unclear ?
-  //out.indexmap().strides()[0], // stride of the out data
-  //1,                           // out : shift for multi fft.
-  //FFTW_ESTIMATE);
-
-  //fftw_execute(p);
-  //fftw_destroy_plan(p);
-  //}
+  // The real parts of the complex arrays are seen by FFTW as double arrays with twice the strides
+  void _fourier_base_r2c(array_const_view<dcomplex, 2> in, array_view<dcomplex, 2> out, int rank, int *dims, int fftw_count) {
+
+    auto in_fft  = reinterpret_cast<double *>(const_cast<dcomplex *>(in.data()));
+    auto out_fft = reinterpret_cast<fftw_complex *>(out.data());
+
+    auto k = plan_key{.kind       = fft_kind::r2c,
+                      .dims       = std::vector<int>(dims, dims + rank),
+                      .howmany    = fftw_count,
+                      .in_stride  = int(2 * in.indexmap().strides()[0]),
+                      .out_stride = int(out.indexmap().strides()[0]),
+                      .in_dist    = int(2 * in.indexmap().strides()[1]),
+                      .out_dist   = int(out.indexmap().strides()[1]),
+                      .sign       = FFTW_FORWARD,
+                      .n_threads  = 1,
+                      .in_place   = false,
+                      .aligned    = (fftw_alignment_of(in_fft) == 0) and (fftw_alignment_of(reinterpret_cast<double *>(out_fft)) == 0),
+                      .flags      = planner_flags(get_fftw_planning())};
+#ifdef TRIQS_FFTW_THREADS
+    k.n_threads = get_fftw_threads();
+#endif
+
+    fftw_execute_dft_r2c(get_plan(k, in_fft, out_fft), in_fft, out_fft);
+  }
+
+  void _fourier_base_c2r(array_view<dcomplex, 2> in, array_view<dcomplex, 2> out, int rank, int *dims, int fftw_count) {
+
+    auto in_fft  = reinterpret_cast<fftw_complex *>(in.data());
+    auto out_fft = reinterpret_cast<double *>(out.data());
+
+    auto k = plan_key{.kind       = fft_kind::c2r,
+                      .dims       = std::vector<int>(dims, dims + rank),
+                      .howmany    = fftw_count,
+                      .in_stride  = int(in.indexmap().strides()[0]),
+                      .out_stride = int(2 * out.indexmap().strides()[0]),
+                      .in_dist    = int(in.indexmap().strides()[1]),
+                      .out_dist   = int(2 * out.indexmap().strides()[1]),
+                      .sign       = FFTW_BACKWARD,
+                      .n_threads  = 1,
+                      .in_place   = false,
+                      .aligned    = (fftw_alignment_of(reinterpret_cast<double *>(in_fft)) == 0) and (fftw_alignment_of(out_fft) == 0),
+                      .flags      = planner_flags(get_fftw_planning())};
+#ifdef TRIQS_FFTW_THREADS
+    k.n_threads = get_fftw_threads();
+#endif
+
+    fftw_execute_dft_c2r(get_plan(k, in_fft, out_fft), in_fft, out_fft);
+  }
 
 } // namespace triqs::gfs
@@ -21,6 +21,7 @@
 #include <triqs/arrays.hpp>
 // include only in cpp implementation
 #include <fftw3.h>
+#include <functional>
 
 namespace triqs::gfs {
 
@@ -28,4 +29,16 @@ namespace triqs::gfs {
   // call to fftw
   void _fourier_base(array_const_view<dcomplex, 2> in, array_view<dcomplex, 2> out, int rank, int *dims, int fftw_count, int fftw_backward_forward);
 
+  // real to complex FFTW_FORWARD transform of the real parts of in, read in place (the imaginary parts are ignored) :
+  // out has the first (rank - 1) dimensions of in, and dims[rank - 1] / 2 + 1 points in the last one
+  void _fourier_base_r2c(array_const_view<dcomplex, 2> in, array_view<dcomplex, 2> out, int rank, int *dims, int fftw_count);
+
+  // complex to real FFTW_BACKWARD transform, inverse of the previous one up to normalization, written in the real parts
+  // of out (the imaginary parts are left untouched). NB : in is overwritten
+  void _fourier_base_c2r(array_view<dcomplex, 2> in, array_view<dcomplex, 2> out, int rank, int *dims, int fftw_count);
+
+  // Calls f(first, last) on consecutive ranges covering [0, n), on the threads of the Fourier transforms (set_fftw_threads).
+  // work_per_index is the number of elements processed by f per index, ranges are only split off for large enough work.
+  void _fourier_parallel_for(long n, long work_per_index, std::function<void(long, long)> const &f);
+
 } // namespace triqs::gfs
@@ -20,13 +20,67 @@
 #include "../../gfs.hpp"
 #include "./fourier_common.hpp"
 #include <itertools/itertools.hpp>
+#include <algorithm>
+#include <limits>
 
 #define ASSERT_EQUAL(X, Y, MESS)                                                                                                                     \
   if (X != Y) TRIQS_RUNTIME_ERROR << MESS;
 
 namespace triqs::gfs {
 
+  namespace {
+
+    // The dimensions of size > 1 of the mesh, on which the transform actually acts
+    std::vector<int> fft_dims(std::array<long, 3> const &dims) {
+      std::vector<int> r;
+      for (auto d : dims)
+        if (d > 1) r.push_back(d);
+      if (r.empty()) r.push_back(1);
+      return r;
+    }
+
+    // For each point l of a periodic mesh of dimensions dims (row-major) : the index of the opposite point -l,
+    // and its index in the arrays of the r2c/c2r transforms, which keep dims.back() / 2 + 1 points of the last dimension (-1 if absent)
+    struct hermitian_indices {
+      std::vector<long> opposite, half;
+      long n_half = 1;
+
+      hermitian_indices(std::vector<int> const &dims) {
+        long n = 1;
+        for (auto d : dims) n *= d;
+        long last = dims.back(), last_half = last / 2 + 1;
+        n_half    = n / last * last_half;
+        opposite.resize(n);
+        half.resize(n);
+        for (long l = 0; l < n; ++l) {
+          long r = l, l_opp = 0, stride = 1;
+          for (int k = dims.size() - 1; k >= 0; --k) {
+            long j = r % dims[k];
+            r /= dims[k];
+            l_opp += ((dims[k] - j) % dims[k]) * stride;
+            stride *= dims[k];
+          }
+          opposite[l] = l_opp;
+          half[l]     = (l % last < last_half ? (l / last) * last_half + l % last : -1);
+        }
+      }
+    };
+
+    // Is g(-l) = conj(g(l)) for all points l of the mesh, up to the tolerance relative to the largest element ?
+    bool is_hermitian(array_const_view<dcomplex, 2> g, hermitian_indices const &hi, double tolerance = 1.e-13) {
+      double eps = tolerance * max_element(abs(g));
+      for (long l = 0; l < first_dim(g); ++l)
+        for (long c = 0; c < second_dim(g); ++c)
+          if (std::abs(g(hi.opposite[l], c) - std::conj(g(l, c))) > eps) return false;
+      return true;
+    }
+
+  } // namespace
+
   // The implementation is almost the same in both cases...
+  // When the input is real (e.g. G(R) for real hoppings), or Hermitian so that the output is real, the transform
+  // is done by a real-to-complex (resp. complex-to-real) FFT over half of the points, and completed with the Hermitian symmetry.
+  // r2c computes the FFTW_FORWARD transform, and c2r the FFTW_BACKWARD one : the other sign follows by conjugation.
   template <typename M1, typename M2> gf_vec_t<M1> __impl(int fftw_backward_forward, M1 const &out_mesh, gf_vec_cvt<M2> g_in) {
 
     //ASSERT_EQUAL(g_out.data().shape(), g_in.data().shape(), "Meshes are different");
@@ -38,10 +92,44 @@ namespace triqs::gfs {
     auto g_out    = gf_vec_t<M1>{out_mesh, std::array{g_in.target_shape()[0]}};
     long n_others = second_dim(g_in.data());
 
-    auto dims     = g_in.mesh().dims();
-    auto dims_int = stdutil::make_std_array<int>(dims);
+    auto dims        = fft_dims(g_in.mesh().dims());
+    auto const &d_in = g_in.data();
+    auto &d_out      = g_out.data();
+    bool backward    = (fftw_backward_forward == FFTW_BACKWARD);
+    auto hi          = hermitian_indices(dims);
+    long n           = hi.opposite.size();
+
+    // real input : r2c from the real parts of the input, into the first hi.n_half rows of the output.
+    // Since hi.half[l] <= l, the rows are moved to their place from the last one, then the others follow by symmetry
+    if (max_element(abs(imag(d_in))) == 0) {
+      _fourier_base_r2c(d_in, d_out, dims.size(), dims.data(), n_others);
+      for (long l = n - 1; l >= 0; --l) {
+        long h = hi.half[l];
+        if (h < 0) continue;
+        for (long c = 0; c < n_others; ++c) d_out(l, c) = (backward ? std::conj(d_out(h, c)) : d_out(h, c));
+      }
+      _fourier_parallel_for(n, n_others, [&](long first, long last) {
+        for (long l = first; l < last; ++l)
+          if (hi.half[l] < 0)
+            for (long c = 0; c < n_others; ++c) d_out(l, c) = std::conj(d_out(hi.opposite[l], c));
+      });
+      return g_out;
+    }
+
+    // real output : c2r from the half of the input into the real parts of the output
+    if (is_hermitian(d_in, hi)) {
+      array<dcomplex, 2> y(hi.n_half, n_others);
+      for (long l = 0; l < n; ++l)
+        if (hi.half[l] >= 0)
+          for (long c = 0; c < n_others; ++c) y(hi.half[l], c) = (backward ? d_in(l, c) : std::conj(d_in(l, c)));
+      _fourier_base_c2r(y, d_out, dims.size(), dims.data(), n_others);
+      for (long l = 0; l < n; ++l)
+        for (long c = 0; c < n_others; ++c) d_out(l, c).imag(0);
+      return g_out;
+    }
 
-    _fourier_base(g_in.data(), g_out.data(), dims.size(), dims_int.data(), n_others, fftw_backward_forward);
+    auto dims_int = stdutil::make_std_array<int>(g_in.mesh().dims());
+    _fourier_base(g_in.data(), g_out.data(), dims_int.size(), dims_int.data(), n_others, fftw_backward_forward);
 
     return g_out;
   }
@@ -58,4 +146,100 @@ namespace triqs::gfs {
 
   gf_vec_t<mesh::brzone> _fourier_impl(mesh::brzone const &k_mesh, gf_vec_cvt<mesh::cyclat> gr) { return __impl(FFTW_BACKWARD, k_mesh, gr); }
 
+  // ------------------------ STRIDED TRANSFORMS --------------------------------------------
+
+  // One FFT of stride B repeated B times for each of the A blocks, with the same (cached) plan
+  void __impl_strided(int fftw_backward_forward, std::array<long, 3> const &dims, array_const_view<dcomplex, 3> in, array_view<dcomplex, 3> out) {
+    auto dims_int = stdutil::make_std_array<int>(dims);
+    auto _        = range::all;
+    for (long a = 0; a < in.extent(0); ++a)
+      _fourier_base(in(a, _, _), out(a, _, _), dims_int.size(), dims_int.data(), in.extent(2), fftw_backward_forward);
+  }
+
+  void _fourier_impl_strided(mesh::cyclat const &, mesh::brzone const &k_mesh, array_const_view<dcomplex, 3> gk, array_view<dcomplex, 3> gr) {
+    __impl_strided(FFTW_FORWARD, k_mesh.dims(), gk, gr);
+    gr /= k_mesh.size();
+  }
+
+  void _fourier_impl_strided(mesh::brzone const &, mesh::cyclat const &r_mesh, array_const_view<dcomplex, 3> gr, array_view<dcomplex, 3> gk) {
+    __impl_strided(FFTW_BACKWARD, r_mesh.dims(), gr, gk);
+  }
+
+  // ------------------------ DISTRIBUTED TRANSFORMS --------------------------------------------
+
+  namespace {
+
+    // First index of the chunk of [0, n) of each rank, as in mpi::scatter, and the end of the last chunk
+    std::vector<long> chunk_firsts(long n, int n_ranks) {
+      std::vector<long> r(n_ranks + 1);
+      for (int p = 0; p < n_ranks; ++p) r[p] = itertools::chunk_range(0, n, n_ranks, p).first;
+      r[n_ranks] = n;
+      return r;
+    }
+
+  } // namespace
+
+  // The rows (lattice points) of the (M, B) data are distributed over the ranks. The columns are treated by batches :
+  // an all-to-all communication gives each rank all the rows of a chunk of the columns of the batch, which are transformed
+  // locally, and another one brings them back. The batches bound the temporary memory, and keep the MPI counts in int.
+  void __impl_distributed(int fftw_backward_forward, std::array<long, 3> const &dims, array_view<dcomplex, 2> g, mpi::communicator c) {
+    auto dims_int = stdutil::make_std_array<int>(dims);
+    long M = dims[0] * dims[1] * dims[2], B = second_dim(g);
+    int P = c.size(), me = c.rank();
+
+    if (P == 1) {
+      _fourier_base(g, g, dims_int.size(), dims_int.data(), B, fftw_backward_forward);
+      return;
+    }
+
+    auto rows         = chunk_firsts(M, P);
+    long n_rows       = rows[me + 1] - rows[me];
+    long max_rows     = M / P + 1;
+    constexpr long mx = std::numeric_limits<int>::max();
+    if (M >= mx / 2) TRIQS_RUNTIME_ERROR << "Distributed Fourier : too many lattice points " << M;
+    long batch = std::max(1l, std::min({B, mx / max_rows, P * (mx / M - 1)}));
+
+    std::vector<int> send_counts(P), send_displs(P), recv_counts(P), recv_displs(P);
+    for (long b0 = 0; b0 < B; b0 += batch) {
+      long nb   = std::min(batch, B - b0);
+      auto cols = chunk_firsts(nb, P);
+      long n_cols = cols[me + 1] - cols[me];
+
+      // the local rows, packed by destination rank : its columns, row by row
+      array<dcomplex, 1> packed(n_rows * nb);
+      for (int p = 0; p < P; ++p) {
+        long n_cols_p  = cols[p + 1] - cols[p];
+        send_counts[p] = n_rows * n_cols_p;
+        send_displs[p] = n_rows * cols[p];
+        recv_counts[p] = (rows[p + 1] - rows[p]) * n_cols;
+        recv_displs[p] = rows[p] * n_cols;
+        for (long i = 0; i < n_rows; ++i)
+          for (long j = 0; j < n_cols_p; ++j) packed(send_displs[p] + i * n_cols_p + j) = g(i, b0 + cols[p] + j);
+      }
+
+      // all the rows of the local columns
+      array<dcomplex, 2> x(M, n_cols);
+      MPI_Alltoallv(packed.data(), send_counts.data(), send_displs.data(), MPI_C_DOUBLE_COMPLEX, x.data(), recv_counts.data(), recv_displs.data(),
+                    MPI_C_DOUBLE_COMPLEX, c.get());
+      if (n_cols > 0) _fourier_base(x, x, dims_int.size(), dims_int.data(), n_cols, fftw_backward_forward);
+      MPI_Alltoallv(x.data(), recv_counts.data(), recv_displs.data(), MPI_C_DOUBLE_COMPLEX, packed.data(), send_counts.data(), send_displs.data(),
+                    MPI_C_DOUBLE_COMPLEX, c.get());
+
+      for (int p = 0; p < P; ++p) {
+        long n_cols_p = cols[p + 1] - cols[p];
+        for (long i = 0; i < n_rows; ++i)
+          for (long j = 0; j < n_cols_p; ++j) g(i, b0 + cols[p] + j) = packed(send_displs[p] + i * n_cols_p + j);
+      }
+    }
+  }
+
+  void _fourier_impl_distributed(mesh::cyclat const &, mesh::brzone const &k_mesh, array_view<dcomplex, 2> g, mpi::communicator c) {
+    __impl_distributed(FFTW_FORWARD, k_mesh.dims(), g, c);
+    g /= k_mesh.size();
+  }
+
+  void _fourier_impl_distributed(mesh::brzone const &, mesh::cyclat const &r_mesh, array_view<dcomplex, 2> g, mpi::communicator c) {
+    __impl_distributed(FFTW_BACKWARD, r_mesh.dims(), g, c);
+  }
+
 } // namespace triqs::gfs
@@ -32,6 +32,60 @@ namespace triqs::gfs {
     template <typename A> auto oneBoson(A &&a, double b, double tau, double beta) {
       return a * (b >= 0 ? exp(-b * tau) / (exp(-beta * b) - 1) : exp(b * (beta - tau)) / (1 - exp(b * beta)));
     }
+
+    // For each tau of the mesh : exp(i pi tau / beta), and the coefficients c_k(tau) of the tail,
+    // oneFermion(a_k, b_k, tau, beta) = a_k c_k(tau) (resp. oneBoson)
+    struct tail_coefficients {
+      std::vector<dcomplex> phase;
+      std::vector<double> c1, c2, c3;
+
+      tail_coefficients(mesh::imtime const &tau_mesh, bool is_fermion, double b1, double b2, double b3)
+         : phase(tau_mesh.size()), c1(tau_mesh.size()), c2(tau_mesh.size()), c3(tau_mesh.size()) {
+        double beta     = tau_mesh.beta();
+        dcomplex iomega = M_PI * 1i / beta;
+        for (auto t : tau_mesh) {
+          auto i   = t.index();
+          phase[i] = exp(iomega * t);
+          if (is_fermion) {
+            c1[i] = oneFermion(1.0, b1, t, beta), c2[i] = oneFermion(1.0, b2, t, beta), c3[i] = oneFermion(1.0, b3, t, beta);
+          } else {
+            c1[i] = oneBoson(1.0, b1, t, beta), c2[i] = oneBoson(1.0, b2, t, beta), c3[i] = oneBoson(1.0, b3, t, beta);
+          }
+        }
+      }
+    };
+
+    // For each frequency of the mesh (by data index) : its row in the FFT array of size L, the row of the opposite frequency
+    // (-omega_n is omega_{-n-1} for fermions), and the poles 1 / (iw - b_k) of the tail
+    struct tail_poles {
+      std::vector<long> rows, mirror_rows;
+      std::vector<dcomplex> p1, p2, p3;
+
+      tail_poles(mesh::imfreq const &iw_mesh, long L, double b1, double b2, double b3)
+         : rows(iw_mesh.size()), mirror_rows(iw_mesh.size()), p1(iw_mesh.size()), p2(iw_mesh.size()), p3(iw_mesh.size()) {
+        bool is_fermion = (iw_mesh.statistic() == Fermion);
+        for (auto iw : iw_mesh) {
+          auto i         = iw.data_index();
+          rows[i]        = (iw.n + L) % L;
+          mirror_rows[i] = ((is_fermion ? -iw.n - 1 : -iw.n) % L + L) % L;
+          p1[i] = 1.0 / (iw - b1), p2[i] = 1.0 / (iw - b2), p3[i] = 1.0 / (iw - b3);
+        }
+      }
+    };
+
+    // Are all the elements of the arrays real ?
+    template <typename... A> bool are_real(A const &...a) { return ((max_element(abs(imag(a))) == 0) and ...); }
+
+    // Is G(-i omega_n) = conj(G(i omega_n)) on a full mesh, up to the tolerance relative to the largest element ?
+    // NB : the data index of -i omega_n is n_iw - 1 - i for both statistics.
+    bool is_real_in_tau(array_const_view<dcomplex, 2> g, double tolerance = 1.e-13) {
+      double eps = tolerance * max_element(abs(g));
+      long n_iw  = first_dim(g);
+      for (long i = 0; i < n_iw; ++i)
+        for (long c = 0; c < second_dim(g); ++c)
+          if (std::abs(g(n_iw - 1 - i, c) - std::conj(g(i, c))) > eps) return false;
+      return true;
+    }
   } // namespace
 
   //-------------------------------------
@@ -134,12 +188,8 @@ namespace triqs::gfs {
 
     long n_others = second_dim(gt.data());
 
-    array<dcomplex, 2> _gout(L, n_others); // FIXME Why do we need this dimension to be one less than gt.mesh().size() ?
-    array<dcomplex, 2> _gin(L + 1, n_others);
-
     bool is_fermion = (iw_mesh.statistic() == Fermion);
     double fact     = beta / L;
-    dcomplex iomega = M_PI * 1i / beta;
 
     double b1, b2, b3;
     array<dcomplex, 1> a1, a2, a3;
@@ -155,11 +205,6 @@ namespace triqs::gfs {
       a1 = m1 - m3;
       a2 = (m2 + m3) / 2;
       a3 = (m3 - m2) / 2;
-
-      for (auto t : gt.mesh())
-        _gin(t.index(), _) =
-           fact * exp(iomega * t) * (gt[t] - (oneFermion(a1, b1, t, beta) + oneFermion(a2, b2, t, beta) + oneFermion(a3, b3, t, beta)));
-
     } else {
       b1 = -0.5;
       b2 = -1;
@@ -167,20 +212,58 @@ namespace triqs::gfs {
       a1 = 4 * (m1 - m3) / 3;
       a2 = m3 - (m1 + m2) / 2;
       a3 = m1 / 6 + m2 / 2 + m3 / 3;
-
-      for (auto t : gt.mesh())
-        _gin(t.index(), _) = fact * (gt[t] - (oneBoson(a1, b1, t, beta) + oneBoson(a2, b2, t, beta) + oneBoson(a3, b3, t, beta)));
     }
 
+    // For a real G(tau) (and real moments), the columns c and c + n_fft are transformed at once as x + i y, and separated
+    // using that the transform of a real function satisfies G(-i omega_n) = conj(G(i omega_n)) : this halves the FFT.
+    auto const &gt_data = gt.data();
+    bool real_data      = are_real(gt_data, a1, a2, a3);
+    long n_fft          = (real_data ? (n_others + 1) / 2 : n_others);
+
+    array<dcomplex, 2> _gout(L, n_fft); // FIXME Why do we need this dimension to be one less than gt.mesh().size() ?
+    array<dcomplex, 2> _gin(L + 1, n_fft);
+
+    // The tail subtraction, with the tau dependence computed once for all target indices
+    auto tc = tail_coefficients(gt.mesh(), is_fermion, b1, b2, b3);
+    for (auto &ph : tc.phase) ph = fact * (is_fermion ? ph : dcomplex{1});
+    _fourier_parallel_for(n_fft, L + 1, [&](long first, long last) {
+      for (long i = 0; i <= L; ++i) {
+        auto ph = tc.phase[i];
+        auto c1 = tc.c1[i], c2 = tc.c2[i], c3 = tc.c3[i];
+        auto f  = [&](long c) { return gt_data(i, c) - (a1(c) * c1 + a2(c) * c2 + a3(c) * c3); };
+        if (real_data)
+          for (long c = first; c < last; ++c) _gin(i, c) = ph * dcomplex{real(f(c)), (c + n_fft < n_others ? real(f(c + n_fft)) : 0.0)};
+        else
+          for (long c = first; c < last; ++c) _gin(i, c) = ph * f(c);
+      }
+    });
+
     int dims[] = {int(L)};
-    _fourier_base(_gin, _gout, 1, dims, n_others, FFTW_BACKWARD);
+    _fourier_base(_gin, _gout, 1, dims, n_fft, FFTW_BACKWARD);
 
     auto gw = gf_vec_t<imfreq>{iw_mesh, {n_others}};
 
     // Correction term to account for proper Trapezoidal integration
-    // FIXME Avoid copy, by doing proper in-place operation
-    auto corr = -0.5 * fact * (gt[0] + m1 + (is_fermion ? 1 : -1) * gt[L]);
-    for (auto iw : iw_mesh) gw[iw] = _gout((iw.n + L) % L, _) + corr + a1 / (iw - b1) + a2 / (iw - b2) + a3 / (iw - b3);
+    array<dcomplex, 1> corr = -0.5 * fact * (gt[0] + m1 + (is_fermion ? 1 : -1) * gt[L]);
+
+    // Reassembly with the tail, with the frequency dependence computed once for all target indices
+    auto tp       = tail_poles(iw_mesh, L, b1, b2, b3);
+    auto &gw_data = gw.data();
+    _fourier_parallel_for(n_fft, iw_mesh.size(), [&](long first, long last) {
+      for (long i = 0; i < iw_mesh.size(); ++i) {
+        auto r = tp.rows[i], rm = tp.mirror_rows[i];
+        auto p1 = tp.p1[i], p2 = tp.p2[i], p3 = tp.p3[i];
+        auto f  = [&](long c, dcomplex g) { return g + corr(c) + a1(c) * p1 + a2(c) * p2 + a3(c) * p3; };
+        if (real_data)
+          for (long c = first; c < last; ++c) {
+            auto z = _gout(r, c), zm = std::conj(_gout(rm, c));
+            gw_data(i, c) = f(c, 0.5 * (z + zm));
+            if (c + n_fft < n_others) gw_data(i, c + n_fft) = f(c + n_fft, -0.5i * (z - zm));
+          }
+        else
+          for (long c = first; c < last; ++c) gw_data(i, c) = f(c, _gout(r, c));
+      }
+    });
 
     return gw;
   }
@@ -189,7 +272,8 @@ namespace triqs::gfs {
 
   gf_vec_t<imtime> _fourier_impl(mesh::imtime const &tau_mesh, gf_vec_cvt<imfreq> gw, nda::array_const_view<dcomplex, 2> known_moments) {
 
-    TRIQS_ASSERT2(!gw.mesh().positive_only(), "Fourier is only implemented for g(i omega_n) with full mesh (positive and negative frequencies)");
+    TRIQS_ASSERT2(!gw.mesh().positive_only() or known_moments.shape()[0] >= 4,
+                  "Fourier of g(i omega_n) on a positive-only mesh requires the high-frequency moments up to order 3");
 
     nda::array_const_view<dcomplex, 2> tail;
 
@@ -221,12 +305,8 @@ namespace triqs::gfs {
 
     long n_others = second_dim(gw.data());
 
-    array<dcomplex, 2> _gin(L, n_others); // FIXME Why do we need this dimension to be one less than gt.mesh().size() ?
-    array<dcomplex, 2> _gout(L + 1, n_others);
-
     bool is_fermion = (gw.mesh().statistic() == Fermion);
     double fact     = 1.0 / beta;
-    dcomplex iomega = M_PI * 1i / beta;
 
     double b1, b2, b3;
     array<dcomplex, 1> a1, a2, a3;
@@ -251,18 +331,60 @@ namespace triqs::gfs {
       a3 = m1 / 6 + m2 / 2 + m3 / 3;
     }
 
-    for (auto iw : gw.mesh()) _gin((iw.n + L) % L, _) = fact * (gw[iw] - (a1 / (iw - b1) + a2 / (iw - b2) + a3 / (iw - b3)));
+    // If G(tau) is real, i.e. G(-i omega_n) = conj(G(i omega_n)) (always assumed for a positive-only mesh) and the moments are real,
+    // the columns c and c + n_fft are transformed at once as x + i y : the real and imaginary parts of the result are x(tau) and y(tau).
+    // The negative frequencies of a positive-only mesh are given by the symmetry.
+    auto const &gw_data = gw.data();
+    auto tp             = tail_poles(gw.mesh(), L, b1, b2, b3);
+    bool positive_only  = gw.mesh().positive_only();
+    bool real_out       = are_real(a1, a2, a3) and (positive_only or is_real_in_tau(gw_data));
+    if (positive_only and not real_out) TRIQS_RUNTIME_ERROR << "Fourier of g(i omega_n) on a positive-only mesh requires real high-frequency moments";
+    long n_fft = (real_out ? (n_others + 1) / 2 : n_others);
+
+    array<dcomplex, 2> _gin(L, n_fft); // FIXME Why do we need this dimension to be one less than gt.mesh().size() ?
+    array<dcomplex, 2> _gout(L + 1, n_fft);
+
+    // The tail subtraction, with the frequency dependence computed once for all target indices
+    _fourier_parallel_for(n_fft, gw.mesh().size(), [&](long first, long last) {
+      for (long i = 0; i < gw.mesh().size(); ++i) {
+        auto r = tp.rows[i], rm = tp.mirror_rows[i];
+        auto p1 = tp.p1[i], p2 = tp.p2[i], p3 = tp.p3[i];
+        auto f  = [&](long c) { return fact * (gw_data(i, c) - (a1(c) * p1 + a2(c) * p2 + a3(c) * p3)); };
+        if (real_out)
+          for (long c = first; c < last; ++c) {
+            auto x = f(c), y = (c + n_fft < n_others ? f(c + n_fft) : 0.0);
+            _gin(r, c) = x + 1i * y;
+            if (positive_only) _gin(rm, c) = std::conj(x) + 1i * std::conj(y);
+          }
+        else
+          for (long c = first; c < last; ++c) _gin(r, c) = f(c);
+      }
+    });
 
     int dims[] = {int(L)};
-    _fourier_base(_gin, _gout, 1, dims, n_others, FFTW_FORWARD);
+    _fourier_base(_gin, _gout, 1, dims, n_fft, FFTW_FORWARD);
 
     auto gt = gf_vec_t<imtime>{tau_mesh, {n_others}};
 
-    if (is_fermion)
-      for (auto t : tau_mesh)
-        gt[t] = _gout(t.index(), _) * exp(-iomega * t) + oneFermion(a1, b1, t, beta) + oneFermion(a2, b2, t, beta) + oneFermion(a3, b3, t, beta);
-    else
-      for (auto t : tau_mesh) gt[t] = _gout(t.index(), _) + oneBoson(a1, b1, t, beta) + oneBoson(a2, b2, t, beta) + oneBoson(a3, b3, t, beta);
+    // Reassembly with the tail, with the tau dependence computed once for all target indices
+    auto tc = tail_coefficients(tau_mesh, is_fermion, b1, b2, b3);
+    for (auto &ph : tc.phase) ph = (is_fermion ? std::conj(ph) : dcomplex{1});
+    auto &gt_data = gt.data();
+    _fourier_parallel_for(n_fft, L + 1, [&](long first, long last) {
+      for (long i = 0; i <= L; ++i) {
+        auto ph = tc.phase[i];
+        auto c1 = tc.c1[i], c2 = tc.c2[i], c3 = tc.c3[i];
+        auto f  = [&](long c, dcomplex g) { return g + a1(c) * c1 + a2(c) * c2 + a3(c) * c3; };
+        if (real_out)
+          for (long c = first; c < last; ++c) {
+            auto z        = _gout(i, c) * ph;
+            gt_data(i, c) = f(c, z.real());
+            if (c + n_fft < n_others) gt_data(i, c + n_fft) = f(c + n_fft, z.imag());
+          }
+        else
+          for (long c = first; c < last; ++c) gt_data(i, c) = f(c, _gout(i, c) * ph);
+      }
+    });
 
     double pm = (is_fermion ? -1 : 1);
     gt[L]     = pm * (gt[0] + m1);
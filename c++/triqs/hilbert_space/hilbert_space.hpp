@@ -210,6 +210,16 @@ namespace triqs {
  */
       int get_state_index(fock_state_t f) const { return fock_to_index.find(f)->second; }
 
+      /// Find the index of a given Fock state within this subspace, if it belongs to it
+      /**
+   @param f Fock state in question
+   @return State index, or -1 if `f` does not belong to the subspace
+ */
+      int find_state_index(fock_state_t f) const {
+        auto it = fock_to_index.find(f);
+        return (it == fock_to_index.end() ? -1 : it->second);
+      }
+
       /// Check if a given Fock state belongs to this subspace
       /**
    @param f Fock state in question
@@ -228,6 +228,53 @@ namespace triqs {
         }
         return target_st;
       }
+
+      /// Enumerate the matrix elements of the operator between two subspaces
+      /**
+   Calls `f(i, j, x)` for each nonzero contribution `x` of a monomial to the matrix element
+   :math:`\langle to_j | op | from_i \rangle` between the Fock states of the subspaces (COO triplets, the contributions of
+   several monomials to the same element are to be summed). The Fock states reached outside of `to` are dropped.
+
+   The masks of the monomials act directly on the Fock states: no state is built, and no amplitude is looked up.
+
+   @tparam F Type of the callable object
+   @param from Initial subspace
+   @param to Final subspace
+   @param f Callable object, taking the indices of the initial and final Fock states and a `ScalarType`
+  */
+      template <typename F> void for_each_matrix_element(sub_hilbert_space const &from, sub_hilbert_space const &to, F &&f) const {
+        for (int i = 0; i < from.size(); ++i) {
+          fock_state_t f1 = from.get_fock_state(i);
+          for (auto const &M : all_terms) {
+            if ((f1 & M.d_mask) != M.d_mask) continue;
+            fock_state_t f2 = f1 & ~M.d_mask;
+            if (((f2 ^ M.dag_mask) & M.dag_mask) != M.dag_mask) continue;
+            fock_state_t f3 = f2 | M.dag_mask;
+            int j           = to.find_state_index(f3);
+            if (j < 0) continue;
+            auto sign_is_minus = parity_number_of_bits((f2 & M.d_count_mask) ^ (f3 & M.dag_count_mask));
+            f(i, j, (sign_is_minus ? -M.coeff : M.coeff));
+          }
+        }
+      }
+
+      /// The diagonal matrix element of the operator on a Fock state
+      /**
+   Returns :math:`\langle f | op | f \rangle`, computed on the masks of the monomials as in `for_each_matrix_element`.
+   Only the monomials which create and annihilate the same set of fermions contribute.
+
+   @param f Fock state
+  */
+      scalar_t diagonal_element(fock_state_t f) const {
+        scalar_t r = 0;
+        for (auto const &M : all_terms) {
+          if (M.d_mask != M.dag_mask or (f & M.d_mask) != M.d_mask) continue;
+          fock_state_t f2    = f & ~M.d_mask;
+          auto sign_is_minus = parity_number_of_bits((f2 & M.d_count_mask) ^ (f & M.dag_count_mask));
+          r += (sign_is_minus ? -M.coeff : M.coeff);
+        }
+        return r;
+      }
     };
   } // namespace hilbert_space
 } // namespace triqs
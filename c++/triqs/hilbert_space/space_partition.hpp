@@ -20,11 +20,15 @@
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
 #include <set>
-#include <map>
+#include <thread>
 #include <utility>
+#include <vector>
 #include <triqs/utility/numeric_ops.hpp>
-#include <boost/pending/disjoint_sets.hpp>
 
 namespace triqs {
   namespace hilbert_space {
@@ -36,6 +40,9 @@ namespace triqs {
   For a detailed description of the algorithm see
   `Computer Physics Communications 200, March 2016, 274-284 <http://dx.doi.org/10.1016/j.cpc.2015.10.023>`_ (section 4.2).
 
+  The sweeps over the basis states can be split over several threads: the subspaces are then merged concurrently,
+  in a lock-free union-find structure, and the results do not depend on the number of threads.
+
   @tparam StateType Many-body state type, must model [[statevector_concept]]
   @tparam OperatorType Imperative operator type, must provide `StateType operator()(StateType const&)`
  */
@@ -52,8 +59,8 @@ namespace triqs {
       using amplitude_t = typename state_t::value_type;
       /// Connections between subspaces represented as a set of (from-index,to-index) pair
       using block_mapping_t = std::set<std::pair<idx_t, idx_t>>;
-      /// Non-zero matrix elements of an operator represented as a mapping (from-state,to-state) -> value
-      using matrix_element_map_t = std::map<std::pair<idx_t, idx_t>, typename state_t::value_type>;
+      /// Non-zero matrix elements of an operator represented as a list of ((from-state,to-state), value), sorted by (from-state,to-state)
+      using matrix_element_map_t = std::vector<std::pair<std::pair<idx_t, idx_t>, amplitude_t>>;
 
       /// Perform Phase I of the automatic partition algorithm
       /**
@@ -63,40 +70,39 @@ namespace triqs {
    @param H Hamiltonian as an imperative operator
    @param store_matrix_elements Should we store the non-vanishing matrix elements of the Hamiltonian?
    @param H Hyb as an additionnal optional imperative operator
+   @param n_threads Number of threads for the sweeps over the basis states, here and in `merge_subspaces` and `find_mappings`
   */
-      space_partition(state_t const &st, operator_t const &H, bool store_matrix_elements = true, operator_t const &Hyb = operator_t())
-         : tmp_state(make_zero_state(st)), subspaces(st.size()) {
-        auto size = tmp_state.size();
+      space_partition(state_t const &st, operator_t const &H, bool store_matrix_elements = true, operator_t const &Hyb = operator_t(),
+                      int n_threads = 1)
+         : tmp_state(make_zero_state(st)), subspaces(st.size()), n_threads(std::max(n_threads, 1)) {
 
-        // Iteration over all initial basis states
-        for (idx_t i = 0; i < size; ++i) {
-          tmp_state(i)        = amplitude_t(1);
-          state_t final_state = H(tmp_state);
+        std::vector<matrix_element_map_t> elements(this->n_threads);
 
+        // Iteration over all initial basis states
+        sweep([&](int thread, idx_t i, state_t const &initial_state) {
+          auto first = elements[thread].size();
           auto mapping = [&](idx_t f, amplitude_t amplitude) {
             using triqs::utility::is_zero;
             if (is_zero(amplitude)) return;
-            auto i_subspace = subspaces.find_set(i);
-            auto f_subspace = subspaces.find_set(f);
-            if (i_subspace != f_subspace) subspaces.link(i_subspace, f_subspace);
-
-            if (store_matrix_elements) matrix_elements[std::make_pair(i, f)] = amplitude;
+            subspaces.unite(i, f);
+            if (store_matrix_elements) elements[thread].push_back({{i, f}, amplitude});
           };
 
           // Iterate over non-zero final amplitudes
-          foreach (final_state, mapping)
+          foreach (H(initial_state), mapping)
             ;
 
           // redo for additionnal Hyb
           if (not Hyb.is_empty()) {
-            final_state = Hyb(tmp_state);
-            foreach (final_state, mapping)
+            foreach (Hyb(initial_state), mapping)
               ;
           }
 
-          tmp_state(i) = amplitude_t(0.);
-        }
+          // The elements of Hyb replace those of H
+          if (store_matrix_elements) sort_elements(elements[thread], first);
+        });
 
+        if (store_matrix_elements) matrix_elements = concat(std::move(elements));
         _update_index();
       }
 
@@ -116,83 +122,75 @@ namespace triqs {
       std::pair<matrix_element_map_t, matrix_element_map_t> merge_subspaces(operator_t const &Cd, operator_t const &C,
                                                                             bool store_matrix_elements = true) {
 
-        matrix_element_map_t Cd_elements, C_elements;
-        std::multimap<idx_t, idx_t> Cd_connections, C_connections;
+        using connections_t = std::vector<std::pair<idx_t, idx_t>>;
+        std::vector<matrix_element_map_t> Cd_elements(n_threads), C_elements(n_threads);
+        std::vector<connections_t> Cd_conn(n_threads), C_conn(n_threads);
 
-        auto size = tmp_state.size();
+        // Fill connection lists
+        sweep([&](int thread, idx_t i, state_t const &initial_state) {
+          auto i_subspace = subspaces.find(i);
 
-        // Fill connection multimaps
-        for (idx_t i = 0; i < size; ++i) {
-          tmp_state(i)    = amplitude_t(1);
-          auto i_subspace = subspaces.find_set(i);
-
-          auto fill_conn = [this, i, i_subspace, store_matrix_elements](operator_t const &op, std::multimap<idx_t, idx_t> &conn,
-                                                                        matrix_element_map_t &elem) {
-            state_t final_state = op(tmp_state);
+          auto fill_conn = [&](operator_t const &op, connections_t &conn, matrix_element_map_t &elem) {
+            auto first = elem.size();
             // Iterate over non-zero final amplitudes
-            foreach (final_state, [&](idx_t f, amplitude_t amplitude) {
+            foreach (op(initial_state), [&](idx_t f, amplitude_t amplitude) {
               using triqs::utility::is_zero;
               if (is_zero(amplitude)) return;
-              auto f_subspace = subspaces.find_set(f);
-              conn.insert({i_subspace, f_subspace});
-              if (store_matrix_elements) elem[{i, f}] = amplitude;
+              conn.emplace_back(i_subspace, subspaces.find(f));
+              if (store_matrix_elements) elem.push_back({{i, f}, amplitude});
             })
               ;
+            if (store_matrix_elements) sort_elements(elem, first);
           };
 
-          fill_conn(Cd, Cd_connections, Cd_elements);
-          fill_conn(C, C_connections, C_elements);
+          fill_conn(Cd, Cd_conn[thread], Cd_elements[thread]);
+          fill_conn(C, C_conn[thread], C_elements[thread]);
+        });
 
-          tmp_state(i) = amplitude_t(0.);
-        }
+        // Connections between subspaces, sorted by initial subspace, each of them to be visited once
+        auto Cd_connections = connection_list(std::move(Cd_conn));
+        auto C_connections  = connection_list(std::move(C_conn));
 
         // 'Zigzag' traversal algorithm
-        while (!Cd_connections.empty()) {
+        for (idx_t lower_subspace = 0; lower_subspace < Cd_connections.n_from(); ++lower_subspace) {
 
           // Take one C^+ - connection
           // C^+|lower_subspace> = |upper_subspace>
-          idx_t lower_subspace, upper_subspace;
-          std::tie(lower_subspace, upper_subspace) = *std::begin(Cd_connections);
+          auto [upper_subspace, found] = Cd_connections.next(lower_subspace);
+          if (not found) continue;
 
           // - Reveals all subspaces reachable from lower_subspace by application of
           //   a 'zigzag' product C^+ C C^+ C C^+ ... of any length.
           // - Removes all visited connections from Cd_connections/C_connections.
           // - Merges lower_subspace with all subspaces generated from lower_subspace by application of (C C^+)^(2*n).
           // - Merges upper_subspace with all subspaces generated from upper_subspace by application of (C^+ C)^(2*n).
-          std::function<void(idx_t, bool)> zigzag_traversal = [this, lower_subspace, upper_subspace, &Cd_connections, &C_connections,
-                                                               &zigzag_traversal](idx_t i_subspace, // find all connections starting from i_subspace
-                                                                                  bool upwards      // if true, C^+ connection, otherwise C connection
-                                                              ) {
-            std::multimap<idx_t, idx_t>::iterator it;
-            while ((it = (upwards ? Cd_connections : C_connections).find(i_subspace)) != (upwards ? Cd_connections : C_connections).end()) {
-
-              auto f_subspace = it->second;
-              (upwards ? Cd_connections : C_connections).erase(it);
-
-              if (upwards)
-                subspaces.link(f_subspace, upper_subspace);
-              else
-                subspaces.link(f_subspace, lower_subspace);
-
-              // Recursively apply to all found f_subspace's with a 'flipped' direction
-              zigzag_traversal(f_subspace, !upwards);
+          // The subspaces to visit are kept in a stack of (subspace, upwards), upwards = true for the C^+ connections, otherwise C connections
+          std::vector<std::pair<idx_t, bool>> to_visit{{lower_subspace, true}, {upper_subspace, false}};
+          while (not to_visit.empty()) {
+            auto [i_subspace, upwards] = to_visit.back();
+            to_visit.pop_back();
+            auto &connections = (upwards ? Cd_connections : C_connections);
+            while (true) {
+              auto [f_subspace, found_f] = connections.next(i_subspace);
+              if (not found_f) break;
+              subspaces.unite(f_subspace, upwards ? upper_subspace : lower_subspace);
+              // Apply to all found f_subspace's with a 'flipped' direction
+              to_visit.emplace_back(f_subspace, !upwards);
             }
-          };
-
-          // Apply to all C^+ connections starting from lower_subspace
-          zigzag_traversal(lower_subspace, true);
+          }
         }
 
         _update_index();
 
-        return std::make_pair(Cd_elements, C_elements);
+        if (not store_matrix_elements) return {};
+        return std::make_pair(concat(std::move(Cd_elements)), concat(std::move(C_elements)));
       }
 
       /// Return the number of subspaces in the partition
       /**
    @return Number of invariant subspaces
   */
-      idx_t n_subspaces() const { return representative_to_index.size(); }
+      idx_t n_subspaces() const { return _n_subspaces; }
 
       /// Apply a callable object to all basis Fock states in a given space partition
       /**
@@ -212,7 +210,7 @@ namespace triqs {
    @param basis_state Index of a basis Fock state
    @return Index of the found invariant subspace
   */
-      idx_t lookup_basis_state(idx_t basis_state) { return representative_to_index[subspaces.find_set(basis_state)]; }
+      idx_t lookup_basis_state(idx_t basis_state) { return representative_to_index[subspaces.find(basis_state)]; }
 
       /// Access to matrix elements of the Hamiltonian
       /**
@@ -228,51 +226,164 @@ namespace triqs {
   */
       block_mapping_t find_mappings(operator_t const &op, bool diagonal_only = false) {
 
-        block_mapping_t mapping;
+        std::vector<block_mapping_t> mappings(n_threads);
 
         // Iteration over all initial basis states
-        for (idx_t i = 0; i < tmp_state.size(); ++i) {
-          state_t initial_state = tmp_state;
-          initial_state(i)      = amplitude_t(1);
-          auto i_subspace       = subspaces.find_set(i);
-
-          state_t final_state = op(initial_state);
+        sweep([&](int thread, idx_t i, state_t const &initial_state) {
+          auto i_subspace = subspaces.find(i);
 
           // Iterate over non-zero final amplitudes
-          foreach (final_state, [&](idx_t f, amplitude_t amplitude) {
+          foreach (op(initial_state), [&](idx_t f, amplitude_t amplitude) {
             using triqs::utility::is_zero;
             if (is_zero(amplitude)) return;
-            auto f_subspace = subspaces.find_set(f);
+            auto f_subspace = subspaces.find(f);
             if ((!diagonal_only) || i_subspace == f_subspace)
-              mapping.insert(std::make_pair(representative_to_index[i_subspace], representative_to_index[f_subspace]));
+              mappings[thread].insert(std::make_pair(representative_to_index[i_subspace], representative_to_index[f_subspace]));
           })
             ;
-        }
+        });
 
+        block_mapping_t mapping;
+        for (auto &m : mappings) mapping.merge(m);
         return mapping;
       }
 
       private:
-      void _update_index() {
-        auto p = subspaces.parents();
-        subspaces.compress_sets(p.begin(), p.end());  // parents are representatives
-        subspaces.normalize_sets(p.begin(), p.end()); // the representative has the smallest index in the set
-
-        // Update representative_to_index
-        representative_to_index.clear();
-        for (idx_t n = 0; n < tmp_state.size(); ++n) {
-          representative_to_index.insert(std::make_pair(subspaces.find_set(n), representative_to_index.size()));
+      // Union-find structure on the basis states, safe for concurrent unite and find.
+      // The larger root is always linked under the smaller one, so that the parent of a state is never larger than the state :
+      // the representative of a set is its smallest element, and the links are done with a single compare-and-swap.
+      class disjoint_sets {
+        std::unique_ptr<std::atomic<idx_t>[]> parent;
+        idx_t size = 0;
+
+        public:
+        disjoint_sets(idx_t size) : parent(new std::atomic<idx_t>[size]), size(size) {
+          for (idx_t n = 0; n < size; ++n) parent[n].store(n, std::memory_order_relaxed);
+        }
+        disjoint_sets(disjoint_sets const &x) : disjoint_sets(x.size) {
+          for (idx_t n = 0; n < size; ++n) parent[n].store(x.parent[n].load(std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+
+        // Representative, with path halving
+        idx_t find(idx_t n) const {
+          while (true) {
+            idx_t p = parent[n].load(std::memory_order_relaxed);
+            if (p == n) return n;
+            idx_t gp = parent[p].load(std::memory_order_relaxed);
+            if (gp != p) parent[n].compare_exchange_weak(p, gp, std::memory_order_relaxed);
+            n = gp;
+          }
         }
+
+        void unite(idx_t a, idx_t b) {
+          while (true) {
+            a = find(a);
+            b = find(b);
+            if (a == b) return;
+            if (a > b) std::swap(a, b);
+            if (parent[b].compare_exchange_strong(b, a, std::memory_order_relaxed)) return;
+          }
+        }
+
+        // Link all states to their representative
+        void compress() {
+          for (idx_t n = 0; n < size; ++n) parent[n].store(find(n), std::memory_order_relaxed);
+        }
+      };
+
+      // Connections between subspaces (from, to), sorted by initial subspace and deduplicated,
+      // with the next connection not yet visited from each subspace
+      struct connection_list {
+        std::vector<std::pair<idx_t, idx_t>> conn;
+        std::vector<std::size_t> cursor, end; // for each subspace, the positions in conn of the next connection and past the last one
+
+        connection_list(std::vector<std::vector<std::pair<idx_t, idx_t>>> parts) {
+          for (auto &p : parts) conn.insert(conn.end(), p.begin(), p.end());
+          std::sort(conn.begin(), conn.end());
+          conn.erase(std::unique(conn.begin(), conn.end()), conn.end());
+          idx_t n_keys = (conn.empty() ? 0 : conn.back().first + 1);
+          cursor.resize(n_keys);
+          end.resize(n_keys);
+          for (std::size_t l = 0, k = 0; k < n_keys; ++k) {
+            cursor[k] = l;
+            while (l < conn.size() and conn[l].first == k) ++l;
+            end[k] = l;
+          }
+        }
+
+        // Number of initial subspaces (bound on their indices)
+        idx_t n_from() const { return cursor.size(); }
+
+        // Visit the next connection from i, if any : (final subspace, true), or (_, false)
+        std::pair<idx_t, bool> next(idx_t i) {
+          if (i >= n_from() or cursor[i] == end[i]) return {0, false};
+          return {conn[cursor[i]++].second, true};
+        }
+      };
+
+      // Call f(thread, i, |i>) for all the basis states i, split in contiguous chunks over the threads
+      template <typename F> void sweep(F const &f) {
+        idx_t size    = tmp_state.size();
+        int n_workers = std::max<long>(1, std::min<long>(n_threads, size));
+        std::vector<std::exception_ptr> errors(n_workers);
+        auto work = [&, size](int thread) {
+          try {
+            state_t initial_state = tmp_state;
+            for (idx_t i = idx_t(long(size) * thread / n_workers); i < idx_t(long(size) * (thread + 1) / n_workers); ++i) {
+              initial_state(i) = amplitude_t(1);
+              f(thread, i, initial_state);
+              initial_state(i) = amplitude_t(0.);
+            }
+          } catch (...) { errors[thread] = std::current_exception(); }
+        };
+        std::vector<std::thread> threads;
+        for (int th = 1; th < n_workers; ++th) threads.emplace_back(work, th);
+        work(0);
+        for (auto &th : threads) th.join();
+        for (auto const &e : errors)
+          if (e) std::rethrow_exception(e);
+      }
+
+      // Sort the elements of a single initial state, from position first on, by final state.
+      // For repeated final states, the last element is kept.
+      static void sort_elements(matrix_element_map_t &elem, std::size_t first) {
+        auto by_final = [](auto const &x, auto const &y) { return x.first.second < y.first.second; };
+        std::stable_sort(elem.begin() + first, elem.end(), by_final);
+        auto out = elem.begin() + first;
+        for (auto it = out; it != elem.end(); ++it) {
+          if (std::next(it) != elem.end() and std::next(it)->first == it->first) continue;
+          *out++ = *it;
+        }
+        elem.erase(out, elem.end());
+      }
+
+      // The thread chunks are in order of initial state
+      static matrix_element_map_t concat(std::vector<matrix_element_map_t> parts) {
+        matrix_element_map_t r = std::move(parts[0]);
+        for (std::size_t k = 1; k < parts.size(); ++k) r.insert(r.end(), parts[k].begin(), parts[k].end());
+        return r;
+      }
+
+      void _update_index() {
+        subspaces.compress();
+        // The representatives, i.e. the smallest states of the subspaces, are indexed in increasing order
+        _n_subspaces = 0;
+        representative_to_index.assign(tmp_state.size(), 0);
+        for (idx_t n = 0; n < tmp_state.size(); ++n)
+          if (subspaces.find(n) == n) representative_to_index[n] = _n_subspaces++;
       }
 
       // Temporary zero state
       mutable state_t tmp_state;
       // Subspaces
-      boost::disjoint_sets_with_storage<> subspaces;
+      disjoint_sets subspaces;
+      // Number of threads in the sweeps over the basis states
+      int n_threads = 1;
       // Matrix elements of the Hamiltonian
       matrix_element_map_t matrix_elements;
       // Map representative basis state to subspace index
-      std::map<idx_t, idx_t> representative_to_index;
+      std::vector<idx_t> representative_to_index;
+      idx_t _n_subspaces = 0;
     };
   } // namespace hilbert_space
 } // namespace triqs
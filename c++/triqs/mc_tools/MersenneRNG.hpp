@@ -198,6 +198,7 @@ namespace triqs {
           uint32 x = (seed | 1U) & 0xFFFFFFFFU, *s = state;
           int j;
           left = 0;
+          next = state;
           for (*s++ = x, j = N; --j; *s++ = (x *= 69069U) & 0xFFFFFFFFU)
             ;
         }
@@ -221,6 +222,20 @@ namespace triqs {
         //  inline double operator()() {
         //    return ((double)(randomMT())/0xFFFFFFFFU);
         //   }
+
+        // Write/read the full state of the generator (e.g. for a checkpoint, cf random_generator::get_state)
+        friend std::ostream &operator<<(std::ostream &os, RandMT const &g) {
+          os << g.seed_save << ' ' << g.initseed << ' ' << g.left << ' ' << (g.next - g.state);
+          for (int j = 0; j < N; ++j) os << ' ' << g.state[j];
+          return os;
+        }
+        friend std::istream &operator>>(std::istream &is, RandMT &g) {
+          long pos = 0;
+          is >> g.seed_save >> g.initseed >> g.left >> pos;
+          for (int j = 0; j < N; ++j) is >> g.state[j];
+          g.next = g.state + pos;
+          return is;
+        }
       };
 
     } // namespace RandomGenerators
@@ -0,0 +1,121 @@
+// Copyright (c) 2026 Simons Foundation
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You may obtain a copy of the License at
+//     https://www.gnu.org/licenses/gpl-3.0.txt
+
+#pragma once
+#include <mpi/mpi.hpp>
+#include <array>
+#include <cstdint>
+
+namespace triqs::mc_tools {
+
+  /**
+   * Agreement of all ranks of a communicator on a common stop of a Monte Carlo run, without blocking.
+   *
+   * Each rank calls update after each cycle, with its number of cycles done and whether it requests a stop
+   * (e.g. time limit or signal), and optionally whether its target error is reached. In the background of the cycles,
+   * rounds of non-blocking all-reduce sum (number of cycles, number of stop requests, number of converged ranks) over the ranks.
+   * A round is started as soon as the previous one is done.
+   * All ranks get the same result for a round, hence they all decide to stop after the same round:
+   * when a rank requested a stop, when the total number of cycles reaches the target, or when all ranks have converged.
+   *
+   * Before leaving the run loop for any other reason (e.g. exception), finalize must be called:
+   * it completes the rounds with a stop request, so that no rank waits forever for the others.
+   */
+  class collective_stop {
+    mpi::communicator comm;
+    int64_t n_target;
+    std::array<int64_t, 3> send = {0, 0, 0}, recv = {0, 0, 0};
+    MPI_Request req    = MPI_REQUEST_NULL;
+    bool agreed        = false;
+    bool target_reach  = false;
+    bool all_converged = false;
+    int64_t n_total    = 0;
+
+    // Take the decision from the result of the last round
+    void decide() {
+      n_total       = recv[0];
+      target_reach  = (n_target >= 0 and n_total >= n_target);
+      all_converged = (recv[2] == comm.size());
+      agreed        = (recv[1] > 0 or target_reach or all_converged);
+    }
+
+    void start_round(int64_t n_local, bool stop_request, bool converged) {
+      send = {n_local, int64_t(stop_request), int64_t(converged)};
+      if (mpi::has_env) {
+        MPI_Iallreduce(send.data(), recv.data(), 3, MPI_INT64_T, MPI_SUM, comm.get(), &req);
+      } else {
+        recv = send;
+        decide();
+      }
+    }
+
+    public:
+    /**
+     * @param c               The communicator
+     * @param n_total_cycles  Total number of cycles over all ranks. If negative, only a stop request stops the run.
+     */
+    collective_stop(mpi::communicator c, int64_t n_total_cycles) : comm(c), n_target(n_total_cycles) {}
+
+    collective_stop(collective_stop const &)            = delete;
+    collective_stop &operator=(collective_stop const &) = delete;
+
+    ~collective_stop() { finalize(); }
+
+    /**
+     * Progress of the agreement. Never blocks.
+     *
+     * @param n_local       Number of cycles done on this rank
+     * @param stop_request  Whether this rank requests a stop
+     * @param converged     Whether this rank has reached its target error
+     * @return true iif all ranks have agreed to stop
+     */
+    bool update(int64_t n_local, bool stop_request, bool converged = false) {
+      if (agreed) return true;
+      if (req != MPI_REQUEST_NULL) {
+        int done = 0;
+        MPI_Test(&req, &done, MPI_STATUS_IGNORE);
+        if (not done) return false;
+        decide();
+        if (agreed) return true;
+      }
+      start_round(n_local, stop_request, converged);
+      return agreed;
+    }
+
+    /// Complete the pending rounds, with a stop request. Blocking. After it, all ranks have agreed to stop.
+    void finalize() {
+      while (not agreed) {
+        if (req != MPI_REQUEST_NULL) {
+          MPI_Wait(&req, MPI_STATUS_IGNORE);
+          decide();
+        } else
+          start_round(send[0], true, send[2]);
+      }
+    }
+
+    /// Has the agreement been reached ?
+    [[nodiscard]] bool stopped() const { return agreed; }
+
+    /// Has the agreement been reached because the total number of cycles reached the target ?
+    [[nodiscard]] bool target_reached() const { return target_reach; }
+
+    /// Has the agreement been reached because all ranks have reached their target error ?
+    [[nodiscard]] bool converged() const { return all_converged; }
+
+    /// The total number of cycles on all ranks, at the last completed round
+    [[nodiscard]] int64_t total_cycles() const { return n_total; }
+  };
+
+} // namespace triqs::mc_tools
@@ -20,8 +20,16 @@
 
 #pragma once
 #include <triqs/utility/first_include.hpp>
+#include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <cstdio>
+#include <exception>
+#include <fstream>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
 #include <triqs/utility/timer.hpp>
 #include <triqs/utility/timestamp.hpp>
 #include <triqs/utility/report_stream.hpp>
@@ -33,6 +41,9 @@
 #include "./mc_measure_aux_set.hpp"
 #include "./mc_measure_set.hpp"
 #include "./mc_move_set.hpp"
+#include "./mc_static_move_set.hpp"
+#include "./collective_stop.hpp"
+#include "./mc_profile.hpp"
 #include "./random_generator.hpp"
 
 namespace triqs::mc_tools {
@@ -42,8 +53,11 @@ namespace triqs::mc_tools {
   *
   * TBR
   * @include triqs/mc_tools.hpp
+  *
+  * @tparam MCSignType   Type of the sign
+  * @tparam MoveSetType  Type of the set of moves: move_set (type erased, default) or static_move_set (cf static_mc_generic)
   */
-  template <typename MCSignType> class mc_generic {
+  template <typename MCSignType, typename MoveSetType = move_set<MCSignType>> class mc_generic {
 
 #ifdef TRIQS_MCTOOLS_DEBUG
     static constexpr bool debug = true;
@@ -67,8 +81,61 @@ namespace triqs::mc_tools {
          AllMeasures(),
          AllMeasuresAux(),
          report(&std::cout, verbosity),
+         random_name(random_name),
+         random_seed(random_seed),
          rethrow_exception(rethrow_exception) {}
 
+    /**
+     * Run several independent Markov chains (walkers) on shared-memory threads
+     *
+     * The walker 0 is this object, set up as usual with add_move, add_measure, etc.
+     * The n_walkers - 1 other walkers are created here, each with its own random generator,
+     * seeded with random_seed + w * walker_seed_stride (modulo 2^32), and set up by calling setup(walker, w) for w = 1, ..., n_walkers - 1.
+     * For a counter-based random generator (e.g. philox4x32), the walker w uses instead the stream (w << 32) | stream_id
+     * of the generator of walker 0, cf random_generator::split. Hence if the walkers 0 of the MPI ranks use distinct streams
+     * below 2^32 (e.g. split(rank)), the streams of all walkers of all ranks are distinct.
+     * The setup function typically registers moves and measures acting on a configuration owned by the walker,
+     * while large read-only data (e.g. hybridization functions, atomic problem) are shared between walkers.
+     *
+     * During run, the walkers run the same number of cycles on their own threads,
+     * and stop together with the walker 0 (stop_callback, signal, exception).
+     * In collect_results, the measures of all walkers are merged into the ones of walker 0 before the MPI reduction.
+     * This requires every measure to provide a method merge(MeasureType const &).
+     * The measures of the other walkers are then cleared, so that their data are merged only once. To call collect_results
+     * after several runs (e.g. run, collect_results, run, collect_results), the measures must also provide a method reset()
+     * clearing their data. Otherwise, the second collect_results throws.
+     *
+     * @param n_walkers  Total number of walkers (i.e. of threads) on this node. Precondition : >0
+     * @param setup      A function (mc_generic &, int) -> void called for each new walker
+     */
+    void set_n_walkers(int n_walkers, std::function<void(mc_generic &, int)> setup) {
+      EXPECTS(n_walkers > 0);
+      EXPECTS(!RandomGenerator.is_counter_based() or RandomGenerator.stream_id() < (uint64_t(1) << 32));
+      walkers.clear();
+      for (int w = 1; w < n_walkers; ++w) {
+        // unsigned arithmetic : the seed wraps around instead of overflowing
+        auto seed = static_cast<int>(static_cast<uint32_t>(random_seed) + static_cast<uint32_t>(w) * walker_seed_stride);
+        walkers.push_back(std::make_unique<mc_generic>(random_name, seed, 0, rethrow_exception));
+        if (RandomGenerator.is_counter_based())
+          walkers.back()->RandomGenerator = RandomGenerator.split((uint64_t(w) << 32) | RandomGenerator.stream_id());
+        walkers.back()->sign = sign;
+        setup(*walkers.back(), w);
+      }
+    }
+
+    /// The total number of walkers, including this one
+    int get_n_walkers() const { return walkers.size() + 1; }
+
+    /**
+     * Access to a walker
+     *
+     * @param w  Index of the walker. 0 is this object.
+     */
+    mc_generic &get_walker(int w) {
+      EXPECTS(w >= 0 and w < get_n_walkers());
+      return (w == 0 ? *this : *walkers[w - 1]);
+    }
+
     /**
    * Register a move
    *
@@ -126,6 +193,163 @@ namespace triqs::mc_tools {
    */
     void set_after_cycle_duty(std::function<void()> f) { after_cycle_duty = f; }
 
+    /**
+     * Sets functions to save and restore the data of the simulation not owned by the moves and measures,
+     * typically the configuration, in a checkpoint. Cf checkpoint.
+     * With several walkers, they are set on each walker.
+     *
+     * @param write  Function (h5::group) -> void writing the data into the group
+     * @param read   Function (h5::group) -> void reading the data written by write
+     */
+    void set_checkpoint_functions(std::function<void(h5::group)> write, std::function<void(h5::group)> read) {
+      checkpoint_write = std::move(write);
+      checkpoint_read  = std::move(read);
+    }
+
+    /**
+     * Checkpoint the simulation periodically during run.
+     *
+     * Every interval seconds, at the end of a cycle, the state is written with checkpoint into an hdf5 file in memory,
+     * in the group "mc_generic". The memory file is then written to disk in a background thread, so that the Markov chain
+     * is not stalled while writing. It is written to filename + ".tmp" first and then renamed, so that filename always
+     * contains a complete checkpoint.
+     * NB : the state itself is written into memory synchronously by checkpoint, on the thread of walker 0, which stalls the chain
+     * for this time. If the previous file is still being written to disk, the next checkpoint also waits for it.
+     *
+     * @param filename  Name of the checkpoint file, which must be different on each MPI rank. If empty, no checkpoint is done.
+     * @param interval  Time between two checkpoints in seconds
+     */
+    void set_checkpoint_file(std::string filename, double interval) {
+      checkpoint_filename = std::move(filename);
+      checkpoint_interval = interval;
+    }
+
+    /**
+     * Stop the accumulation on all MPI ranks together.
+     *
+     * When enabled, during the accumulation (run with do_measure), the ranks of the communicator exchange
+     * their number of cycles and their stop requests (stop_callback, signal, exception) with non-blocking collectives
+     * in the background of the cycles, and all stop after the same exchange, cf collective_stop.
+     * Hence they all reach collect_results at the same time, instead of waiting for the slowest one.
+     * The number of accumulation cycles is then the total number of cycles over all ranks and walkers.
+     * The warmup is not affected.
+     *
+     * @param enable  Enable or disable the collective stop
+     */
+    void set_collective_stop(bool enable) { collective_stop_enabled = enable; }
+
+    /**
+     * Profile the run: time each move (attempt, accept, reject), the after cycle duty and the Metropolis random numbers.
+     *
+     * The profile, with the time of the measures, is gathered over the walkers and the MPI ranks in collect_results
+     * and is available with get_profile. It must be enabled on all ranks or none.
+     * NB : the timing adds a small overhead to each step, which matters for very cheap moves.
+     *
+     * @param enable  Enable or disable the profiling
+     */
+    void set_profiling(bool enable) { profiling = enable; }
+
+    /**
+     * Stop the accumulation when a target error is reached.
+     *
+     * During the accumulation (run with do_measure), every check_interval cycles, error is called. It typically returns
+     * the relative error of the main observable, estimated from the logarithmic bins of its accumulator,
+     * cf accumulator::relative_error. The run stops when it is below target, as if its number of cycles was done (status 0).
+     *
+     * The error is a local estimate : it is called on the walker 0 (this object) of each rank, and sees only the measures
+     * of this walker, not the ones of the other walkers nor of the other ranks, which are merged only in collect_results.
+     * Without a collective stop, each rank stops when its own estimate is below target.
+     * With a collective stop, the ranks stop together, when it is below target on all of them.
+     * For equivalent walkers, the error of the merged result is then about target / sqrt(number of walkers over all ranks) :
+     * to aim at the error of the merged result, pass this scaled target.
+     *
+     * @param error           Function () -> double, the current error. If empty, the target error is disabled.
+     * @param target          The target error
+     * @param check_interval  Number of cycles between two calls to error
+     */
+    void set_target_error(std::function<double()> error, double target, int64_t check_interval = 100) {
+      EXPECTS(check_interval > 0);
+      target_error_fn       = std::move(error);
+      target_error          = target;
+      target_error_interval = check_interval;
+    }
+
+    /**
+     * The profile of the last run, summed over walkers and MPI ranks, cf set_profiling.
+     * Available after collect_results.
+     */
+    mc_profile const &get_profile() const { return profile; }
+
+    /**
+     * Write the full state of the simulation, to be resumed later with restore.
+     *
+     * The state consists of the moves and measures (those implementing h5_write), the move statistics,
+     * the cycle and measure counters, the sign, the state of the random generator (or its position in the random number sequence
+     * if its state can not be saved, cf random_generator::has_state),
+     * the data of the checkpoint functions (cf set_checkpoint_functions), and the same for all walkers.
+     * All generators provided by random_generator save their state, except the counter-based ones which only need their position.
+     *
+     * The writing is synchronous : it returns when all the state is written into g.
+     *
+     * @param g  The group in which the state is written
+     */
+    void checkpoint(h5::group g) {
+      h5_write(g, "moves", AllMoves);
+      h5_write(g, "measures", AllMeasures);
+      AllMoves.h5_write_statistics(g.create_group("move_statistics"));
+      h5_write(g, "number_cycle_done", current_cycle_number);
+      h5_write(g, "number_measure_done", nmeasures);
+      h5_write(g, "config_id", config_id);
+      h5_write(g, "sign", sign);
+      auto gr = g.create_group("random_generator");
+      h5_write(gr, "name", RandomGenerator.name());
+      h5_write(gr, "seed", long(RandomGenerator.seed()));
+      h5_write(gr, "stream_id", RandomGenerator.stream_id());
+      h5_write(gr, "position", RandomGenerator.position());
+      if (RandomGenerator.has_state()) h5_write(gr, "state", RandomGenerator.get_state());
+      if (checkpoint_write) checkpoint_write(g.create_group("data"));
+      h5_write(g, "n_walkers", get_n_walkers());
+      for (size_t w = 0; w < walkers.size(); ++w) {
+        std::lock_guard lock{*walkers[w]->cycle_mutex}; // the walker may be running
+        walkers[w]->checkpoint(g.create_group("walker_" + std::to_string(w + 1)));
+      }
+    }
+
+    /**
+     * Restore the state of the simulation written by checkpoint.
+     *
+     * The mc_generic must be set up as the one which was checkpointed (same moves, measures, walkers).
+     * The next run continues the Markov chain, the measures and the move statistics from this state.
+     *
+     * @param g  The group in which the state was written
+     */
+    void restore(h5::group g) {
+      if (auto n = h5::read<int>(g, "n_walkers"); n != get_n_walkers())
+        TRIQS_RUNTIME_ERROR << "mc_generic : restore : the checkpoint has " << n << " walkers instead of " << get_n_walkers();
+      h5_read(g, "moves", AllMoves);
+      h5_read(g, "measures", AllMeasures);
+      AllMoves.h5_read_statistics(g.open_group("move_statistics"));
+      h5_read(g, "number_cycle_done", current_cycle_number);
+      h5_read(g, "number_measure_done", nmeasures);
+      h5_read(g, "config_id", config_id);
+      h5_read(g, "sign", sign);
+      auto gr        = g.open_group("random_generator");
+      auto name      = h5::read<std::string>(gr, "name");
+      auto seed      = uint32_t(h5::read<long>(gr, "seed"));
+      auto stream_id = h5::read<uint64_t>(gr, "stream_id");
+      // the moves keep a reference to RandomGenerator: assign it in place
+      RandomGenerator = (stream_id == 0 ? random_generator(name, seed) : random_generator(name, seed, stream_id));
+      // Without a saved state, the generator is advanced to its position, which costs the generation of
+      // all the numbers drawn before the checkpoint (except for the counter-based generators, in O(1))
+      if (std::string state; h5::try_read(gr, "state", state))
+        RandomGenerator.set_state(state);
+      else
+        RandomGenerator.advance(h5::read<uint64_t>(gr, "position"));
+      if (checkpoint_read) checkpoint_read(g.open_group("data"));
+      for (size_t w = 0; w < walkers.size(); ++w) walkers[w]->restore(g.open_group("walker_" + std::to_string(w + 1)));
+      restored = true;
+    }
+
     int warmup(int64_t n_warmup_cycles, int64_t length_cycle, std::function<bool()> stop_callback, mpi::communicator c = mpi::communicator{}) {
       report(3) << "\nWarming up ..." << std::endl;
       auto status  = run(n_warmup_cycles, length_cycle, stop_callback, false, c);
@@ -154,7 +378,7 @@ namespace triqs::mc_tools {
      */
     int warmup(int64_t n_warmup_cycles, int64_t length_cycle, std::function<bool()> stop_callback, MCSignType sign_init,
                mpi::communicator c = mpi::communicator{}) {
-      sign = sign_init;
+      set_sign(sign_init);
       return warmup(n_warmup_cycles, length_cycle, stop_callback, c);
     }
 
@@ -216,7 +440,7 @@ namespace triqs::mc_tools {
      */
     int warmup_and_accumulate(int64_t n_warmup_cycles, int64_t n_accumulation_cycles, int64_t length_cycle, std::function<bool()> stop_callback,
                               MCSignType sign_init, mpi::communicator c = mpi::communicator{}) {
-      sign = sign_init; // init the sign
+      set_sign(sign_init); // init the sign
       return warmup_and_accumulate(n_warmup_cycles, n_accumulation_cycles, length_cycle, stop_callback, c);
     }
 
@@ -243,43 +467,48 @@ namespace triqs::mc_tools {
     int run(int64_t n_cycles, int64_t length_cycle, std::function<bool()> stop_callback, bool do_measure, mpi::communicator c = mpi::communicator{}) {
       EXPECTS(length_cycle > 0);
 
-      AllMoves.clear_statistics();
+      // after a restore, continue the statistics of the checkpoint
+      if (not restored) {
+        AllMoves.clear_statistics();
+        nmeasures = 0;
+      }
+      restored = false;
+      clear_profiling_timers();
+      for (auto &w : walkers) w->profiling = profiling;
 
       timer_run = {};
       timer_run.start();
       if (n_cycles == 0) return 0;
       triqs::signal_handler::start();
       done_percent = 0;
-      nmeasures    = 0;
       bool stop_it = false, finished = false, infinite = (n_cycles < 0);
-      int NC                = 0;
-      double next_info_time = 0.1;
+      bool error_reached = false; // target error reached on this rank
+      bool converged     = false; // stop because of the target error (on all ranks with a collective stop)
+      int NC                      = 0;
+      double next_info_time       = 0.1;
+      double next_checkpoint_time = checkpoint_interval;
+      std::thread checkpoint_writer;
 
       std::unique_ptr<mpi::monitor> node_monitor;
       if (rethrow_exception and mpi::has_env) node_monitor = std::make_unique<mpi::monitor>(c);
 
+      // with a collective stop, n_cycles is the total over all ranks and walkers
+      std::optional<collective_stop> coll;
+      if (collective_stop_enabled and do_measure) coll.emplace(c, n_cycles);
+
+      // start the other walkers, if any. They stop when walker_stop is set.
+      std::atomic<bool> walker_stop = false, walker_failed = false;
+      std::atomic<int64_t> walker_cycles = 0;
+      std::vector<std::exception_ptr> walker_errors(walkers.size());
+      std::vector<std::thread> walker_threads;
+      for (size_t w = 0; w < walkers.size(); ++w)
+        walker_threads.emplace_back([&, w]() {
+          walkers[w]->run_walker((coll ? -1 : n_cycles), length_cycle, do_measure, walker_stop, walker_failed, walker_cycles, walker_errors[w]);
+        });
+
       for (; !stop_it; ++NC) { // do NOT reinit NC to 0
         try {
-          // Metropolis loop. Switch here for HeatBath, etc...
-          for (int64_t k = 1; (k <= length_cycle); k++) {
-            if (triqs::signal_handler::received()) throw triqs::signal_handler::exception{};
-            double r = AllMoves.attempt();
-            if (RandomGenerator() < std::min(1.0, r)) {
-              if (debug) std::cerr << " Move accepted " << std::endl;
-              sign *= AllMoves.accept();
-              if (debug) std::cerr << " New sign = " << sign << std::endl;
-            } else {
-              if (debug) std::cerr << " Move rejected " << std::endl;
-              AllMoves.reject();
-            }
-            ++config_id;
-          }
-          if (after_cycle_duty) { after_cycle_duty(); }
-          if (do_measure) {
-            nmeasures++;
-            for (auto &x : AllMeasuresAux) x();
-            AllMeasures.accumulate(sign);
-          }
+          run_one_cycle(length_cycle, do_measure, true);
         } catch (triqs::signal_handler::exception const &) {
           std::cerr << "mc_generic: Signal caught on node " << c.rank() << "\n" << std::endl;
           // current cycle interrupted, stop calculation below
@@ -292,31 +521,73 @@ namespace triqs::mc_tools {
             c.abort(2);
         }
 
-        // recompute fraction done
-        done_percent = int64_t(floor(((NC + 1) * 100.0) / n_cycles));
+        // recompute fraction done. With a collective stop, from the total number of cycles at the last exchange
+        int64_t n_done = (coll ? std::max(coll->total_cycles(), int64_t{1}) : NC + 1);
+        done_percent   = int64_t(floor((n_done * 100.0) / n_cycles));
         if (timer_run > next_info_time || done_percent == 100) {
           if (infinite) {
-            report(3) << utility::timestamp() << " cycle " << NC << std::endl;
+            report(3) << utility::timestamp() << " cycle " << n_done - 1 << std::endl;
           } else {
             report(3) << utility::timestamp() << " " << std::setfill(' ') << std::setw(3) << done_percent << "%"
-                      << " ETA " << estimate_time_left(n_cycles, NC, timer_run) << " cycle " << NC << " of " << n_cycles << std::endl;
+                      << " ETA " << estimate_time_left(n_cycles, n_done - 1, timer_run) << " cycle " << n_done - 1 << " of " << n_cycles
+                      << std::endl;
           }
           if (do_measure) report(3) << AllMeasures.report();
           next_info_time = 1.25 * timer_run + 2.0; // Increase time interval non-linearly
         }
-        finished = NC + 1 >= n_cycles and not infinite;
-        stop_it  = (stop_callback() || triqs::signal_handler::received() || finished);
+        if (target_error_fn and do_measure and (NC + 1) % target_error_interval == 0) error_reached = (target_error_fn() <= target_error);
+        if (coll) {
+          bool request = stop_callback() || triqs::signal_handler::received() || walker_failed;
+          if (node_monitor) request |= node_monitor->emergency_occured();
+          stop_it   = coll->update(NC + 1 + walker_cycles, request, error_reached);
+          converged = stop_it and coll->converged();
+          finished  = stop_it and (coll->target_reached() or converged);
+        } else {
+          converged = error_reached;
+          finished  = (NC + 1 >= n_cycles and not infinite) or converged;
+          stop_it   = (stop_callback() || triqs::signal_handler::received() || finished);
+        }
 
         // Stop if an emergeny occured on any node
         if (node_monitor) stop_it |= node_monitor->emergency_occured();
 
+        // Stop if one of the other walkers has failed
+        stop_it |= walker_failed;
+
+        // Periodic checkpoint
+        if (not checkpoint_filename.empty() and not stop_it and timer_run > next_checkpoint_time) {
+          write_checkpoint_file(checkpoint_writer);
+          next_checkpoint_time = timer_run + checkpoint_interval;
+        }
+
       } // end main NC loop
 
-      current_cycle_number += NC;
+      // in case we stopped before the agreement (exception)
+      if (coll) coll->finalize();
+
+      // wait for the other walkers to complete their cycles (or stop them)
+      // and treat their first exception as an exception on this node
+      if (coll or not finished or converged) walker_stop = true;
+      for (auto &t : walker_threads) t.join();
+      std::exception_ptr walker_error;
+      for (size_t w = 0; w < walkers.size() and not walker_error; ++w) {
+        if (not walker_errors[w]) continue;
+        walker_error = walker_errors[w];
+        try {
+          std::rethrow_exception(walker_error);
+        } catch (std::exception const &err) {
+          std::cerr << "mc_generic: Exception occurs on node " << c.rank() << " in walker " << w + 1 << "\n" << err.what() << std::endl;
+        } catch (...) {}
+        if (not rethrow_exception) c.abort(2);
+        if (node_monitor) node_monitor->request_emergency_stop();
+      }
+
+      if (checkpoint_writer.joinable()) checkpoint_writer.join();
       timer_run.stop();
 
       int status = (finished ? 0 : (triqs::signal_handler::received() ? 2 : 1));
       triqs::signal_handler::stop();
+      if (walker_error and not node_monitor) std::rethrow_exception(walker_error);
 
       if (node_monitor) {
         node_monitor->finalize_communications();
@@ -324,6 +595,7 @@ namespace triqs::mc_tools {
       }
 
       // final reporting
+      if (status == 0 and converged) report << "mc_generic stops because the target error is reached" << std::endl;
       if (status == 1) report << "mc_generic stops because of stop_callback" << std::endl;
       if (status == 2) report << "mc_generic stops because of a signal" << std::endl;
 
@@ -332,19 +604,39 @@ namespace triqs::mc_tools {
       return status;
     }
 
-    /// Reduce the results of the measures, and reports some statistics
+    /**
+     * Reduce the results of the measures, and reports some statistics
+     *
+     * With several walkers, the measures and move statistics of all walkers are first merged into the ones of walker 0.
+     */
     void collect_results(mpi::communicator const &c) {
       report(3) << "[Rank " << c.rank() << "] Collect results: Waiting for all mpi-threads to finish accumulating...\n";
+      int64_t nmeasures_node = nmeasures;
+      for (auto &w : walkers) {
+        AllMeasures.merge(w->AllMeasures);
+        w->AllMeasures.reset();
+        AllMoves.merge_statistics(w->AllMoves);
+        w->AllMoves.clear_statistics();
+        nmeasures_node += w->nmeasures;
+        timer_rng += w->timer_rng;
+        timer_after_cycle_duty += w->timer_after_cycle_duty;
+        w->timer_rng = w->timer_after_cycle_duty = {};
+      }
+      if (profiling) {
+        profile = {AllMoves.get_timings(), AllMeasures.get_durations(), double(timer_rng), double(timer_after_cycle_duty)};
+        profile.all_reduce(c);
+      }
       AllMeasures.collect_results(c);
       AllMoves.collect_statistics(c);
-      int64_t nmeasures_tot = mpi::reduce(nmeasures, c);
+      int64_t nmeasures_tot = mpi::reduce(nmeasures_node, c);
 
       report(3) << "[Rank " << c.rank() << "] Timings for all measures:\n" << AllMeasures.get_timings();
       report(3) << "[Rank " << c.rank() << "] Acceptance rate for all moves:\n" << AllMoves.get_statistics();
+      if (profiling and c.rank() == 0) report(3) << "Profile of the run, summed over all ranks:\n" << profile.report();
       report(3) << "[Rank " << c.rank() << "] Warmup lasted: " << get_warmup_time() << " seconds [" << get_warmup_time_HHMMSS() << "]\n";
       report(3) << "[Rank " << c.rank() << "] Simulation lasted: " << get_accumulation_time() << " seconds [" << get_accumulation_time_HHMMSS()
                 << "]\n";
-      report(3) << "[Rank " << c.rank() << "] Number of measures: " << nmeasures << std::endl;
+      report(3) << "[Rank " << c.rank() << "] Number of measures: " << nmeasures_node << std::endl;
       if (c.rank() == 0) report(2) << "Total number of measures: " << nmeasures_tot << std::endl;
     }
 
@@ -426,17 +718,135 @@ namespace triqs::mc_tools {
     }
 
     private:
+    // Set the sign of the initial configuration for all walkers
+    void set_sign(MCSignType sign_init) {
+      sign = sign_init;
+      for (auto &w : walkers) w->sign = sign_init;
+    }
+
+    // One cycle: length_cycle Metropolis steps, the after cycle duty and the measures
+    void run_one_cycle(int64_t length_cycle, bool do_measure, bool check_signal) {
+      // Metropolis loop. Switch here for HeatBath, etc...
+      for (int64_t k = 1; (k <= length_cycle); k++) {
+        if (check_signal and triqs::signal_handler::received()) throw triqs::signal_handler::exception{};
+        double r = AllMoves.attempt();
+        if (profiling) timer_rng.start();
+        bool accepted = RandomGenerator() < std::min(1.0, r);
+        if (profiling) timer_rng.stop();
+        if (accepted) {
+          if (debug) std::cerr << " Move accepted " << std::endl;
+          sign *= AllMoves.accept();
+          if (debug) std::cerr << " New sign = " << sign << std::endl;
+        } else {
+          if (debug) std::cerr << " Move rejected " << std::endl;
+          AllMoves.reject();
+        }
+        ++config_id;
+      }
+      if (after_cycle_duty) {
+        if (profiling) timer_after_cycle_duty.start();
+        after_cycle_duty();
+        if (profiling) timer_after_cycle_duty.stop();
+      }
+      if (do_measure) {
+        nmeasures++;
+        for (auto &x : AllMeasuresAux) x();
+        AllMeasures.accumulate(sign);
+      }
+      ++current_cycle_number;
+    }
+
+    // Reset the timers of the profiling and enable the timers of the moves accordingly
+    void clear_profiling_timers() {
+      AllMoves.set_timers(profiling);
+      timer_rng = timer_after_cycle_duty = {};
+    }
+
+    // Checkpoint into a memory file, written to disk by the thread writer
+    void write_checkpoint_file(std::thread &writer) {
+      h5::memory_file mf;
+      checkpoint(h5::group{mf}.create_group("mc_generic"));
+      if (writer.joinable()) writer.join(); // the previous checkpoint is written
+      writer = std::thread{[buf = mf.as_buffer(), filename = checkpoint_filename]() {
+        auto tmp = filename + ".tmp";
+        {
+          std::ofstream out(tmp, std::ios::binary);
+          out.write(reinterpret_cast<const char *>(buf.data()), buf.size());
+          if (not out) {
+            std::cerr << "mc_generic: Failed to write the checkpoint file " << tmp << std::endl;
+            return;
+          }
+        }
+        if (std::rename(tmp.c_str(), filename.c_str()) != 0) std::cerr << "mc_generic: Failed to rename " << tmp << " to " << filename << std::endl;
+      }};
+    }
+
+    // Run loop of the walkers other than walker 0, on their own thread.
+    // No reporting, signal or mpi handling here: it is all done by walker 0 which sets stop.
+    void run_walker(int64_t n_cycles, int64_t length_cycle, bool do_measure, std::atomic<bool> const &stop, std::atomic<bool> &failed,
+                    std::atomic<int64_t> &n_cycles_done, std::exception_ptr &error) {
+      {
+        std::lock_guard lock{*cycle_mutex}; // walker 0 may already checkpoint
+        if (not restored) {
+          AllMoves.clear_statistics();
+          nmeasures = 0;
+        }
+        restored = false;
+        clear_profiling_timers();
+      }
+      timer_run = {};
+      timer_run.start();
+      int64_t NC = 0;
+      try {
+        for (; (n_cycles < 0 or NC < n_cycles) and not stop; ++NC) {
+          std::lock_guard lock{*cycle_mutex}; // a checkpoint is done between two cycles
+          run_one_cycle(length_cycle, do_measure, false);
+          n_cycles_done.fetch_add(1, std::memory_order_relaxed);
+        }
+      } catch (...) {
+        error  = std::current_exception();
+        failed = true;
+      }
+      timer_run.stop();
+    }
+
+    // The seeds of the walkers are separated by this stride
+    static constexpr uint32_t walker_seed_stride = 104729;
+
     random_generator RandomGenerator;
-    move_set<MCSignType> AllMoves;
+    MoveSetType AllMoves;
     measure_set<MCSignType> AllMeasures;
     std::vector<measure_aux> AllMeasuresAux;
     utility::report_stream report;
     int64_t nmeasures, current_cycle_number = 0;
     utility::timer timer_run, timer_accumulation, timer_warmup;
+    utility::timer timer_rng, timer_after_cycle_duty;
+    bool profiling = false;
+    mc_profile profile;
     std::function<void()> after_cycle_duty;
     MCSignType sign        = 1;
     int64_t done_percent   = 0;
     int64_t config_id      = 0;
+    std::string random_name;
+    int random_seed        = 0;
     bool rethrow_exception = true;
+    bool restored          = false;
+    bool collective_stop_enabled = false;
+    std::function<double()> target_error_fn;
+    double target_error           = 0;
+    int64_t target_error_interval = 100;
+    std::vector<std::unique_ptr<mc_generic>> walkers;
+    std::unique_ptr<std::mutex> cycle_mutex = std::make_unique<std::mutex>();
+    std::function<void(h5::group)> checkpoint_write, checkpoint_read;
+    std::string checkpoint_filename;
+    double checkpoint_interval = 0;
   };
+
+  /**
+   * Monte Carlo class with a set of moves known at compile time.
+   *
+   * Same as mc_generic, but the moves are dispatched without type erasure and chosen with an alias table,
+   * cf static_move_set. The moves are added with add_move, and must be of one of the types Moves.
+   */
+  template <typename MCSignType, typename... Moves> using static_mc_generic = mc_generic<MCSignType, static_move_set<MCSignType, Moves...>>;
 } // namespace triqs::mc_tools
@@ -24,6 +24,7 @@
 #include <triqs/utility/exceptions.hpp>
 #include <triqs/utility/timer.hpp>
 #include <functional>
+#include <typeindex>
 #include <map>
 #include <cassert>
 #include <iomanip>
@@ -37,10 +38,14 @@ namespace triqs {
       std::shared_ptr<void> impl_;
       std::function<void(MCSignType const &)> accumulate_;
       std::function<void(mpi::communicator const &)> collect_results_;
+      std::function<void(void const *)> merge_;
+      std::function<void()> reset_; // empty if the measure has no reset method
       std::function<std::string()> report_;
       std::function<void(h5::group, std::string const &)> h5_r, h5_w;
 
       uint64_t count_;
+      bool merged_without_reset = false; // the data were merged into another measure, and could not be reset
+      std::type_index type_ = typeid(void);
       bool enable_timer;
       utility::timer Timer;
 
@@ -60,6 +65,16 @@ namespace triqs {
         accumulate_      = [p](MCSignType const &x) { p->accumulate(x); };
         count_           = 0;
         collect_results_ = [p](mpi::communicator const &c) { p->collect_results(c); };
+        merge_           = [p](void const *other) {
+          if constexpr (requires { p->merge(*p); }) {
+            p->merge(*static_cast<m_t const *>(other));
+          } else {
+            (void)p; // suppress clang -Wunused-lambda-capture warning
+            TRIQS_RUNTIME_ERROR << "This measure does not implement the merge function, required to run several walkers";
+          }
+        };
+        if constexpr (requires { p->reset(); }) reset_ = [p]() { p->reset(); };
+        type_ = typeid(m_t);
         report_          = [p]() -> std::string {
           if constexpr (requires { p->report(); }) {
             return p->report();
@@ -98,6 +113,28 @@ namespace triqs {
       }
       std::string report() const { return report_(); }
 
+      /// Merge the data accumulated by another measure of the same type, e.g. in another walker
+      void merge(measure const &other) {
+        if (other.type_ != type_) TRIQS_RUNTIME_ERROR << "measure : merge : the measures have different types";
+        if (other.merged_without_reset)
+          TRIQS_RUNTIME_ERROR << "measure : merge : the data of this measure were already merged, "
+                              << "and it does not implement the reset function to clear them";
+        merge_(other.impl_.get());
+        count_ += other.count_;
+        Timer += other.Timer;
+      }
+
+      /// Clear the data, once merged into another measure.
+      /// Without a reset method in the measure, its data can not be merged again.
+      void reset() {
+        if (reset_)
+          reset_();
+        else
+          merged_without_reset = true;
+        count_ = 0;
+        Timer  = {};
+      }
+
       uint64_t count() const { return count_; }
       double duration() const { return double(Timer); }
 
@@ -188,6 +225,28 @@ namespace triqs {
         return s.str();
       }
 
+      /// Time spent in each measure, as a map name -> seconds
+      std::map<std::string, double> get_durations() const {
+        std::map<std::string, double> r;
+        for (auto &[name, m] : m_map) r.insert({name, m.duration()});
+        return r;
+      }
+
+      // merge the measures of another measure_set with the same names, e.g. from another walker
+      void merge(measure_set const &other) {
+        if (other.m_map.size() != m_map.size()) TRIQS_RUNTIME_ERROR << "measure_set : merge : the measure sets have different sizes";
+        for (auto &[name, m] : m_map) {
+          auto it = other.m_map.find(name);
+          if (it == other.m_map.end()) TRIQS_RUNTIME_ERROR << "measure_set : merge : measure '" << name << "' is missing";
+          m.merge(it->second);
+        }
+      }
+
+      // clear the measures once merged into another measure_set, cf merge
+      void reset() {
+        for (auto &[name, m] : m_map) m.reset();
+      }
+
       // gather result for all measure, on communicator c
       void collect_results(mpi::communicator const &c) {
         for (auto &[name, m] : m_map) m.collect_results(c);
@@ -21,9 +21,11 @@
 #include <h5/h5.hpp>
 #include <triqs/utility/report_stream.hpp>
 #include <triqs/utility/exceptions.hpp>
+#include <triqs/utility/timer.hpp>
 #include <mpi/mpi.hpp>
 #include <functional>
 #include "./random_generator.hpp"
+#include "./mc_profile.hpp"
 
 namespace triqs {
   namespace mc_tools {
@@ -48,6 +50,8 @@ namespace triqs {
       uint64_t NProposed, Naccepted;
       double acceptance_rate_;
       bool is_move_set_; // need to remember if the move was a move_set for printing details later.
+      bool enable_timer = false;
+      utility::timer attempt_timer, accept_timer, reject_timer;
 
 #ifdef TRIQS_MCTOOLS_DEBUG
       static constexpr bool debug = true;
@@ -97,13 +101,25 @@ namespace triqs {
 
       MCSignType attempt() {
         NProposed++;
-        return attempt_();
+        if (not enable_timer) return attempt_();
+        attempt_timer.start();
+        auto r = attempt_();
+        attempt_timer.stop();
+        return r;
       }
       MCSignType accept() {
         Naccepted++;
-        return accept_();
+        if (not enable_timer) return accept_();
+        accept_timer.start();
+        auto r = accept_();
+        accept_timer.stop();
+        return r;
+      }
+      void reject() {
+        if (enable_timer) reject_timer.start();
+        reject_();
+        if (enable_timer) reject_timer.stop();
       }
-      void reject() { reject_(); }
 
       double acceptance_rate() const { return acceptance_rate_; }
       uint64_t n_proposed_config() const { return NProposed; }
@@ -113,6 +129,33 @@ namespace triqs {
         NProposed        = 0;
         Naccepted        = 0;
         acceptance_rate_ = -1;
+        attempt_timer = accept_timer = reject_timer = {};
+      }
+
+      /// Time the calls to attempt, accept and reject
+      void set_timer(bool enable) {
+        enable_timer = enable;
+        if (auto ms = as_move_set()) ms->set_timers(enable);
+      }
+
+      /// Number of calls and time spent in the move on this node
+      move_timings timings() const { return {NProposed, Naccepted, double(attempt_timer), double(accept_timer), double(reject_timer)}; }
+
+      /// Set the number of proposed and accepted moves, e.g. when restoring a checkpoint
+      void set_statistics(uint64_t n_proposed, uint64_t n_accepted) {
+        NProposed = n_proposed;
+        Naccepted = n_accepted;
+      }
+
+      /// Add the statistics of another move of the same kind, e.g. in another walker
+      void merge_statistics(move const &other) {
+        NProposed += other.NProposed;
+        Naccepted += other.Naccepted;
+        attempt_timer += other.attempt_timer;
+        accept_timer += other.accept_timer;
+        reject_timer += other.reject_timer;
+        auto ms = as_move_set(), other_ms = other.as_move_set();
+        if (ms and other_ms) ms->merge_statistics(*other_ms);
       }
 
       void collect_statistics(mpi::communicator const &c) {
@@ -268,6 +311,49 @@ namespace triqs {
         for (auto &m : move_vec) m.collect_statistics(c);
       }
 
+      /// Time the calls to the moves, cf get_timings
+      void set_timers(bool enable) {
+        for (auto &m : move_vec) m.set_timer(enable);
+      }
+
+      /// Number of calls and time spent in all moves on this node, as a map name -> move_timings, flattened as get_acceptance_rates
+      std::map<std::string, move_timings> get_timings() const {
+        std::map<std::string, move_timings> r;
+        for (size_t u = 0; u < move_vec.size(); ++u) {
+          r.insert({names_[u], move_vec[u].timings()});
+          if (auto ms = move_vec[u].as_move_set()) {
+            auto t = ms->get_timings();
+            r.insert(t.begin(), t.end());
+          }
+        }
+        return r;
+      }
+
+      /// Add the statistics of the moves of another move_set with the same moves, e.g. in another walker
+      void merge_statistics(move_set const &other) {
+        if (other.names_ != names_) TRIQS_RUNTIME_ERROR << "move_set : merge_statistics : the move sets have different moves";
+        for (size_t u = 0; u < move_vec.size(); ++u) move_vec[u].merge_statistics(other.move_vec[u]);
+      }
+
+      /// Write the number of proposed and accepted moves of all moves, e.g. for a checkpoint
+      void h5_write_statistics(h5::group g) const {
+        for (size_t u = 0; u < move_vec.size(); ++u) {
+          h5_write(g, names_[u], std::vector<uint64_t>{move_vec[u].n_proposed_config(), move_vec[u].n_accepted_config()});
+          auto ms = move_vec[u].as_move_set();
+          if (ms) ms->h5_write_statistics(g.create_group(names_[u] + "_moves"));
+        }
+      }
+
+      /// Read the statistics written by h5_write_statistics
+      void h5_read_statistics(h5::group g) {
+        for (size_t u = 0; u < move_vec.size(); ++u) {
+          auto n = h5::read<std::vector<uint64_t>>(g, names_[u]);
+          move_vec[u].set_statistics(n.at(0), n.at(1));
+          auto ms = move_vec[u].as_move_set();
+          if (ms) ms->h5_read_statistics(g.open_group(names_[u] + "_moves"));
+        }
+      }
+
       /// Acceptance rate of all moves as a map name:string -> acceptance_rate:double
       std::map<std::string, double> get_acceptance_rates() const {
         std::map<std::string, double> r;
@@ -0,0 +1,105 @@
+// Copyright (c) 2026 Simons Foundation
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You may obtain a copy of the License at
+//     https://www.gnu.org/licenses/gpl-3.0.txt
+
+#pragma once
+#include <h5/h5.hpp>
+#include <mpi/mpi.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <string>
+
+namespace triqs::mc_tools {
+
+  /// Number of calls and time spent (in seconds) in the methods of a move
+  struct move_timings {
+    uint64_t n_proposed = 0, n_accepted = 0;
+    double attempt = 0, accept = 0, reject = 0;
+
+    /// Total time in the move
+    [[nodiscard]] double total() const { return attempt + accept + reject; }
+  };
+
+  /**
+   * Where the time of a Monte Carlo run is spent, cf mc_generic::set_profiling.
+   *
+   * The times are in seconds, summed over the walkers and the MPI ranks.
+   * The time of the random numbers drawn by a move is included in the time of its attempt/accept/reject,
+   * rng_metropolis is only the time of the draws of the Metropolis acceptance test.
+   */
+  struct mc_profile {
+    std::map<std::string, move_timings> moves; // flattened as in get_acceptance_rates
+    std::map<std::string, double> measures;    // time in accumulate
+    double rng_metropolis   = 0;
+    double after_cycle_duty = 0;
+
+    /// Sum the profiles over the ranks of a communicator. They must have the same moves and measures.
+    void all_reduce(mpi::communicator const &c) {
+      for (auto &[name, m] : moves) {
+        m.n_proposed = mpi::all_reduce(m.n_proposed, c);
+        m.n_accepted = mpi::all_reduce(m.n_accepted, c);
+        m.attempt    = mpi::all_reduce(m.attempt, c);
+        m.accept     = mpi::all_reduce(m.accept, c);
+        m.reject     = mpi::all_reduce(m.reject, c);
+      }
+      for (auto &[name, t] : measures) t = mpi::all_reduce(t, c);
+      rng_metropolis   = mpi::all_reduce(rng_metropolis, c);
+      after_cycle_duty = mpi::all_reduce(after_cycle_duty, c);
+    }
+
+    /// Pretty print the profile, with the cost of each move per proposal and per accepted proposal
+    [[nodiscard]] std::string report() const {
+      std::ostringstream s;
+      size_t wlab = 18;
+      for (auto &[name, m] : moves) wlab = std::max(wlab, name.size());
+      for (auto &[name, t] : measures) wlab = std::max(wlab, name.size());
+      int w = 12;
+      s << std::left << std::setw(wlab) << "Move" << " | " << std::setw(w) << "attempt [s]" << " | " << std::setw(w) << "accept [s]" << " | "
+        << std::setw(w) << "reject [s]" << " | " << std::setw(w) << "us/proposal" << " | " << std::setw(w) << "us/accepted" << "\n";
+      for (auto &[name, m] : moves) {
+        auto per = [](double t, uint64_t n) { return (n > 0 ? 1.e6 * t / n : 0.0); };
+        s << std::left << std::setw(wlab) << name << " | " << std::setw(w) << m.attempt << " | " << std::setw(w) << m.accept << " | "
+          << std::setw(w) << m.reject << " | " << std::setw(w) << per(m.total(), m.n_proposed) << " | " << std::setw(w)
+          << per(m.total(), m.n_accepted) << "\n";
+      }
+      s << std::left << std::setw(wlab) << "Measure" << " | " << std::setw(w) << "seconds" << "\n";
+      for (auto &[name, t] : measures) s << std::left << std::setw(wlab) << name << " | " << std::setw(w) << t << "\n";
+      s << std::left << std::setw(wlab) << "Metropolis rng" << " | " << std::setw(w) << rng_metropolis << "\n";
+      s << std::left << std::setw(wlab) << "After cycle duty" << " | " << std::setw(w) << after_cycle_duty << "\n";
+      return s.str();
+    }
+
+    // HDF5 interface
+    friend void h5_write(h5::group g, std::string const &name, mc_profile const &p) {
+      auto gr = g.create_group(name);
+      auto gm = gr.create_group("moves");
+      for (auto &[n, m] : p.moves) {
+        auto gmm = gm.create_group(n);
+        h5_write(gmm, "n_proposed", m.n_proposed);
+        h5_write(gmm, "n_accepted", m.n_accepted);
+        h5_write(gmm, "attempt", m.attempt);
+        h5_write(gmm, "accept", m.accept);
+        h5_write(gmm, "reject", m.reject);
+      }
+      auto gme = gr.create_group("measures");
+      for (auto &[n, t] : p.measures) h5_write(gme, n, t);
+      h5_write(gr, "rng_metropolis", p.rng_metropolis);
+      h5_write(gr, "after_cycle_duty", p.after_cycle_duty);
+    }
+  };
+
+} // namespace triqs::mc_tools
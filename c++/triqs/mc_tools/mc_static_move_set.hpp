@@ -0,0 +1,328 @@
+// Copyright (c) 2026 Simons Foundation
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You may obtain a copy of the License at
+//     https://www.gnu.org/licenses/gpl-3.0.txt
+
+#pragma once
+#include <h5/h5.hpp>
+#include <mpi/mpi.hpp>
+#include <triqs/utility/exceptions.hpp>
+#include <triqs/utility/timer.hpp>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <complex>
+#include <map>
+#include <optional>
+#include <sstream>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include "./random_generator.hpp"
+#include "./mc_profile.hpp"
+
+namespace triqs::mc_tools {
+
+  /**
+   * Alias table (Walker/Vose method) to draw an index in [0, n[ with given probabilities in O(1),
+   * using a single random number.
+   */
+  class alias_table {
+    std::vector<double> prob;
+    std::vector<size_t> alias;
+
+    public:
+    alias_table() = default;
+
+    /// Build the table from the non-normalized probabilities w. Precondition : w[i] >=0, sum w > 0
+    explicit alias_table(std::vector<double> const &w) : prob(w.size(), 1.0), alias(w.size()) {
+      size_t n  = w.size();
+      double sw = 0;
+      for (auto x : w) {
+        if (x < 0) TRIQS_RUNTIME_ERROR << "alias_table : negative probability " << x;
+        sw += x;
+      }
+      if (n == 0 or sw <= 0) TRIQS_RUNTIME_ERROR << "alias_table : no positive probability";
+
+      // split the rescaled probabilities n * w / sw in the ones below and above 1
+      std::vector<double> p(n);
+      std::vector<size_t> small, large;
+      for (size_t i = 0; i < n; ++i) {
+        p[i]     = n * w[i] / sw;
+        alias[i] = i;
+        (p[i] < 1 ? small : large).push_back(i);
+      }
+      while (not small.empty() and not large.empty()) {
+        size_t s = small.back(), l = large.back();
+        small.pop_back();
+        prob[s]  = p[s];
+        alias[s] = l;
+        p[l] -= 1 - p[s];
+        if (p[l] < 1) {
+          large.pop_back();
+          small.push_back(l);
+        }
+      }
+      // the remaining ones are 1 up to rounding errors
+      for (auto i : small) prob[i] = 1;
+      for (auto i : large) prob[i] = 1;
+    }
+
+    /// Number of entries
+    [[nodiscard]] size_t size() const { return prob.size(); }
+
+    /// Draw an index from a uniform random number u in [0,1[
+    [[nodiscard]] size_t operator()(double u) const {
+      double x = u * prob.size();
+      auto i   = std::min(size_t(x), prob.size() - 1);
+      return (x - i < prob[i] ? i : alias[i]);
+    }
+  };
+
+  //--------------------------------------------------------------------
+
+  /**
+   * A set of moves whose types are known at compile time.
+   *
+   * It is a drop-in replacement for move_set in mc_generic (cf static_mc_generic) :
+   * the move is chosen with an alias table and the calls to attempt/accept/reject are dispatched
+   * with a table of functions, one per move type, in which the move methods can be inlined.
+   * Each move type must appear only once in Moves, and all moves must be added with add before the run.
+   *
+   * @tparam MCSignType  Type of the sign
+   * @tparam Moves       Types of the moves. Must model the Move concept.
+   */
+  template <typename MCSignType, typename... Moves> class static_move_set {
+
+    static constexpr size_t n_moves = sizeof...(Moves);
+    static_assert(n_moves > 0, "static_move_set needs at least one move");
+
+    using moves_t = std::tuple<std::optional<Moves>...>;
+
+    moves_t moves;
+    std::array<std::string, n_moves> names_;
+    std::array<double, n_moves> proba_moves{};
+    std::array<uint64_t, n_moves> NProposed{}, Naccepted{};
+    std::array<double, n_moves> acceptance_rates{};
+    std::array<utility::timer, n_moves> attempt_timers, accept_timers, reject_timers;
+    bool enable_timers = false;
+    alias_table table;
+    random_generator *RNG;
+    size_t current = 0;
+    MCSignType try_sign_ratio;
+
+    // Index of the move of type M in Moves
+    template <typename M> static constexpr size_t index_of() {
+      constexpr std::array<bool, n_moves> is_m{std::is_same_v<M, Moves>...};
+      static_assert((std::is_same_v<M, Moves> + ...) == 1, "static_move_set : the move type must appear exactly once in Moves");
+      size_t i = 0;
+      while (not is_m[i]) ++i;
+      return i;
+    }
+
+    // The dispatch tables
+    template <size_t... Is> static constexpr auto make_attempt_table(std::index_sequence<Is...>) {
+      return std::array<MCSignType (*)(moves_t &), n_moves>{[](moves_t &m) -> MCSignType { return std::get<Is>(m)->attempt(); }...};
+    }
+    template <size_t... Is> static constexpr auto make_accept_table(std::index_sequence<Is...>) {
+      return std::array<MCSignType (*)(moves_t &), n_moves>{[](moves_t &m) -> MCSignType { return std::get<Is>(m)->accept(); }...};
+    }
+    template <size_t... Is> static constexpr auto make_reject_table(std::index_sequence<Is...>) {
+      return std::array<void (*)(moves_t &), n_moves>{[](moves_t &m) { std::get<Is>(m)->reject(); }...};
+    }
+    static constexpr auto attempt_table = make_attempt_table(std::index_sequence_for<Moves...>{});
+    static constexpr auto accept_table  = make_accept_table(std::index_sequence_for<Moves...>{});
+    static constexpr auto reject_table  = make_reject_table(std::index_sequence_for<Moves...>{});
+
+    // Call f(move, index) for all moves
+    template <typename F> void for_each_move(F &&f) {
+      [&]<size_t... Is>(std::index_sequence<Is...>) { (f(std::get<Is>(moves), Is), ...); }(std::index_sequence_for<Moves...>{});
+    }
+    template <typename F> void for_each_move(F &&f) const {
+      [&]<size_t... Is>(std::index_sequence<Is...>) { (f(std::get<Is>(moves), Is), ...); }(std::index_sequence_for<Moves...>{});
+    }
+
+    public:
+    /// Need a random_generator for attempt, see below...
+    static_move_set(random_generator &R) : RNG(&R) { acceptance_rates.fill(-1); }
+
+    static_move_set(static_move_set const &rhs)            = delete;
+    static_move_set(static_move_set &&rhs)                 = default;
+    static_move_set &operator=(static_move_set const &rhs) = delete;
+    static_move_set &operator=(static_move_set &&rhs)      = default;
+
+    /**
+     * Add move M with its probability of being proposed.
+     * The type of M must be one of Moves.
+     * NB : the proposition_probability needs to be >=0 but does not need to be normalized.
+     */
+    template <typename MoveType> void add(MoveType &&M, std::string name, double proposition_probability) {
+      constexpr size_t i = index_of<std::decay_t<MoveType>>();
+      if (std::get<i>(moves)) TRIQS_RUNTIME_ERROR << "static_move_set : add : a move of this type was already added as " << names_[i];
+      std::get<i>(moves).emplace(std::forward<MoveType>(M));
+      names_[i]      = name;
+      proba_moves[i] = proposition_probability;
+      bool complete  = true;
+      for_each_move([&complete](auto const &m, size_t) { complete &= m.has_value(); });
+      if (complete) table = alias_table{std::vector<double>(proba_moves.begin(), proba_moves.end())}; // ready to run when all moves are added
+    }
+
+    /// Access to the move of type M
+    template <typename M> M &get() {
+      auto &m = std::get<index_of<M>()>(moves);
+      if (not m) TRIQS_RUNTIME_ERROR << "static_move_set : get : the move was not added";
+      return *m;
+    }
+
+    private:
+    bool attempt_treat_infinite_ratio(std::complex<double>, double &) { return true; }
+
+    bool attempt_treat_infinite_ratio(double rate_ratio, double &abs_rate_ratio) {
+      bool is_inf = std::isinf(rate_ratio);
+      if (is_inf) {                                           // in case the ratio is infinite
+        abs_rate_ratio = 100;                                 // >1 for metropolis
+        try_sign_ratio = (std::signbit(rate_ratio) ? -1 : 1); // signbit -> true iif the number is negative
+      }
+      return !is_inf;
+    }
+
+    public:
+    /**
+     *  - Picks up one of the move at random (weighted by their proposition probability),
+     *  - Call attempt method of that move
+     *  - Returns the metropolis ratio R (see move concept).
+     *    The sign ratio returned by the try method of the move is kept.
+     */
+    double attempt() {
+      if (table.size() == 0) TRIQS_RUNTIME_ERROR << "ERROR in attempting Monte-Carlo Move: not all moves of the static_move_set were registered!";
+      current = table((*RNG)());
+      NProposed[current]++;
+      if (enable_timers) attempt_timers[current].start();
+      MCSignType rate_ratio = attempt_table[current](moves);
+      if (enable_timers) attempt_timers[current].stop();
+      double abs_rate_ratio;
+      if (attempt_treat_infinite_ratio(rate_ratio, abs_rate_ratio)) { // in case the ratio is infinite
+        if (!std::isfinite(std::abs(rate_ratio)))
+          TRIQS_RUNTIME_ERROR << "Monte Carlo Error : the rate (" << rate_ratio << ") is not finite in move " << names_[current];
+        abs_rate_ratio = std::abs(rate_ratio);
+        try_sign_ratio = (abs_rate_ratio > 1.e-14 ? rate_ratio / abs_rate_ratio : 1); // keep the sign
+      }
+      return abs_rate_ratio;
+    }
+
+    /// Accept the move previously selected and tried. Returns the sign ratio, cf move_set.
+    MCSignType accept() {
+      Naccepted[current]++;
+      if (not enable_timers) return try_sign_ratio * accept_table[current](moves);
+      accept_timers[current].start();
+      MCSignType r = accept_table[current](moves);
+      accept_timers[current].stop();
+      return try_sign_ratio * r;
+    }
+
+    /// Reject the move previously selected and tried.
+    void reject() {
+      if (enable_timers) reject_timers[current].start();
+      reject_table[current](moves);
+      if (enable_timers) reject_timers[current].stop();
+    }
+
+    ///
+    void clear_statistics() {
+      NProposed.fill(0);
+      Naccepted.fill(0);
+      acceptance_rates.fill(-1);
+      attempt_timers.fill({});
+      accept_timers.fill({});
+      reject_timers.fill({});
+    }
+
+    /// Time the calls to the moves, cf get_timings
+    void set_timers(bool enable) { enable_timers = enable; }
+
+    /// Number of calls and time spent in all moves on this node, as a map name -> move_timings
+    std::map<std::string, move_timings> get_timings() const {
+      std::map<std::string, move_timings> r;
+      for (size_t u = 0; u < n_moves; ++u)
+        r.insert({names_[u], {NProposed[u], Naccepted[u], double(attempt_timers[u]), double(accept_timers[u]), double(reject_timers[u])}});
+      return r;
+    }
+
+    ///
+    void collect_statistics(mpi::communicator const &c) {
+      for (size_t u = 0; u < n_moves; ++u) {
+        uint64_t nacc_tot   = mpi::all_reduce(Naccepted[u], c);
+        uint64_t nprop_tot  = mpi::all_reduce(NProposed[u], c);
+        acceptance_rates[u] = nacc_tot / static_cast<double>(nprop_tot);
+      }
+      for_each_move([&c](auto &m, size_t) {
+        if constexpr (requires { m->collect_statistics(c); }) m->collect_statistics(c);
+      });
+    }
+
+    /// Add the statistics of the moves of another static_move_set, e.g. in another walker
+    void merge_statistics(static_move_set const &other) {
+      for (size_t u = 0; u < n_moves; ++u) {
+        NProposed[u] += other.NProposed[u];
+        Naccepted[u] += other.Naccepted[u];
+        attempt_timers[u] += other.attempt_timers[u];
+        accept_timers[u] += other.accept_timers[u];
+        reject_timers[u] += other.reject_timers[u];
+      }
+    }
+
+    /// Write the number of proposed and accepted moves of all moves, e.g. for a checkpoint
+    void h5_write_statistics(h5::group g) const {
+      for (size_t u = 0; u < n_moves; ++u) h5_write(g, names_[u], std::vector<uint64_t>{NProposed[u], Naccepted[u]});
+    }
+
+    /// Read the statistics written by h5_write_statistics
+    void h5_read_statistics(h5::group g) {
+      for (size_t u = 0; u < n_moves; ++u) {
+        auto n       = h5::read<std::vector<uint64_t>>(g, names_[u]);
+        NProposed[u] = n.at(0);
+        Naccepted[u] = n.at(1);
+      }
+    }
+
+    /// Acceptance rate of all moves as a map name:string -> acceptance_rate:double
+    std::map<std::string, double> get_acceptance_rates() const {
+      std::map<std::string, double> r;
+      for (size_t u = 0; u < n_moves; ++u) r.insert({names_[u], acceptance_rates[u]});
+      return r;
+    }
+
+    /// Pretty printing of the acceptance probability of the moves.
+    std::string get_statistics(std::string decal = "") const {
+      std::ostringstream s;
+      for (size_t u = 0; u < n_moves; ++u) s << decal << "Move  " << names_[u] << ": " << acceptance_rates[u] << "\n";
+      return s.str();
+    }
+
+    // HDF5 interface
+    friend void h5_write(h5::group g, std::string const &name, static_move_set const &ms) {
+      auto gr = g.create_group(name);
+      ms.for_each_move([&](auto const &m, size_t u) {
+        if constexpr (requires { h5_write(gr, ms.names_[u], *m); }) h5_write(gr, ms.names_[u], *m);
+      });
+    }
+
+    friend void h5_read(h5::group g, std::string const &name, static_move_set &ms) {
+      auto gr = g.open_group(name);
+      ms.for_each_move([&](auto &m, size_t u) {
+        if constexpr (requires { h5_read(gr, ms.names_[u], *m); }) h5_read(gr, ms.names_[u], *m);
+      });
+    }
+  };
+
+} // namespace triqs::mc_tools
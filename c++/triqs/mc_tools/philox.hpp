@@ -0,0 +1,171 @@
+// Copyright (c) 2026 Simons Foundation
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You may obtain a copy of the License at
+//     https://www.gnu.org/licenses/gpl-3.0.txt
+
+#pragma once
+#include <array>
+#include <cstdint>
+#include <limits>
+
+namespace triqs::mc_tools {
+
+  /**
+   * Counter-based random generator Philox4x32-10 (Salmon, Moraes, Dror, Shaw, SC11).
+   *
+   * The n-th block of 4 random 32 bits integers is a bijection, parametrized by the key (the seed), of the 128 bits counter
+   * (n, stream_id) : n is the position in the stream (64 bits), stream_id selects one of 2^64 streams which do not overlap.
+   * Hence discard (skip-ahead) is O(1), and split(stream_id) gives independent generators e.g. for each rank, thread or walker,
+   * in a way which depends only on the stream_id.
+   *
+   * It models the C++ UniformRandomBitGenerator concept.
+   */
+  class philox4x32 {
+
+    public:
+    using result_type = uint32_t;
+
+    private:
+    using block_t = std::array<uint32_t, 4>;
+
+    static constexpr uint32_t M0 = 0xD2511F53, M1 = 0xCD9E8D57; // multipliers
+    static constexpr uint32_t W0 = 0x9E3779B9, W1 = 0xBB67AE85; // Weyl sequence for the key
+
+    uint64_t key;
+    uint64_t stream     = 0;
+    uint64_t next_block = 0; // position of the next block to generate
+    block_t buf         = {};
+    unsigned buf_pos    = 4; // number of numbers of buf already used
+
+    public:
+    /// The 10 rounds of Philox4x32 on counter c with key (k0, k1)
+    static constexpr block_t bijection(block_t c, uint32_t k0, uint32_t k1) {
+      for (int r = 0; r < 10; ++r) {
+        if (r > 0) {
+          k0 += W0;
+          k1 += W1;
+        }
+        uint64_t p0 = uint64_t(M0) * c[0], p1 = uint64_t(M1) * c[2];
+        c = {uint32_t(p1 >> 32) ^ c[1] ^ k0, uint32_t(p1), uint32_t(p0 >> 32) ^ c[3] ^ k1, uint32_t(p0)};
+      }
+      return c;
+    }
+
+    private:
+    block_t block(uint64_t n) const {
+      return bijection({uint32_t(n), uint32_t(n >> 32), uint32_t(stream), uint32_t(stream >> 32)}, uint32_t(key), uint32_t(key >> 32));
+    }
+
+    // a double in [0,1[ with 53 random bits from two 32 bits integers
+    static double to_double(uint32_t a, uint32_t b) { return double(((uint64_t(a) << 32) | b) >> 11) * 0x1.0p-53; }
+
+    public:
+    /**
+     * @param seed       The key of the generator
+     * @param stream_id  The stream
+     */
+    explicit philox4x32(uint64_t seed = 0, uint64_t stream_id = 0) : key(seed), stream(stream_id) {}
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<uint32_t>::max(); }
+
+    /// The next random integer
+    result_type operator()() {
+      if (buf_pos == 4) {
+        buf     = block(next_block++);
+        buf_pos = 0;
+      }
+      return buf[buf_pos++];
+    }
+
+    /// Skip the next n random integers, in O(1)
+    void discard(uint64_t n) {
+      uint64_t pos = (next_block - 1) * 4 + buf_pos + n; // position of the next number (overflow of next_block - 1 is fine)
+      next_block   = pos / 4;
+      buf          = block(next_block++);
+      buf_pos      = pos % 4;
+    }
+
+    /// A generator with the same seed on another stream, at its beginning
+    [[nodiscard]] philox4x32 split(uint64_t stream_id) const { return philox4x32{key, stream_id}; }
+
+    /// The stream of this generator
+    [[nodiscard]] uint64_t stream_id() const { return stream; }
+
+    /// The seed of this generator
+    [[nodiscard]] uint64_t seed() const { return key; }
+
+    /**
+     * Fill [first, last[ with random doubles in [0,1[, each made of two consecutive random integers.
+     *
+     * The blocks are generated 8 at a time, in a form the compiler can vectorize.
+     * The result is the same as calling to_double((*this)(), (*this)()) for each element.
+     */
+    void fill_uniform(double *first, double *last) {
+      auto scalar_fill = [this](double *f, double *l) {
+        for (; f != l; ++f) {
+          auto a = (*this)();
+          *f     = to_double(a, (*this)());
+        }
+      };
+
+      // not aligned on pairs of integers: no block generation
+      if (buf_pos % 2 == 1) return scalar_fill(first, last);
+
+      // finish the current block
+      for (; first != last and buf_pos != 4; ++first) scalar_fill(first, first + 1);
+
+      constexpr int L = 8; // number of blocks generated together
+      while (last - first >= 2 * L) {
+        uint32_t c0[L], c1[L], c2[L], c3[L];
+        for (int l = 0; l < L; ++l) {
+          uint64_t n = next_block + l;
+          c0[l]      = uint32_t(n);
+          c1[l]      = uint32_t(n >> 32);
+          c2[l]      = uint32_t(stream);
+          c3[l]      = uint32_t(stream >> 32);
+        }
+        uint32_t k0 = uint32_t(key), k1 = uint32_t(key >> 32);
+        for (int r = 0; r < 10; ++r) {
+          if (r > 0) {
+            k0 += W0;
+            k1 += W1;
+          }
+          for (int l = 0; l < L; ++l) {
+            uint64_t p0 = uint64_t(M0) * c0[l], p1 = uint64_t(M1) * c2[l];
+            uint32_t x0 = uint32_t(p1 >> 32) ^ c1[l] ^ k0, x2 = uint32_t(p0 >> 32) ^ c3[l] ^ k1;
+            c1[l]       = uint32_t(p1);
+            c3[l]       = uint32_t(p0);
+            c0[l]       = x0;
+            c2[l]       = x2;
+          }
+        }
+        for (int l = 0; l < L; ++l) {
+          first[2 * l]     = to_double(c0[l], c1[l]);
+          first[2 * l + 1] = to_double(c2[l], c3[l]);
+        }
+        first += 2 * L;
+        next_block += L;
+      }
+
+      scalar_fill(first, last);
+    }
+
+    /// Two generators are equal if they will produce the same sequence
+    friend bool operator==(philox4x32 const &x, philox4x32 const &y) {
+      auto pos = [](philox4x32 const &g) { return (g.next_block - 1) * 4 + g.buf_pos; };
+      return x.key == y.key and x.stream == y.stream and pos(x) == pos(y);
+    }
+  };
+
+} // namespace triqs::mc_tools
@@ -19,13 +19,14 @@
 
 #include "random_generator.hpp"
 #include "./MersenneRNG.hpp"
+#include "./philox.hpp"
 #include "./../utility/macros.hpp"
 //#include <boost/random/uniform_int.hpp>
 #include <boost/random/uniform_real.hpp>
 #include <boost/random/mersenne_twister.hpp>
 #include <boost/random/lagged_fibonacci.hpp>
 #include <boost/random/ranlux.hpp>
-#include <boost/random/variate_generator.hpp>
+#include <algorithm>
 #include <sstream>
 #include <boost/preprocessor/seq.hpp>
 #include <boost/preprocessor/control/if.hpp>
@@ -38,20 +39,66 @@
 namespace triqs {
   namespace mc_tools {
 
+    namespace {
+
+      // List of the counter-based random number generators
+      const std::vector<std::string> counter_based_rng_list = {"philox4x32"};
+
+      // uniform doubles in [0,1[ from philox4x32, refilling a whole buffer at once
+      struct philox_uniform {
+        philox4x32 g;
+        double operator()() {
+          double x;
+          g.fill_uniform(&x, &x + 1);
+          return x;
+        }
+        void fill(double *first, double *last) { g.fill_uniform(first, last); }
+        void discard(uint64_t n) { g.discard(2 * n); } // 2 integers per double
+      };
+
+      // uniform doubles in [0,1[ from a boost engine, whose state can be saved (cf buffered_function::get_state)
+      template <typename Engine> struct boost_uniform {
+        Engine eng;
+        boost::uniform_real<> dis;
+        boost_uniform(Engine eng) : eng(std::move(eng)) {}
+        double operator()() { return dis(eng); }
+        friend std::ostream &operator<<(std::ostream &os, boost_uniform const &g) { return os << g.eng; }
+        friend std::istream &operator>>(std::istream &is, boost_uniform &g) { return is >> g.eng; }
+      };
+
+    } // namespace
+
+    random_generator::random_generator(std::string const &RandomGeneratorName, uint32_t seed_, uint64_t stream_id)
+       : _name(RandomGeneratorName), _seed(seed_), _stream_id(stream_id) {
+      if (RandomGeneratorName == "philox4x32") {
+        gen = utility::buffered_function<double>(philox_uniform{philox4x32{seed_, stream_id}});
+        return;
+      }
+      TRIQS_RUNTIME_ERROR << "The random generator " << RandomGeneratorName << " is not a counter-based generator";
+    }
+
+    bool random_generator::is_counter_based() const {
+      return std::find(counter_based_rng_list.begin(), counter_based_rng_list.end(), _name) != counter_based_rng_list.end();
+    }
+
     random_generator::random_generator(std::string const &RandomGeneratorName, uint32_t seed_) {
       _name = RandomGeneratorName;
+      _seed = seed_;
+
+      if (is_counter_based()) {
+        *this = random_generator(RandomGeneratorName, seed_, 0);
+        return;
+      }
 
       if (RandomGeneratorName == "") {
         gen = utility::buffered_function<double>(mc_tools::RandomGenerators::RandMT(seed_));
         return;
       }
 
-      boost::uniform_real<> dis;
-
 // now boost random number generators
 #define DRNG(r, data, XX)                                                                                                                            \
   if (RandomGeneratorName == AS_STRING(XX)) {                                                                                                        \
-    gen = utility::buffered_function<double>(boost::variate_generator<boost::XX, boost::uniform_real<>>(boost::XX(seed_), dis));                     \
+    gen = utility::buffered_function<double>(boost_uniform<boost::XX>(boost::XX(seed_)));                                                            \
     return;                                                                                                                                          \
   }
 
@@ -64,13 +111,16 @@ namespace triqs {
 
     std::string random_generator_names(std::string const &sep) {
 #define PR(r, sep, p, XX) BOOST_PP_IF(p, +sep +, ) std::string(AS_STRING(XX))
-      return BOOST_PP_SEQ_FOR_EACH_I(PR, sep, RNG_LIST);
+      auto res = BOOST_PP_SEQ_FOR_EACH_I(PR, sep, RNG_LIST);
+      for (auto const &n : counter_based_rng_list) res += sep + n;
+      return res;
     }
 
     std::vector<std::string> random_generator_names_list() {
       std::vector<std::string> res;
 #define PR2(r, sep, p, XX) res.push_back(AS_STRING(XX));
       BOOST_PP_SEQ_FOR_EACH_I(PR2, sep, RNG_LIST);
+      res.insert(res.end(), counter_based_rng_list.begin(), counter_based_rng_list.end());
       return res;
     }
   } // namespace mc_tools
@@ -39,10 +39,15 @@ namespace triqs {
   *
   * The name of the generator is given at construction, and its type is erased in this class.
   * For performance, the call to the generator is bufferized, with chunks of 1000 numbers.
+  *
+  * The counter-based generator philox4x32 has 2^64 independent streams for a given seed,
+  * e.g. one per rank, thread or walker, cf split.
   */
     class random_generator {
       utility::buffered_function<double> gen;
       std::string _name;
+      uint32_t _seed      = 0;
+      uint64_t _stream_id = 0;
 
       public:
       /** Constructor
@@ -51,6 +56,13 @@ namespace triqs {
    */
       random_generator(std::string const &RandomGeneratorName, uint32_t seed_);
 
+      /** Constructor for counter-based generators
+   *  @param RandomGeneratorName : Name of a counter-based generator, e.g. philox4x32
+   *  @param seed : The seed of the random generator
+   *  @param stream_id : The stream of the generator. Different streams are independent.
+   */
+      random_generator(std::string const &RandomGeneratorName, uint32_t seed_, uint64_t stream_id);
+
       random_generator() : random_generator("mt19937", 198) {}
 
       ///
@@ -64,6 +76,43 @@ namespace triqs {
       /// Name of the random generator
       std::string name() const { return _name; }
 
+      /// Is it a counter-based generator, with independent streams ?
+      bool is_counter_based() const;
+
+      /// The seed of the generator
+      uint32_t seed() const { return _seed; }
+
+      /// The stream of a counter-based generator
+      uint64_t stream_id() const { return _stream_id; }
+
+      /// Number of random numbers drawn since construction
+      uint64_t position() const { return gen.position(); }
+
+      /**
+   * Skip the next n random numbers.
+   * It is O(1) for counter-based generators, and costs the generation of the n numbers otherwise.
+   */
+      void advance(uint64_t n) { gen.advance(n); }
+
+      /// Can the state of the generator be saved and restored, cf get_state ? True for the boost generators.
+      bool has_state() const { return gen.has_state(); }
+
+      /**
+   * The state of the generator as a string, to be restored by set_state in a generator with the same name.
+   * Unlike advance, the restoration does not depend on the number of random numbers drawn.
+   * Precondition : has_state()
+   */
+      std::string get_state() const { return gen.get_state(); }
+
+      /// Restore a state written by get_state. Cf get_state
+      void set_state(std::string const &state) { gen.set_state(state); }
+
+      /**
+   * A generator with the same name and seed, on the stream stream_id, at its beginning.
+   * The sequence depends only on (name, seed, stream_id). Only for counter-based generators.
+   */
+      random_generator split(uint64_t stream_id) const { return {_name, _seed, stream_id}; }
+
       /// Returns a integer in [0,i-1] with flat distribution
       template <typename T> typename std::enable_if<std::is_integral<T>::value, T>::type operator()(T i) {
         return (i == 1 ? 0 : T(floor(i * (gen()))));
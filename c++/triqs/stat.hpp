@@ -20,10 +20,12 @@
 #pragma once
 
 #include <triqs/stat/accumulator.hpp>
+#include <triqs/stat/histogram_nd.hpp>
 #include <triqs/stat/histograms.hpp>
 #include <triqs/stat/jackknife.hpp>
 #include <triqs/stat/make_real.hpp>
 #include <triqs/stat/mean_error.hpp>
+#include <triqs/stat/sharded_accumulator.hpp>
 
 #ifdef C2PY_INCLUDED
 #include <c2py/c2py.hpp>
@@ -25,23 +25,83 @@
 #include <mpi/vector.hpp>
 #include <optional>
 #include <triqs/arrays.hpp>
+#include <triqs/utility/exceptions.hpp>
 #include <nda/clef/clef.hpp>
 #include <h5/h5.hpp>
 #include <tuple>
 #include <type_traits>
+#include <utility>
 #include <vector>
 #include <algorithm>
+#include <complex>
+#include <limits>
 
 namespace triqs::stat {
 
   namespace details {
 
+    // The binning updates each data point with element-wise kernels, in place, without temporaries (i.e. heap allocations for arrays).
+    // This is done for scalars and nda arrays (not matrices, for which * is not element-wise).
+    // Other types use their own arithmetic operations.
+    template <typename T> constexpr bool has_elementwise_kernels = nda::is_scalar_v<T> or (nda::MemoryArray<T> and nda::get_algebra<T> != 'M');
+
+    // Call f(y_i, z_i...) for all elements i of y. z are scalars if y is a scalar, or arrays/expressions of the shape of y otherwise.
+    template <typename F, typename Y, typename... Z> void for_each_element(F &&f, Y &y, Z &&...z) {
+      if constexpr (nda::is_scalar_v<Y>) {
+        f(y, z...);
+      } else {
+        EXPECTS(((z.shape() == y.shape()) and ...));
+        // Fast path: all arrays are contiguous with the same layout, a single loop over the storage
+        if constexpr ((nda::MemoryArray<std::decay_t<Z>> and ...)) {
+          if (((z.indexmap().is_contiguous() and z.indexmap().strides() == y.indexmap().strides()) and ...)) {
+            auto *py  = y.data();
+            long size = y.size();
+            std::apply(
+               [&](auto *...pz) {
+                 for (long i = 0; i < size; ++i) f(py[i], pz[i]...);
+               },
+               std::make_tuple(z.data()...));
+            return;
+          }
+        }
+        nda::for_each(y.shape(), [&](auto... i) { f(y(i...), z(i...)...); });
+      }
+    }
+
+    // The real type of a scalar, used to divide it
+    template <typename S> struct divisor {
+      using type = S;
+    };
+    template <typename R> struct divisor<std::complex<R>> {
+      using type = R;
+    };
+    template <typename S> using divisor_t = typename divisor<S>::type;
+
+    // |x|^2 for a real or complex scalar
+    template <typename S> auto abs2(S const &x) {
+      if constexpr (nda::is_complex_v<S>) {
+        return std::norm(x);
+      } else {
+        return x * x;
+      }
+    }
+
+    // y = x, in place for arrays
+    template <typename T, typename U> void assign_in_place(T &y, U const &x) {
+      if constexpr (has_elementwise_kernels<T>) {
+        for_each_element([](auto &a, auto const &b) { a = b; }, y, x);
+      } else {
+        y = x;
+      }
+    }
+
     template <typename T> struct lin_binning {
       long max_n_bins     = 0; // Maximum number of bins
       long bin_capacity   = 1; // Current capacity of each bin (must be >= 1)
       long last_bin_count = 0; // Number of data points the currently active bin [bins.back()]
       std::vector<T> bins;     // Bins with accumulated data (stores means)
       long count = 0;          // Total number of elements added to accumulator: Information only
+      std::vector<T> spare_bins; // Bins freed by compress, whose storage is reused for the next bins
 
       // static std::string hdf5_format() { return "linear_bins"; }
 
@@ -61,16 +121,30 @@ namespace triqs::stat {
         ++count;
         if (max_n_bins == 0) return *this;
         // Check if all bins are full and compress if needed
-        if (max_n_bins > 1 && n_bins() == max_n_bins && last_bin_count == bin_capacity) {
+        if (max_n_bins > 1 && n_bins() == max_n_bins && last_bin_count >= bin_capacity) {
           compress(2); // Adjusts bin_capacity & last_bin_count
         }
         // Check if current bin full: push new bin or add data to current bin
-        if (last_bin_count == bin_capacity && max_n_bins != 1) {
-          bins.emplace_back(std::forward<U>(x));
+        if (last_bin_count >= bin_capacity && max_n_bins != 1) {
+          if (spare_bins.empty()) {
+            bins.emplace_back(std::forward<U>(x));
+          } else {
+            bins.push_back(std::move(spare_bins.back()));
+            spare_bins.pop_back();
+            assign_in_place(bins.back(), x);
+          }
           last_bin_count = 1;
         } else {
           last_bin_count++;
-          bins.back() += (x - bins.back()) / last_bin_count;
+          if constexpr (has_elementwise_kernels<T>) {
+            for_each_element(
+               [c = last_bin_count](auto &b, auto const &xi) {
+                 b += (xi - b) / divisor_t<std::decay_t<decltype(b)>>(c);
+               },
+               bins.back(), x);
+          } else {
+            bins.back() += (x - bins.back()) / last_bin_count;
+          }
         }
         return *this;
       }
@@ -86,27 +160,98 @@ namespace triqs::stat {
           n_bins_last_chunk = bins_left;
         }
         // Compress data into new bins, except the last new bin
+        // NB : swap instead of move, so that the freed bins keep their storage, cf spare_bins
         for (int i = 0; i < n_bins_new - 1; ++i) {
-          if (i != 0) { bins[i] = std::move(bins[compression_factor * i]); }
+          if (i != 0) { std::swap(bins[i], bins[compression_factor * i]); }
           for (int j = 1; j < compression_factor; j++) { bins[i] += bins[compression_factor * i + j]; }
           bins[i] /= compression_factor;
         }
         // Last new bin is special: last old bin could be filled below capacity
         int new_last_bin_count = last_bin_count + (n_bins_last_chunk - 1) * bin_capacity;
         auto &new_last_bin     = bins[n_bins_new - 1];
-        new_last_bin           = std::move(bins[compression_factor * (n_bins_new - 1)]);
+        if (n_bins_new > 1) std::swap(new_last_bin, bins[compression_factor * (n_bins_new - 1)]);
         // If n_bins_last_chunk == 1, we have already copied its value above
         if (n_bins_last_chunk > 1) {
           for (int j = 1; j < n_bins_last_chunk - 1; j++) { new_last_bin += bins[compression_factor * (n_bins_new - 1) + j]; }
           new_last_bin *= bin_capacity; // full bins in last chunk
-          new_last_bin += bins[compression_factor * (n_bins_new - 1) + (n_bins_last_chunk - 1)] * last_bin_count;
+          new_last_bin += bins[compression_factor * (n_bins_new - 1) + (n_bins_last_chunk - 1)] * divisor_t<nda::get_value_t<T>>(last_bin_count);
           new_last_bin /= new_last_bin_count;
         }
         // Adjust final parameters
+        for (long i = n_bins_new; i < n_bins(); ++i) spare_bins.push_back(std::move(bins[i]));
         bins.resize(n_bins_new);
         last_bin_count = new_last_bin_count;
         bin_capacity *= compression_factor;
       }
+
+      // Add the bins of other, with the same max_n_bins.
+      // The bins with the smaller capacity are first compressed to the larger one, which must be a multiple of it.
+      // The full bins of other are appended, and the partial last bins of both are merged into the last bin.
+      // If they hold more than bin_capacity data points together, the overflow is spilled into a new partial last bin,
+      // with the same mean. Hence all the bins but the last one hold exactly bin_capacity data points, as with operator<<,
+      // and the bins have the numbers of data points of a single accumulator fed with all the data.
+      void merge(lin_binning const &other) {
+        if (max_n_bins != other.max_n_bins) TRIQS_RUNTIME_ERROR << "lin_binning : merge : different maximum numbers of bins";
+        long count_self = count;
+        count += other.count;
+        if (max_n_bins == 0 or other.count == 0) return;
+
+        // A single bin, with the mean of all data
+        if (max_n_bins == 1) {
+          double w = other.last_bin_count / double(last_bin_count + other.last_bin_count);
+          if constexpr (has_elementwise_kernels<T>) {
+            for_each_element([w](auto &b, auto const &ob) { b += (ob - b) * w; }, bins[0], other.bins[0]);
+          } else {
+            bins[0] += (other.bins[0] - bins[0]) * w;
+          }
+          last_bin_count += other.last_bin_count;
+          return;
+        }
+
+        auto o = other; // compressed below if needed. Merging is not on the hot path.
+        if (bin_capacity != o.bin_capacity) {
+          auto [small, large] = std::minmax(bin_capacity, o.bin_capacity);
+          if (large % small != 0)
+            TRIQS_RUNTIME_ERROR << "lin_binning : merge : the bin capacities " << bin_capacity << " and " << o.bin_capacity << " are incompatible";
+          (bin_capacity < o.bin_capacity ? *this : o).compress(large / small);
+        }
+
+        // Take the partial last bins out
+        auto take_partial = [cap = bin_capacity](lin_binning &l) {
+          std::optional<T> r;
+          if (l.last_bin_count != cap) {
+            if (l.last_bin_count > 0) r = std::move(l.bins.back());
+            l.bins.pop_back();
+          }
+          return r;
+        };
+        long la = (count_self > 0 ? last_bin_count : 0), lb = o.last_bin_count;
+        auto pa = take_partial(*this), pb = take_partial(o);
+
+        // Append the full bins, then the partial ones, merged
+        for (auto &b : o.bins) bins.push_back(std::move(b));
+        last_bin_count = bin_capacity;
+        if (pa and pb) {
+          double w = lb / double(la + lb);
+          if constexpr (has_elementwise_kernels<T>) {
+            for_each_element([w](auto &b, auto const &ob) { b += (ob - b) * w; }, *pa, *pb);
+          } else {
+            *pa += (*pb - *pa) * w;
+          }
+          bins.push_back(std::move(*pa));
+          last_bin_count = la + lb;
+          if (last_bin_count > bin_capacity) {
+            T spill = bins.back();
+            bins.push_back(std::move(spill));
+            last_bin_count -= bin_capacity;
+          }
+        } else if (pa or pb) {
+          bins.push_back(std::move(pa ? *pa : *pb));
+          last_bin_count = (pa ? la : lb);
+        }
+
+        if (max_n_bins > 1 and n_bins() > max_n_bins) compress((n_bins() + max_n_bins - 1) / max_n_bins);
+      }
     };
 
     template <typename T> void h5_write(h5::group g, std::string const &name, lin_binning<T> const &l) {
@@ -120,6 +265,7 @@ namespace triqs::stat {
     template <typename T> void h5_read(h5::group g, std::string const &name, lin_binning<T> &l) {
       auto gr = g.open_group(name);
       h5_read(gr, "bins", l.bins);
+      l.spare_bins.clear(); // may not have the shape of the bins read
       h5_read(gr, "last_bin_count", l.last_bin_count);
       h5_read(gr, "bin_capacity", l.bin_capacity);
       h5_read(gr, "max_n_bins", l.max_n_bins);
@@ -169,12 +315,52 @@ namespace triqs::stat {
 
       [[nodiscard]] long n_bins() const { return Qk.size(); }
 
+      private:
+      // acc += x
+      template <typename U> static void add(T &acc, U const &x) {
+        if constexpr (has_elementwise_kernels<T>) {
+          for_each_element([](auto &a, auto const &xi) { a += xi; }, acc, x);
+        } else {
+          acc += x;
+        }
+      }
+
+      // Update (M, Q) with the k-th data point x (Scaled = false) or x / scale (Scaled = true), cf formulae above
+      template <bool Scaled, typename U> static void update_MQ(T &M, Q_t &Q, U const &x, long scale, long k) {
+        double r = (k - 1) / double(k);
+        if constexpr (has_elementwise_kernels<T>) {
+          for_each_element(
+             [r, scale, k](auto &m, auto &q, auto const &xi) {
+               using V = std::decay_t<decltype(m)>;
+               using D = divisor_t<V>;
+               V x_m;
+               if constexpr (Scaled) {
+                 x_m = xi / D(scale) - m;
+               } else {
+                 x_m = xi - m;
+               }
+               q += static_cast<std::decay_t<decltype(q)>>(r) * abs2(x_m);
+               m += x_m / D(k);
+             },
+             M, Q, x);
+        } else {
+          using nda::conj;
+          T x_m = [&]() -> T { // Force T if expression template.
+            if constexpr (Scaled) {
+              return x / scale - M;
+            } else {
+              return x - M;
+            }
+          }();
+          Q += static_cast<nda::get_value_t<Q_t>>(r) * make_real(conj(x_m) * x_m);
+          M += x_m / k;
+        }
+      }
+
+      public:
       template <typename U> log_binning<T> &operator<<(U const &x) {
         if (max_n_bins == 0) return *this;
 
-        using nda::conj;
-        using nda::real;
-
         ++count;
 
         // If max_n_bins == 1, there is only one (Mk, Qk) and we skip direclty to updating that below
@@ -185,9 +371,9 @@ namespace triqs::stat {
           int n = 0;
           for (; n < acc.size(); ++n) {
             if (n == 0) {
-              acc[n] += x; // n = 0 case is special, as it involves new data input
+              add(acc[n], x); // n = 0 case is special, as it involves new data input
             } else {
-              acc[n] += acc[n - 1];
+              add(acc[n], acc[n - 1]);
             }
             acc_count[n]++;
             if (acc_count[n] < 2) break;
@@ -211,24 +397,95 @@ namespace triqs::stat {
 
           n--;
           for (; n >= 0; n--) {
-            auto bin_capacity = (1ul << (n + 1));                    // 2^(n+1)
-            T x_m             = (acc[n] / bin_capacity - Mk[n + 1]); // Force T if expression template.
-            auto k            = count / bin_capacity;
-            Qk[n + 1] += static_cast<nda::get_value_t<Q_t>>((k - 1) / double(k)) * make_real(conj(x_m) * x_m);
-            Mk[n + 1] += x_m / k;
+            long bin_capacity = (1l << (n + 1)); // 2^(n+1)
+            update_MQ<true>(Mk[n + 1], Qk[n + 1], acc[n], bin_capacity, count / bin_capacity);
             acc_count[n] = 0;
             acc[n]       = 0;
           }
         }
 
         // Update the (Mk, Qk) pair with no binning (bin capacity: 2^0)
-        auto k = count;
-        T x_m  = (x - Mk[0]);
-        Qk[0] += static_cast<nda::get_value_t<Q_t>>((k - 1) / double(k)) * make_real(conj(x_m) * x_m);
-        Mk[0] += x_m / k;
+        update_MQ<false>(Mk[0], Qk[0], x, 1, count);
 
         return *this;
       }
+
+      /**
+       * Add the data of other, with the same max_n_bins.
+       *
+       * At each level, the (M, Q) of the complete bins of both are combined exactly (Chan, Golub, LeVeque).
+       * Then the partial accumulators of other are added to the ones of this, as in operator<<,
+       * which completes new bins when both have a partial bin at the same level (as in a binary addition).
+       * The result is the (M, Q) of a binning of all the data, with count >> n bins at level n.
+       */
+      void merge(log_binning const &other) {
+        if (max_n_bins != other.max_n_bins) TRIQS_RUNTIME_ERROR << "log_binning : merge : different maximum numbers of bins";
+        if (max_n_bins == 0 or other.count == 0) return;
+        long count_self = count;
+        count += other.count;
+
+        // Add the levels of the new count, cf operator<<
+        long n_levels = 1;
+        while ((1l << n_levels) <= count) ++n_levels;
+        auto zero = [](auto x) {
+          x = 0;
+          return x;
+        };
+        while (n_bins() < (max_n_bins < 0 ? n_levels : std::min<long>(max_n_bins, n_levels))) {
+          Mk.push_back(zero(Mk[0]));
+          Qk.push_back(zero(Qk[0]));
+        }
+        while (long(acc.size()) < (max_n_bins < 0 ? n_levels : std::min<long>(max_n_bins - 1, n_levels))) {
+          acc.push_back(zero(Mk[0]));
+          acc_count.push_back(0);
+        }
+
+        // Combine the complete bins
+        std::vector<long> n_complete(n_bins());
+        for (long n = 0; n < n_bins(); ++n) {
+          long na = (count_self >> n), nb = (n < other.n_bins() ? (other.count >> n) : 0);
+          n_complete[n] = na + nb;
+          if (nb == 0) continue;
+          if (na == 0) {
+            assign_in_place(Mk[n], other.Mk[n]);
+            assign_in_place(Qk[n], other.Qk[n]);
+            continue;
+          }
+          double wb = nb / double(na + nb), wq = na * wb;
+          if constexpr (has_elementwise_kernels<T>) {
+            for_each_element(
+               [wb, wq](auto &m, auto &q, auto const &om, auto const &oq) {
+                 auto d = om - m;
+                 q += oq + static_cast<std::decay_t<decltype(q)>>(wq) * abs2(d);
+                 m += d * wb;
+               },
+               Mk[n], Qk[n], other.Mk[n], other.Qk[n]);
+          } else {
+            using nda::conj;
+            T d = other.Mk[n] - Mk[n];
+            Qk[n] += other.Qk[n] + static_cast<nda::get_value_t<Q_t>>(wq) * make_real(conj(d) * d);
+            Mk[n] += d * wb;
+          }
+        }
+
+        // Add the partial accumulators of other, level by level, with the carry to the next level as in operator<<
+        for (long l = 0; l < long(other.acc.size()); ++l) {
+          if (other.acc_count[l] == 0) continue;
+          T carry = other.acc[l];
+          for (long n = l; n < long(acc.size()); ++n) {
+            if (acc_count[n] == 0) {
+              assign_in_place(acc[n], carry);
+              acc_count[n] = 1;
+              break;
+            }
+            add(acc[n], carry); // a new complete bin of level n + 1
+            if (n + 1 < n_bins()) update_MQ<true>(Mk[n + 1], Qk[n + 1], acc[n], 1l << (n + 1), ++n_complete[n + 1]);
+            std::swap(carry, acc[n]);
+            acc_count[n] = 0;
+            acc[n]       = 0;
+          }
+        }
+      }
     };
 
     // HDF5
@@ -396,6 +653,21 @@ namespace triqs::stat {
       return *this;
     }
 
+    /// Add the data of another accumulator, with the same numbers of bins, e.g. filled by another thread or restored from a checkpoint.
+    /// The logarithmic bins are combined exactly: the errors are the ones of a binning of all the data.
+    /// The linear bins of other are appended, after compressing the bins of the smaller capacity if needed.
+    /// The partial last bins of the two accumulators are merged into one, which may then contain more than the bin capacity.
+    ///
+    /// @brief Merge another accumulator into this one
+    /// @param other The accumulator to merge
+    void merge(accumulator<T> const &other) {
+      if (n_log_bins_max() != other.n_log_bins_max() or n_lin_bins_max() != other.n_lin_bins_max())
+        TRIQS_RUNTIME_ERROR << "accumulator : merge : the accumulators have different maximum numbers of bins";
+      count += other.count;
+      log_bins.merge(other.log_bins);
+      lin_bins.merge(other.lin_bins);
+    }
+
     /// Returns the standard errors for data with different power-of-two capacity.
     /// @return std::vector, where element v[n] contains the standard error of data binned with a bin capacity of $2^n$. The return type is deduced from nda::real(T), where T is the type defining the accumulator.
     /// @brief Get standard errors of log binned data
@@ -419,6 +691,86 @@ namespace triqs::stat {
       return std::make_pair(res1, count_vec);
     }
 
+    /// Returns the binning level used by the estimates of the autocorrelation time and of the error below:
+    /// the largest level $n$ of the logarithmic bins with at least min_n_bins bins of capacity $2^n$, or 0.
+    /// NB : The errors need not have converged at this level, cf has_plateau.
+    /// @brief Binning level of the autocorrelation estimates
+    /// @param min_n_bins Minimal number of bins at this level. The relative error of the error estimate is about $1/\sqrt{2 \cdot \texttt{min_n_bins}}$.
+    [[nodiscard]] int plateau_level(long min_n_bins = 32) const {
+      int n = 0;
+      while (n + 1 < log_bins.n_bins() and (log_bins.count >> (n + 1)) >= min_n_bins) ++n;
+      return n;
+    }
+
+    /// Whether the errors of the logarithmic bins have reached a plateau: the level $n$ = plateau_level(min_n_bins) is at least
+    /// min_level, and the error at level $n$ exceeds the one at level $n - 1$ by at most a fraction tolerance, for all elements.
+    /// As long as the bins are not large compared to the autocorrelation time, the errors still grow with the level
+    /// and underestimate the error of the mean.
+    /// @brief Convergence of the binning analysis
+    /// @param min_n_bins Minimal number of bins at the binning level used
+    /// @param min_level Minimal binning level, i.e. the bins hold at least $2^\texttt{min_level}$ data points
+    /// @param tolerance Maximal relative growth of the error between the last two levels
+    [[nodiscard]] bool has_plateau(long min_n_bins = 32, int min_level = 4, double tolerance = 0.1) const {
+      static_assert(details::has_elementwise_kernels<T>, "accumulator::has_plateau is only implemented for scalars and arrays");
+      if (log_bins.n_bins() == 0) TRIQS_RUNTIME_ERROR << "accumulator : has_plateau requires the logarithmic binning";
+      int n = plateau_level(min_n_bins);
+      if (n < std::max(min_level, 1)) return false;
+      auto [errors, counts] = log_bin_errors();
+      bool r                = true;
+      details::for_each_element([&r, tolerance](auto const &e, auto const &e1) { r = r and (e <= (1 + tolerance) * e1); }, errors[n], errors[n - 1]);
+      return r;
+    }
+
+    /// Estimate of the integrated autocorrelation time $\tau$ of the data, element-wise for arrays.
+    /// It is tau_estimate_from_errors at the binning level plateau_level(min_n_bins): it is available at any time of the accumulation,
+    /// for O(log(N)) operations, and is underestimated as long as $2^n$ is not large compared to $\tau$.
+    /// It is negative for anticorrelated data. Elements without fluctuations have $\tau = 0$. Requires the logarithmic binning.
+    /// @brief Integrated autocorrelation time
+    /// @param min_n_bins Minimal number of bins at the binning level used
+    /// @return $\tau$, of type nda::real(T)
+    [[nodiscard]] auto tau_int(long min_n_bins = 32) const {
+      static_assert(details::has_elementwise_kernels<T>, "accumulator::tau_int is only implemented for scalars and arrays");
+      if (log_bins.n_bins() == 0) TRIQS_RUNTIME_ERROR << "accumulator : tau_int requires the logarithmic binning";
+      auto [errors, counts] = log_bin_errors();
+      auto tau              = errors[plateau_level(min_n_bins)];
+      details::for_each_element([](auto &t, auto const &e0) { t = (e0 > 0 ? 0.5 * ((t * t) / (e0 * e0) - 1) : 0); }, tau, errors[0]);
+      return tau;
+    }
+
+    /// Estimate of the effective number of independent samples, $N / (1 + 2 \tau)$, element-wise for arrays. Cf tau_int.
+    /// @brief Effective sample size
+    /// @param min_n_bins Minimal number of bins at the binning level used
+    /// @return The effective sample size, of type nda::real(T)
+    [[nodiscard]] auto effective_sample_size(long min_n_bins = 32) const {
+      auto ess = tau_int(min_n_bins);
+      details::for_each_element([n = double(log_bins.count)](auto &x) { x = n / (1 + 2 * x); }, ess);
+      return ess;
+    }
+
+    /// Estimate of the relative error of the mean: the error at the binning level plateau_level(min_n_bins), divided by the
+    /// modulus of the mean. For arrays, the maximum over the elements. Elements with a zero mean and error are ignored.
+    /// As long as the errors have not reached a plateau (cf has_plateau), the error is underestimated and +infinity is returned.
+    /// Typically used to stop the accumulation at a target error, cf mc_generic::set_target_error.
+    /// @brief Relative error of the mean
+    /// @param min_n_bins Minimal number of bins at the binning level used
+    /// @param min_level Minimal binning level, cf has_plateau
+    /// @param tolerance Maximal relative growth of the error between the last two levels, cf has_plateau
+    /// @return The relative error, or +infinity if the errors have not reached a plateau
+    [[nodiscard]] double relative_error(long min_n_bins = 32, int min_level = 4, double tolerance = 0.1) const {
+      static_assert(details::has_elementwise_kernels<T>, "accumulator::relative_error is only implemented for scalars and arrays");
+      if (log_bins.n_bins() == 0) TRIQS_RUNTIME_ERROR << "accumulator : relative_error requires the logarithmic binning";
+      if (not has_plateau(min_n_bins, min_level, tolerance)) return std::numeric_limits<double>::infinity();
+      auto [errors, counts] = log_bin_errors();
+      double r              = 0;
+      details::for_each_element(
+         [&r](auto const &e, auto const &m) {
+           using std::abs;
+           if (e > 0) r = std::max(r, double(e / abs(m)));
+         },
+         errors[plateau_level(min_n_bins)], log_bins.Mk[0]);
+      return r;
+    }
+
     /// Returns the standard errors for data with different power-of-two capacity, reduced from data over all MPI threads. The final answer is reduced only to the zero MPI thread (not all reduce).
     /// @param c TRIQS MPI communicator
     /// @return std::vector, where element v[n] contains the standard error of data binned with a bin capacity of $2^n$. The return type is deduced from nda::real(T), where T is the type defining the accumulator. Reduced only to zero MPI thread.
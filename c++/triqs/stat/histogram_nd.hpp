@@ -0,0 +1,254 @@
+// Copyright (c) 2026 Simons Foundation
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You may obtain a copy of the License at
+//     https://www.gnu.org/licenses/gpl-3.0.txt
+
+#pragma once
+#include "./histograms.hpp"
+#include <cmath>
+#include <string>
+#include <vector>
+
+namespace triqs::stat {
+
+  /// Histogram of a random variable with R real components, e.g. (expansion order, segment length) pairs.
+  /// Each axis k divides the range :math:`[a_k; b_k]` into n_bins_k bins, with the convention of histogram:
+  /// the bin n of the axis is centered on :math:`a_k + n h_k`, with :math:`h_k = (b_k - a_k) / (n_{\mathrm{bins},k} - 1)`.
+  /// A sample is discarded if one of its components is out of range.
+  /// The samples can be weighted, and binned one at a time or by batches.
+  ///
+  /// @tparam R Number of components of the samples
+  /// @brief Multidimensional statistical histogram
+  template <int R> class histogram_nd {
+    static_assert(R >= 1, "histogram_nd: R must be >= 1");
+
+    public:
+    /// A sample
+    using point_t = std::array<double, R>;
+
+    private:
+    point_t a = {}, b = {};             // start and end of the mesh on each axis
+    point_t step = {};                  // number of bins per unit length on each axis
+    unsigned long long _n_data_pts = 0; // number of data points
+    unsigned long long _n_lost_pts = 0; // number of discarded points
+    nda::array<double, R> _data;        // histogram data
+
+    void _init() {
+      for (int k = 0; k < R; ++k) {
+        if (a[k] >= b[k]) TRIQS_RUNTIME_ERROR << "histogram_nd construction: one must have a<b on axis " << k;
+        if (_data.extent(k) < 2) TRIQS_RUNTIME_ERROR << "histogram_nd construction: at least 2 bins are needed on axis " << k;
+        step[k] = (_data.extent(k) - 1) / (b[k] - a[k]);
+      }
+    }
+
+    std::array<long, R> strides() const {
+      std::array<long, R> s;
+      s[R - 1] = 1;
+      for (int k = R - 2; k >= 0; --k) s[k] = s[k + 1] * _data.extent(k + 1);
+      return s;
+    }
+
+    // the position in _data of x, or -1 if x is out of range or NaN
+    long index(point_t const &x) const {
+      long l = 0;
+      auto s = strides();
+      for (int k = 0; k < R; ++k) {
+        if (!(x[k] >= a[k] && x[k] <= b[k])) return -1;
+        l += long(std::floor(((x[k] - a[k]) * step[k]) + 0.5)) * s[k];
+      }
+      return l;
+    }
+
+    public:
+    /// Constructs a histogram over :math:`[a_0; b_0] \times \ldots \times [a_{R-1}; b_{R-1}]` with a given number of bins on each axis.
+    ///
+    /// @param a Left ends of the sampling range
+    /// @param b Right ends of the sampling range
+    /// @param n_bins Numbers of bins
+    histogram_nd(point_t const &a, point_t const &b, std::array<long, R> const &n_bins) : a(a), b(b), _data(n_bins) {
+      _data() = 0.0;
+      _init();
+    }
+
+    /// Default constructor
+    histogram_nd() = default;
+
+    /// Bins a sample into the histogram
+    /// @param x Sampled value
+    /// @return Reference to `*this`, so that it is possible to chain `operator<<` calls
+    /// @brief Bin a sample into the histogram
+    histogram_nd &operator<<(point_t const &x) { return push(x, 1.0); }
+
+    /// Bins a sample with a weight: the weight is added to its bin instead of 1.
+    /// The numbers of accumulated and discarded points count the samples, whatever their weights.
+    /// @param x Sampled value
+    /// @param w Weight of the sample
+    /// @return Reference to `*this`
+    /// @brief Bin a sample with a weight into the histogram
+    histogram_nd &push(point_t const &x, double w) {
+      auto l = index(x);
+      if (l < 0)
+        ++_n_lost_pts;
+      else {
+        _data.data()[l] += w;
+        ++_n_data_pts;
+      }
+      return *this;
+    }
+
+    /// Bins a batch of samples, with the same result as operator<< on each of them.
+    /// The bin indices are computed by blocks, in a loop the compiler can vectorize.
+    /// Large batches are split over n_threads threads, which bin into partial histograms summed at the end.
+    /// @param xs Sampled values
+    /// @param n_threads Maximal number of threads
+    /// @brief Bin a batch of samples into the histogram
+    void push_batch(std::span<point_t const> xs, int n_threads = 1) {
+      auto n_lost = details::bin_batch<R, false>(a, b, step, strides(), reinterpret_cast<double const *>(xs.data()), nullptr, xs.size(), _data.data(), _data.size(), n_threads);
+      _n_lost_pts += n_lost;
+      _n_data_pts += xs.size() - n_lost;
+    }
+
+    /// Bins a batch of samples with weights, with the same result as push on each of them, up to rounding. Cf push_batch.
+    /// @param xs Sampled values
+    /// @param ws Weights of the samples, of the same size as xs
+    /// @param n_threads Maximal number of threads
+    /// @brief Bin a batch of samples with weights into the histogram
+    void push_batch(std::span<point_t const> xs, std::span<double const> ws, int n_threads = 1) {
+      if (xs.size() != ws.size()) TRIQS_RUNTIME_ERROR << "histogram_nd::push_batch: " << xs.size() << " values but " << ws.size() << " weights";
+      auto n_lost = details::bin_batch<R, true>(a, b, step, strides(), reinterpret_cast<double const *>(xs.data()), ws.data(), xs.size(), _data.data(), _data.size(), n_threads);
+      _n_lost_pts += n_lost;
+      _n_data_pts += xs.size() - n_lost;
+    }
+
+    /// Get position of bin's center along an axis
+    /// @param k Axis
+    /// @param n Bin index along the axis
+    /// @return Position of the center, :math:`a_k + n h_k`
+    /// @brief Get position of bin's center along an axis
+    [[nodiscard]] double mesh_point(int k, long n) const { return a[k] + n / step[k]; }
+
+    /// Get numbers of bins along each axis
+    /// @brief Get numbers of bins along each axis
+    [[nodiscard]] auto shape() const { return _data.shape(); }
+
+    /// Get boundaries of the histogram along an axis
+    /// @param k Axis
+    /// @return Pair of histogram boundaries, `(a_k,b_k)`
+    /// @brief Get boundaries of the histogram along an axis
+    [[nodiscard]] std::pair<double, double> limits(int k) const { return {a[k], b[k]}; }
+
+    /// Read-only access to the data storage
+    /// @return Constant reference to the histogram data array
+    /// @brief Read-only access to the data storage
+    [[nodiscard]] nda::array<double, R> const &data() const { return _data; }
+
+    /// Get number of accumulated samples
+    /// @brief Get number of accumulated samples
+    [[nodiscard]] unsigned long long n_data_pts() const { return _n_data_pts; }
+
+    /// Get number of discarded samples
+    /// @brief Get number of discarded samples
+    [[nodiscard]] unsigned long long n_lost_pts() const { return _n_lost_pts; }
+
+    /// Resets all data values and the total counts of accumulated and discarded points.
+    /// @brief Reset all histogram values to 0
+    void clear() {
+      _n_lost_pts = 0;
+      _n_data_pts = 0;
+      _data()     = 0.0;
+    }
+
+    /// Compute the sum of two histograms over the same ranges, and with equal numbers of bins.
+    /// This operator will throw if histograms to be added up are incompatible.
+    /// @brief Addition of histograms
+    friend histogram_nd operator+(histogram_nd h1, histogram_nd const &h2) {
+      if (h1.a != h2.a || h1.b != h2.b || h1.shape() != h2.shape()) TRIQS_RUNTIME_ERROR << "histogram_nd: histograms with different meshes in addition";
+      h1._data += h2._data;
+      h1._n_data_pts += h2._n_data_pts;
+      h1._n_lost_pts += h2._n_lost_pts;
+      return h1;
+    }
+
+    /// Comparison operator
+    bool operator==(histogram_nd const &h) const {
+      return a == h.a && b == h.b && _data == h._data && _n_data_pts == h._n_data_pts && _n_lost_pts == h._n_lost_pts;
+    }
+
+    /// Normalise histogram to get probability density function (PDF), by the total weight of the accumulated samples
+    /// @brief Get histogram probability density function (PDF)
+    friend histogram_nd pdf(histogram_nd const &h) {
+      auto pdf = h;
+      pdf._data /= sum(h._data);
+      return pdf;
+    }
+
+    /// MPI-broadcast histogram
+    /// @brief MPI-broadcast histogram
+    friend void mpi_broadcast(histogram_nd &h, mpi::communicator c = {}, int root = 0) {
+      for (int k = 0; k < R; ++k) {
+        mpi::broadcast(h.a[k], c, root);
+        mpi::broadcast(h.b[k], c, root);
+      }
+      mpi::broadcast(h._data, c, root);
+      mpi::broadcast(h._n_data_pts, c, root);
+      mpi::broadcast(h._n_lost_pts, c, root);
+      if (c.rank() != root) h._init();
+    }
+
+    /// MPI-reduce histogram.
+    /// The only supported reduction operation is MPI_SUM, which is equivalent to `operator+()`.
+    /// @return Reduction result; valid only on MPI rank 0 if `all = false`
+    /// @brief MPI-reduce histogram
+    friend histogram_nd mpi_reduce(histogram_nd const &h, mpi::communicator c = {}, int root = 0, bool all = false, MPI_Op op = MPI_SUM) {
+      TRIQS_ASSERT(op == MPI_SUM);
+      histogram_nd h2(h.a, h.b, h.shape());
+      h2._data       = mpi::reduce(h._data, c, root, all, MPI_SUM);
+      h2._n_data_pts = mpi::reduce(h._n_data_pts, c, root, all, MPI_SUM);
+      h2._n_lost_pts = mpi::reduce(h._n_lost_pts, c, root, all, MPI_SUM);
+      return h2;
+    }
+
+    /// Get HDF5 format name
+    /// @brief Get HDF5 format name
+    [[nodiscard]] static std::string hdf5_format() { return "HistogramND"; }
+
+    /// Write histogram to HDF5
+    /// @brief Write histogram to HDF5
+    friend void h5_write(h5::group g, std::string const &name, histogram_nd const &h) {
+      auto gr = g.create_group(name);
+      write_hdf5_format(gr, h);
+      h5_write(gr, "data", h._data);
+      h5_write(gr, "a", std::vector<double>(h.a.begin(), h.a.end()));
+      h5_write(gr, "b", std::vector<double>(h.b.begin(), h.b.end()));
+      h5_write(gr, "n_data_pts", h._n_data_pts);
+      h5_write(gr, "n_lost_pts", h._n_lost_pts);
+    }
+
+    /// Read histogram from HDF5
+    /// @brief Read histogram form HDF5
+    friend void h5_read(h5::group g, std::string const &name, histogram_nd &h) {
+      auto gr = g.open_group(name);
+      std::vector<double> a, b;
+      h5_read(gr, "data", h._data);
+      h5_read(gr, "a", a);
+      h5_read(gr, "b", b);
+      if (a.size() != R || b.size() != R) TRIQS_RUNTIME_ERROR << "histogram_nd: the histogram " << name << " in hdf5 is not of rank " << R;
+      std::copy(a.begin(), a.end(), h.a.begin());
+      std::copy(b.begin(), b.end(), h.b.begin());
+      h5_read(gr, "n_data_pts", h._n_data_pts);
+      h5_read(gr, "n_lost_pts", h._n_lost_pts);
+      h._init();
+    }
+  };
+
+} // namespace triqs::stat
@@ -37,7 +37,7 @@ namespace triqs::stat {
   }
 
   histogram &histogram::operator<<(double x) {
-    if ((x < a) || (x > b))
+    if (!(x >= a && x <= b)) // also discards NaN
       ++_n_lost_pts;
     else {
       auto n = int(std::floor(((x - a) * _step) + 0.5));
@@ -47,6 +47,30 @@ namespace triqs::stat {
     return *this;
   }
 
+  histogram &histogram::push(double x, double w) {
+    if (!(x >= a && x <= b)) // also discards NaN
+      ++_n_lost_pts;
+    else {
+      auto n = int(std::floor(((x - a) * _step) + 0.5));
+      _data[n] += w;
+      ++_n_data_pts;
+    }
+    return *this;
+  }
+
+  void histogram::push_batch(std::span<double const> xs, int n_threads) {
+    auto n_lost = details::bin_batch<1, false>({a}, {b}, {_step}, {1}, xs.data(), nullptr, xs.size(), _data.data(), n_bins, n_threads);
+    _n_lost_pts += n_lost;
+    _n_data_pts += xs.size() - n_lost;
+  }
+
+  void histogram::push_batch(std::span<double const> xs, std::span<double const> ws, int n_threads) {
+    if (xs.size() != ws.size()) TRIQS_RUNTIME_ERROR << "histogram::push_batch: " << xs.size() << " values but " << ws.size() << " weights";
+    auto n_lost = details::bin_batch<1, true>({a}, {b}, {_step}, {1}, xs.data(), ws.data(), xs.size(), _data.data(), n_bins, n_threads);
+    _n_lost_pts += n_lost;
+    _n_data_pts += xs.size() - n_lost;
+  }
+
   histogram operator+(histogram h1, histogram const &h2) {
     auto l1 = h1.limits(), l2 = h2.limits();
     if (l1 != l2 || h1.size() != h2.size()) {
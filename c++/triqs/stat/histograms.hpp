@@ -23,10 +23,87 @@
 #include <triqs/utility/macros.hpp>
 #include <triqs/arrays.hpp>
 #include <nda/mpi.hpp>
+#include <algorithm>
+#include <array>
 #include <ostream>
+#include <span>
+#include <thread>
+#include <vector>
 
 namespace triqs::stat {
 
+  namespace details {
+
+    // Bin the n points x (R coordinates each) with the weights w (1 if Weighted is false) into data,
+    // for the mesh (a, b, step) of each axis and the strides of data. Returns the number of lost points.
+    // The points are processed by blocks: first the linear indices of the bins (-1 out of range), in a loop
+    // without branches that the compiler vectorizes, then the (scattered) additions.
+    // NB : (x - a) * step + 0.5 >= 0 in range, so the truncation is the floor of operator<<.
+    template <int R, bool Weighted>
+    unsigned long long bin_points(std::array<double, R> const &a, std::array<double, R> const &b, std::array<double, R> const &step,
+                                  std::array<long, R> const &strides, double const *x, double const *w, long n, double *data) {
+      constexpr long B = 256;
+      long idx[B];
+      unsigned long long n_lost = 0;
+      for (long start = 0; start < n; start += B) {
+        long m           = std::min(B, n - start);
+        double const *xs = x + start * R;
+        for (long i = 0; i < m; ++i) {
+          bool in = true;
+          long l  = 0;
+          for (int k = 0; k < R; ++k) {
+            double xk = xs[i * R + k];
+            in        = in & (xk >= a[k]) & (xk <= b[k]);
+            l += long(in ? (xk - a[k]) * step[k] + 0.5 : 0.0) * strides[k];
+          }
+          idx[i] = (in ? l : -1);
+        }
+        for (long i = 0; i < m; ++i) {
+          if (idx[i] < 0)
+            ++n_lost;
+          else if constexpr (Weighted)
+            data[idx[i]] += w[start + i];
+          else
+            data[idx[i]] += 1;
+        }
+      }
+      return n_lost;
+    }
+
+    // Same as bin_points, on n_threads threads for large batches. Each thread bins a part of the points
+    // into its own partial histogram, and the partial histograms are summed into data at the end.
+    template <int R, bool Weighted>
+    unsigned long long bin_batch(std::array<double, R> const &a, std::array<double, R> const &b, std::array<double, R> const &step,
+                                 std::array<long, R> const &strides, double const *x, double const *w, long n, double *data, long data_size,
+                                 int n_threads) {
+      constexpr long min_points_per_thread = 4096;
+      n_threads                            = int(std::clamp<long>(n / min_points_per_thread, 1, std::max(n_threads, 1)));
+      if (n_threads == 1) return bin_points<R, Weighted>(a, b, step, strides, x, w, n, data);
+
+      std::vector<std::vector<double>> partial(n_threads - 1);
+      std::vector<unsigned long long> n_lost(n_threads, 0);
+      auto run = [&](int t) {
+        long first = n * t / n_threads, last = n * (t + 1) / n_threads;
+        double *d  = data;
+        if (t > 0) {
+          partial[t - 1].assign(data_size, 0.0);
+          d = partial[t - 1].data();
+        }
+        n_lost[t] = bin_points<R, Weighted>(a, b, step, strides, x + first * R, (Weighted ? w + first : nullptr), last - first, d);
+      };
+      std::vector<std::thread> threads;
+      for (int t = 1; t < n_threads; ++t) threads.emplace_back(run, t);
+      run(0);
+      for (auto &th : threads) th.join();
+      for (auto const &p : partial)
+        for (long i = 0; i < data_size; ++i) data[i] += p[i];
+      unsigned long long r = 0;
+      for (auto l : n_lost) r += l;
+      return r;
+    }
+
+  } // namespace details
+
   /// This class serves to sample a continuous random variable, and to 'bin' it.
   /// It divides a given range of real values into a series of equal intervals,
   /// and counts amounts of samples falling into each interval.
@@ -76,6 +153,33 @@ namespace triqs::stat {
     /// @brief Bin a real value into the histogram
     histogram &operator<<(double x);
 
+    /// Bins a real value with a weight: the weight is added to its bin instead of 1, cf operator<<.
+    /// The numbers of accumulated and discarded points count the samples, whatever their weights.
+    ///
+    /// @param x Sampled value
+    /// @param w Weight of the sample
+    /// @return Reference to `*this`
+    /// @brief Bin a real value with a weight into the histogram
+    histogram &push(double x, double w);
+
+    /// Bins a batch of real values, with the same result as operator<< on each of them.
+    /// The bin indices are computed by blocks, in a loop the compiler can vectorize.
+    /// Large batches are split over n_threads threads, which bin into partial histograms summed at the end.
+    ///
+    /// @param xs Sampled values
+    /// @param n_threads Maximal number of threads
+    /// @brief Bin a batch of real values into the histogram
+    void push_batch(std::span<double const> xs, int n_threads = 1);
+
+    /// Bins a batch of real values with weights, with the same result as push on each of them, up to rounding.
+    /// Cf push_batch.
+    ///
+    /// @param xs Sampled values
+    /// @param ws Weights of the samples, of the same size as xs
+    /// @param n_threads Maximal number of threads
+    /// @brief Bin a batch of real values with weights into the histogram
+    void push_batch(std::span<double const> xs, std::span<double const> ws, int n_threads = 1);
+
     /// Get position of bin's center
     /// @param n Bin index
     /// @return Position of the center, :math:`n (b - a) / (n_\mathrm{bins} - 1)`
@@ -200,23 +304,25 @@ namespace triqs::stat {
   //-------------------------------------------------------------------------------
 
   /// Normalise histogram to get probability density function (PDF)
+  /// The normalization is the total weight of the accumulated samples, i.e. their number without weights.
   /// @param h Histogram to be normalized
   /// @return Probability density function
   /// @brief Get histogram probability density function (PDF)
   inline histogram pdf(histogram const &h) {
     auto pdf = h;
-    pdf._data /= double(h.n_data_pts());
+    pdf._data /= sum(h._data);
     return pdf;
   }
 
   /// Integrate and normalise histogram to get cumulative distribution function (CDF)
+  /// The normalization is the total weight of the accumulated samples, i.e. their number without weights.
   /// @param h Histogram to be integrated and normalized
   /// @return Cumulative distribution function
   /// @brief Get histogram cumulative distribution function (CDF)
   inline histogram cdf(histogram const &h) {
     auto cdf = h;
     for (int i = 1; i < h.size(); ++i) cdf._data[i] += cdf._data[i - 1];
-    cdf._data /= double(h.n_data_pts());
+    cdf._data /= sum(h._data);
     return cdf;
   }
 
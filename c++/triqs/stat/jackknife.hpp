@@ -18,11 +18,19 @@
 // Authors: Philipp Dumitrescu, Olivier Parcollet, Nils Wentzell
 
 #pragma once
+#include <algorithm>
+#include <exception>
 #include <functional>
 #include <numeric>
+#include <optional>
+#include <random>
+#include <thread>
+#include <tuple>
 #include <type_traits>
+#include <vector>
 #include <triqs/arrays.hpp>
 // #include <triqs/arrays/math_functions.hpp>
+#include <triqs/mc_tools/philox.hpp>
 #include <mpi/vector.hpp>
 
 namespace triqs::stat {
@@ -55,17 +63,83 @@ namespace triqs::stat {
       }
 
       // average of the series (over the communicator given at construction)
-      auto average() const { return sum / n_tot; }
+      auto average() const { return sum / double(n_tot); }
 
       // Call. NB : if T is an array, returns an expression template to retard the evaluation
-      auto operator[](long i) const { return (sum - original_series[i]) / (n_tot - 1); }
+      auto operator[](long i) const { return (sum - original_series[i]) / double(n_tot - 1); }
     };
 
     //----------------------------------------------------------------
 
+    // Mean M and sum of the squared deviations Q of the values of f, in a single pass (Welford).
+    // The states of the threads and of the nodes are merged with the formula of Chan et al.
+    template <typename M_t> struct mean_var_t {
+      using Q_t = std::decay_t<decltype(nda::make_regular(nda::real(std::declval<M_t>())))>;
+      long n    = 0;
+      std::optional<M_t> M;
+      std::optional<Q_t> Q;
+
+      void operator<<(M_t const &x) {
+        if (++n == 1) {
+          M = x;
+          Q = nda::make_regular(nda::real(x));
+          *Q = 0;
+          return;
+        }
+        *Q += nda::abs2(x - *M) * ((n - 1) / double(n));
+        *M += (x - *M) / double(n);
+      }
+
+      void merge(mean_var_t const &o) {
+        if (o.n == 0) return;
+        if (n == 0) {
+          *this = o;
+          return;
+        }
+        double w = o.n / double(n + o.n);
+        *Q += *o.Q + nda::abs2(*o.M - *M) * (n * w);
+        *M += (*o.M - *M) * w;
+        n += o.n;
+      }
+
+      // Merge the states of all nodes, on all nodes. zero gives the shape of M on the nodes without data.
+      template <typename Z> void all_reduce(mpi::communicator c, Z const &zero) {
+        if (n == 0) {
+          M  = zero;
+          *M = 0;
+          Q  = nda::make_regular(nda::real(*M));
+          *Q = 0;
+        }
+        long n_tot = mpi::all_reduce(n, c);
+        M_t M_tot  = *M * (double(n) / n_tot);
+        mpi::all_reduce_in_place(M_tot, c);
+        *Q += nda::abs2(*M - M_tot) * double(n);
+        mpi::all_reduce_in_place(*Q, c);
+        M = std::move(M_tot);
+        n = n_tot;
+      }
+    };
+
+    // Run g(t) for t in [0, n_threads[, each on its own thread. Exceptions are rethrown in the calling thread.
+    template <typename G> void run_on_threads(int n_threads, G const &g) {
+      if (n_threads <= 1) return g(0);
+      std::vector<std::exception_ptr> errors(n_threads);
+      std::vector<std::thread> threads;
+      for (int t = 0; t < n_threads; ++t)
+        threads.emplace_back([&, t] {
+          try {
+            g(t);
+          } catch (...) { errors[t] = std::current_exception(); }
+        });
+      for (auto &th : threads) th.join();
+      for (auto &e : errors)
+        if (e) std::rethrow_exception(e);
+    }
+
     // implementation of jacknife.
     // mpi iif the c pointer is not null. If null the computation is on this node only.
-    template <typename F, typename... Jacknifed> auto jackknife_impl(mpi::communicator *c, F &&f, Jacknifed const &...ja) {
+    // f is evaluated once on each jackknifed sample, by n_threads threads.
+    template <typename F, typename... Jacknifed> auto jackknife_impl(mpi::communicator *c, int n_threads, F &&f, Jacknifed const &...ja) {
 
       // N is the size of the series, it should be all equal and !=0
       std::array<long, sizeof...(Jacknifed)> dims{long(ja.original_series.size())...};
@@ -80,41 +154,131 @@ namespace triqs::stat {
       // e.g. f = [](auto const & x, auto const y){ return x/y;};
       // in such cases, the ja[0] will be dangling unless we use the expression template
       // containing f immediately.
-      // Cf below, M and Q computation.
+      // Cf below, make_regular in the accumulation.
       // Check by ASAN sanitizer on tests
-      auto M = make_regular(f(ja[0]...));
+      using M_t = std::decay_t<decltype(nda::make_regular(f(ja[0]...)))>;
 
-      for (long i = 1; i < N; ++i) {
-        M += (f(ja[i]...) - M) / (i + 1); // cf NB
-      }
+      // Each thread accumulates M and Q on a contiguous chunk of the samples
+      n_threads = int(std::clamp<long>(n_threads, 1, N));
+      std::vector<mean_var_t<M_t>> states(n_threads);
+      run_on_threads(n_threads, [&](int t) {
+        for (long i = N * t / n_threads; i < N * (t + 1) / n_threads; ++i) states[t] << nda::make_regular(f(ja[i]...)); // cf NB
+      });
+      auto &st = states[0];
+      for (int t = 1; t < n_threads; ++t) st.merge(states[t]);
+
+      auto f_on_averages = nda::make_regular(f(ja.average()...));
 
       // Now the reduction over the nodes.
-      long Ntot = N;
-      if (c) { // MPI version
-        Ntot = mpi::reduce(N, *c);
+      if (c) st.all_reduce(*c, f_on_averages);
+      long Ntot = st.n;
+      auto &M   = *st.M;
+
+      auto std_err = nda::make_regular(std::sqrt((Ntot - 1) / double(Ntot)) * sqrt(*st.Q));
+      auto average = nda::make_regular(double(Ntot) * (f_on_averages - M) + M);
+      return std::make_tuple(average, std_err, M, f_on_averages);
+    }
 
-        M *= double(N) / Ntot; // remove the 1/N
-        M = mpi::all_reduce(M, *c);
+    //----------------------------------------------------------------
+
+    // implementation of the bootstrap.
+    // mpi iif the c pointer is not null. If null the computation is on this node only.
+    //
+    // The resample b draws Ntot indices among all the bins of all nodes, with the random generator philox4x32{seed, b}:
+    // the resamples are the same on all nodes, whatever the numbers of nodes and threads.
+    // Each node sums its own bins in the resample, and these sums are reduced to the node which owns the resample.
+    // The resamples are owned by the nodes in turn, n_threads at a time, so that f is evaluated once on each resample,
+    // on all nodes and threads, and at most 2 * n_threads sums per series are stored.
+    template <typename F, typename... Jacknifed>
+    auto bootstrap_impl(mpi::communicator *c, int n_threads, long n_samples, uint64_t seed, F &&f, Jacknifed const &...ja) {
+
+      std::array<long, sizeof...(Jacknifed)> dims{long(ja.original_series.size())...};
+      long N = dims[0];
+      if (N == 0) TRIQS_RUNTIME_ERROR << "No data !";
+      if (not((ja.original_series.size() == N) and ...)) TRIQS_RUNTIME_ERROR << " Bootstrap : size mismatch";
+      if (n_samples < 2) TRIQS_RUNTIME_ERROR << " Bootstrap : at least 2 samples are needed";
+      n_threads = std::max(n_threads, 1);
+
+      int n_nodes = (c ? c->size() : 1), rank = (c ? c->rank() : 0);
+      long Ntot = N, offset = 0; // offset : global index of my first bin
+      if (c) {
+        std::vector<long> sizes(n_nodes, 0);
+        sizes[rank] = N;
+        sizes       = mpi::all_reduce(sizes, *c);
+        Ntot        = std::accumulate(sizes.begin(), sizes.end(), 0l);
+        offset      = std::accumulate(sizes.begin(), sizes.begin() + rank, 0l);
       }
 
-      // Compute the variance
-      auto Q = make_regular(nda::real(M));
-      Q      = 0;
-      for (long i = 0; i < N; ++i) {
-        Q += nda::abs2(f(ja[i]...) - M); // Cf NB
+      // Sums of the bins of the resamples : one tuple per thread, to work on, and to keep the ones owned by this node
+      using sums_t = std::tuple<typename Jacknifed::T...>;
+      auto zero    = sums_t{ja.original_series[0]...};
+      std::apply([](auto &...s) { ((s = 0), ...); }, zero);
+      std::vector<sums_t> work(n_threads, zero), mine(n_threads, zero);
+
+      auto add_bin = [&]<size_t... K>(sums_t &s, long i, std::index_sequence<K...>) {
+        ((std::get<K>(s) += ja.original_series[i]), ...);
+      };
+      auto idx = std::index_sequence_for<Jacknifed...>{};
+
+      auto f_on_averages = nda::make_regular(f(ja.average()...));
+      using M_t          = std::decay_t<decltype(nda::make_regular(f(ja[0]...)))>;
+      std::vector<mean_var_t<M_t>> states(n_threads);
+
+      long n_per_round = long(n_nodes) * n_threads;
+      for (long round = 0; round * n_per_round < n_samples; ++round) {
+        long first = round * n_per_round;
+
+        // the sums of my bins for the resamples of the node r
+        for (int r = 0; r < n_nodes; ++r) {
+          run_on_threads(n_threads, [&](int t) {
+            long b = first + long(r) * n_threads + t;
+            if (b >= n_samples) return;
+            auto &s = work[t];
+            s       = zero;
+            mc_tools::philox4x32 gen{seed, uint64_t(b)};
+            std::uniform_int_distribution<long> dist(0, Ntot - 1);
+            for (long k = 0; k < Ntot; ++k) {
+              long i = dist(gen) - offset;
+              if (i >= 0 and i < N) add_bin(s, i, idx);
+            }
+          });
+          for (int t = 0; t < n_threads and first + long(r) * n_threads + t < n_samples; ++t) {
+            if (c) std::apply([&](auto &...s) { (mpi::reduce_in_place(s, *c, r), ...); }, work[t]);
+            if (r == rank) std::swap(work[t], mine[t]);
+          }
+        }
+
+        // f on my resamples
+        run_on_threads(n_threads, [&](int t) {
+          if (first + long(rank) * n_threads + t >= n_samples) return;
+          std::apply([&](auto const &...s) { states[t] << nda::make_regular(f((s / double(Ntot))...)); }, mine[t]); // cf NB in jackknife_impl
+        });
       }
 
-      // reduce Q
-      if (c) Q = mpi::all_reduce(Q, *c);
+      auto &st = states[0];
+      for (int t = 1; t < n_threads; ++t) st.merge(states[t]);
+      if (c) st.all_reduce(*c, f_on_averages);
+      auto &M = *st.M;
 
-      auto f_on_averages = make_regular(f(ja.average()...));
-      auto std_err       = make_regular(std::sqrt((Ntot - 1) / double(Ntot)) * sqrt(Q));
-      auto average       = make_regular(N * (f_on_averages - M) + M);
+      auto std_err = nda::make_regular(sqrt(*st.Q / double(n_samples - 1)));
+      auto average = nda::make_regular(2.0 * f_on_averages - M);
       return std::make_tuple(average, std_err, M, f_on_averages);
     }
 
   } // namespace details
 
+  /// Parameters of the jackknife and bootstrap resamplings
+  struct resampling_params {
+    /// Number of threads evaluating the function on the samples. If > 1, the function must be callable concurrently.
+    int n_threads = 1;
+
+    /// Number of bootstrap resamples
+    long n_samples = 1000;
+
+    /// Seed of the random generator of the bootstrap resamples
+    uint64_t seed = 34788;
+  };
+
   // ------------------------------------------------------------------------------
 
   /// Directly pass data-series in vector like objects
@@ -138,10 +302,17 @@ namespace triqs::stat {
   ///     $$\Delta{f}_J = \sqrt{N-1} \cdot \sigma_f$$
   /// where $\sigma_f$ is the standard deviation of $\left\{f(\tilde{\mathbf{a}}[0]), f(\tilde{\mathbf{a}}[1]), \ldots, f(\tilde{\mathbf{a}}[N])\right\}$.
   /// @brief Calculate mean and error of derived data using jackknife resampling
-  template <typename F, typename... A> auto jackknife(F &&f, A const &...a) {
+  template <typename F, typename... A>
+    requires(not std::is_same_v<std::decay_t<F>, resampling_params>)
+  auto jackknife(F &&f, A const &...a) {
     static_assert(not std::is_same_v<std::decay_t<F>, mpi::communicator>,
                   "I see that you pass a mpi:::communicator, you probably want to use jackknife_mpi");
-    return details::jackknife_impl(nullptr, std::forward<F>(f), details::jackknifed_t{a}...);
+    return details::jackknife_impl(nullptr, 1, std::forward<F>(f), details::jackknifed_t{a}...);
+  }
+
+  /// Same as jackknife(f, a...), with the samples evaluated by p.n_threads threads
+  template <typename F, typename... A> auto jackknife(resampling_params const &p, F &&f, A const &...a) {
+    return details::jackknife_impl(nullptr, p.n_threads, std::forward<F>(f), details::jackknifed_t{a}...);
   }
 
   /// Pass :ref:`accumulators <triqs__stat__accumulator>`, where the jacknife acts on the :ref:`linear binned data <accumulator_linear_bins>`
@@ -152,11 +323,16 @@ namespace triqs::stat {
     return jackknife(std::forward<F>(f), a.linear_bins()...);
   }
 
+  /// Same as jackknife(f, a...) on accumulators, with the samples evaluated by p.n_threads threads
+  template <typename F, typename... T> auto jackknife(resampling_params const &p, F &&f, accumulator<T> const &...a) {
+    return jackknife(p, std::forward<F>(f), a.linear_bins()...);
+  }
+
   // ------------------------------------------------------------------------------
 
   /// Directly pass data-series in vector like objects
   /// @head Calculate the value and error of a general function $f$ of the average of sampled observables $f\left(\langle \mathbf{a} \rangle\right)$, using jackknife resampling.
-  /// @tail The calculation is performed over the nodes; the answers which are then reduced (not all-reduced) to the node 0.
+  /// @tail The calculation is performed over the nodes; the answers are then reduced to all nodes.
   /// @tparam F return type of function :param:`f` which acts on data
   /// @tparam A vector-like object, defining size() and []
   /// @param c TRIQS MPI communicator
@@ -164,7 +340,7 @@ namespace triqs::stat {
   ///   Pre-condition: if more than one series is passed, the series have to be equal in size
   /// @param f a function which acts on the $i^\mathrm{th}$ elements of the series in :param:`a`:
   /// $$\left(a_1[i], a_2[i],a_3[i],\ldots\right) \to f\left(a_1[i],a_2[i],a_3[i],\ldots\right)$$
-  /// @return std::tuple with four statistical estimators $\left(f_\mathrm{J}^{*}, \Delta{f}_\mathrm{J}, f_\mathrm{J}, f_\mathrm{direct}\right)$, defined below. The MPI reduction occurs *only* to node 0.
+  /// @return std::tuple with four statistical estimators $\left(f_\mathrm{J}^{*}, \Delta{f}_\mathrm{J}, f_\mathrm{J}, f_\mathrm{direct}\right)$, defined below. The result is on all nodes.
   ///
   /// Jackknife resampling takes $N$ data points $\mathbf{a}[i]$ and creates $N$ samples ("jackknifed data"), which we denote $\tilde{\mathbf{a}}[i]$. We calculate three statistical estimators for $f\left(\langle \mathbf{a} \rangle\right)$:
   ///   * The function $f$ applied to observed mean of the data
@@ -177,8 +353,15 @@ namespace triqs::stat {
   ///     $$\Delta{f}_J = \sqrt{N-1} \cdot \sigma_f$$
   /// where $\sigma_f$ is the standard deviation of $\left\{f(\tilde{\mathbf{a}}[0]), f(\tilde{\mathbf{a}}[1]), \ldots, f(\tilde{\mathbf{a}}[N])\right\}$.
   /// @brief Calculate mean and error of derived data using jackknife resampling (MPI Version)
-  template <typename F, typename... A> auto jackknife_mpi(mpi::communicator c, F &&f, A const &...a) {
-    return details::jackknife_impl(&c, std::forward<F>(f), details::jackknifed_t{a, c}...);
+  template <typename F, typename... A>
+    requires(not std::is_same_v<std::decay_t<F>, resampling_params>)
+  auto jackknife_mpi(mpi::communicator c, F &&f, A const &...a) {
+    return details::jackknife_impl(&c, 1, std::forward<F>(f), details::jackknifed_t{a, c}...);
+  }
+
+  /// Same as jackknife_mpi(c, f, a...), with the samples of each node evaluated by p.n_threads threads
+  template <typename F, typename... A> auto jackknife_mpi(mpi::communicator c, resampling_params const &p, F &&f, A const &...a) {
+    return details::jackknife_impl(&c, p.n_threads, std::forward<F>(f), details::jackknifed_t{a, c}...);
   }
 
   /// Pass :ref:`accumulators <triqs__stat__accumulator>`, where the jacknife acts on the :ref:`linear binned data <accumulator_linear_bins>`
@@ -187,4 +370,53 @@ namespace triqs::stat {
     return jackknife_mpi(c, std::forward<F>(f), a.linear_bins()...);
   }
 
+  /// Same as jackknife_mpi(c, f, a...) on accumulators, with the samples of each node evaluated by p.n_threads threads
+  template <typename F, typename... T> auto jackknife_mpi(mpi::communicator c, resampling_params const &p, F &&f, accumulator<T> const &...a) {
+    return jackknife_mpi(c, p, std::forward<F>(f), a.linear_bins()...);
+  }
+
+  // ------------------------------------------------------------------------------
+
+  /// Directly pass data-series in vector like objects
+  /// @head Calculate the value and error of a general function $f$ of the average of sampled observables $f\left(\langle \mathbf{a} \rangle\right)$, using bootstrap resampling.
+  /// @tparam F return type of function :param:`f` which acts on data
+  /// @tparam A vector-like object, defining size() and []
+  /// @param p parameters of the resampling: number of resamples, seed, number of threads
+  /// @param a one or multiple series with data: $\mathbf{a} = \{a_1, a_2, a_3, \ldots\}$
+  ///   Pre-condition: if more than one series is passed, the series have to be equal in size
+  /// @param f a function which acts on the averages of the series in :param:`a` over a resample
+  /// @return std::tuple with four statistical estimators $\left(f_\mathrm{B}^{*}, \Delta{f}_\mathrm{B}, f_\mathrm{B}, f_\mathrm{direct}\right)$, defined below.
+  ///
+  /// Bootstrap resampling draws $B$ resamples of $N$ data points among the $N$ data points $\mathbf{a}[i]$, with replacement.
+  /// We denote $\hat{\mathbf{a}}[b]$ the average of the resample $b$. As for the jackknife:
+  ///   * $f_\mathrm{direct} = f\left(\bar{\mathbf{a}}\right)$
+  ///   * $f_\mathrm{B} = \frac{1}{B}\sum_{b=0}^{B-1} f(\hat{\mathbf{a}}[b])$
+  ///   * $f_\mathrm{B}^{*} = 2 f_\mathrm{direct} - f_\mathrm{B}$, with bias correction
+  ///   * $\Delta{f}_\mathrm{B}$ is the standard deviation of the $f(\hat{\mathbf{a}}[b])$.
+  /// The resamples depend only on the seed, and $f$ is evaluated once on each of them.
+  /// @brief Calculate mean and error of derived data using bootstrap resampling
+  template <typename F, typename... A> auto bootstrap(resampling_params const &p, F &&f, A const &...a) {
+    return details::bootstrap_impl(nullptr, p.n_threads, p.n_samples, p.seed, std::forward<F>(f), details::jackknifed_t{a}...);
+  }
+
+  /// Pass :ref:`accumulators <triqs__stat__accumulator>`, where the bootstrap acts on the :ref:`linear binned data <accumulator_linear_bins>`
+  /// @tparam T type of data stored in the accumulators
+  template <typename F, typename... T> auto bootstrap(resampling_params const &p, F &&f, accumulator<T> const &...a) {
+    return bootstrap(p, std::forward<F>(f), a.linear_bins()...);
+  }
+
+  /// Same as bootstrap(p, f, a...), with the data distributed over the nodes of c. The bins are not gathered:
+  /// each node sums its own bins in the resamples, and the evaluations of f are shared among the nodes.
+  /// The result is on all nodes, and is the same as bootstrap(p, f, a...) on the concatenated series, up to rounding.
+  /// @brief Calculate mean and error of derived data using bootstrap resampling (MPI Version)
+  template <typename F, typename... A> auto bootstrap_mpi(mpi::communicator c, resampling_params const &p, F &&f, A const &...a) {
+    return details::bootstrap_impl(&c, p.n_threads, p.n_samples, p.seed, std::forward<F>(f), details::jackknifed_t{a, c}...);
+  }
+
+  /// Pass :ref:`accumulators <triqs__stat__accumulator>`, where the bootstrap acts on the :ref:`linear binned data <accumulator_linear_bins>`
+  /// @tparam T type of data stored in the accumulators
+  template <typename F, typename... T> auto bootstrap_mpi(mpi::communicator c, resampling_params const &p, F &&f, accumulator<T> const &...a) {
+    return bootstrap_mpi(c, p, std::forward<F>(f), a.linear_bins()...);
+  }
+
 } // namespace triqs::stat
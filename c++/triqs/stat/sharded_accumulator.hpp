@@ -0,0 +1,77 @@
+// Copyright (c) 2026 Simons Foundation
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You may obtain a copy of the License at
+//     https://www.gnu.org/licenses/gpl-3.0.txt
+
+#pragma once
+
+#include "./accumulator.hpp"
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace triqs::stat {
+
+  /// An accumulator fed by several threads.
+  ///
+  /// Each thread writes into its own shard, an accumulator protected by a mutex which is only contended
+  /// while a reader copies this shard. A reader can take a snapshot at any time: the shards are copied one by one
+  /// and merged into one accumulator, cf accumulator::merge, without stopping the other writers.
+  ///
+  /// @brief Accumulator with one shard per writing thread
+  template <typename T> class sharded_accumulator {
+
+    // On its own cache line, to avoid false sharing between the writers
+    struct alignas(64) shard_t {
+      mutable std::mutex mutex;
+      accumulator<T> acc;
+    };
+    std::vector<std::unique_ptr<shard_t>> shards;
+
+    public:
+    /// @param data_instance, n_log_bins_max, n_lin_bins_max, lin_bin_capacity Parameters of the accumulator of each shard, cf accumulator
+    /// @param n_shards Number of shards, typically the number of writing threads
+    sharded_accumulator(T const &data_instance, int n_shards, int n_log_bins_max = 0, int n_lin_bins_max = 0, int lin_bin_capacity = 1) {
+      if (n_shards < 1) TRIQS_RUNTIME_ERROR << "sharded_accumulator : the number of shards must be >= 1";
+      for (int i = 0; i < n_shards; ++i) {
+        shards.emplace_back(std::make_unique<shard_t>());
+        shards.back()->acc = accumulator<T>{data_instance, n_log_bins_max, n_lin_bins_max, lin_bin_capacity};
+      }
+    }
+
+    /// Number of shards
+    [[nodiscard]] int n_shards() const { return shards.size(); }
+
+    /// Add a measurement to shard i. Different threads can add to different shards concurrently.
+    /// @param i The shard, in [0, n_shards()[
+    /// @param x The measurement
+    template <typename U> void push(int i, U const &x) {
+      auto &s = *shards[i];
+      std::lock_guard lock{s.mutex};
+      s.acc << x;
+    }
+
+    /// The accumulator of all shards merged, at the time each shard is copied.
+    /// Can be called concurrently with push.
+    [[nodiscard]] accumulator<T> snapshot() const {
+      auto copy = [](shard_t const &s) {
+        std::lock_guard lock{s.mutex};
+        return s.acc;
+      };
+      auto r = copy(*shards[0]);
+      for (size_t i = 1; i < shards.size(); ++i) r.merge(copy(*shards[i]));
+      return r;
+    }
+  };
+
+} // namespace triqs::stat
@@ -19,8 +19,13 @@
 
 #pragma once
 #include "./first_include.hpp"
+#include <cstdint>
 #include <vector>
 #include <functional>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <string>
 
 namespace triqs {
   namespace utility {
@@ -31,6 +36,11 @@ namespace triqs {
   * Advantage :
   *  - do not pay the indirection cost at each call, but once every size call.
   *  - erase the function type
+  * If the function has a method fill(R *first, R *last), it is used to refill the whole buffer at once.
+  * The position in the sequence of values of the function can be read and advanced, e.g. to restore a checkpoint.
+  * If the function has a method discard(n), it is used to skip values, instead of computing them.
+  * If the function can be written to and read from a stream (operator<< and >>), the state of the
+  * buffered function can be saved and restored exactly, cf get_state.
   * It is a semi-regular type.
   */
     template <typename R> struct buffered_function {
@@ -45,30 +55,100 @@ namespace triqs {
    * @param size : size of the buffer [optional]
    */
       template <typename Function> buffered_function(Function f, size_t size = 1000) : buffer(size) {
-        refill = [f](buffered_function *bf) mutable { // without the mutable, the () of the lambda object is const, hence f
-          for (auto &x : bf->buffer) x = f();
+        constexpr bool serializable = requires(std::ostream &os, std::istream &is, Function &g) {
+          os << g;
+          is >> g;
+        };
+        // without the mutable, the () of the lambda object is const, hence f
+        impl = [f](buffered_function *bf, op_t op, uint64_t n_skip, std::stringstream *ss) mutable {
+          if constexpr (serializable) {
+            if (op == op_t::write_state) *ss << f;
+            if (op == op_t::read_state) *ss >> f;
+          }
+          if (op != op_t::refill) return;
+          if constexpr (requires { f.discard(n_skip); })
+            f.discard(n_skip);
+          else
+            for (; n_skip > 0; --n_skip) f();
+          if constexpr (requires(R *p) { f.fill(p, p); })
+            f.fill(bf->buffer.data(), bf->buffer.data() + bf->buffer.size());
+          else
+            for (auto &x : bf->buffer) x = f();
           bf->index = 0;
         };
-        refill(this); // first filling of the buffer
+        _has_state = serializable;
+        next_buffer(0); // first filling of the buffer
       }
 
       /// Returns the next element. Refills the buffer if necessary.
       R operator()() {
-        if (index > buffer.size() - 1) refill(this);
+        if (index > buffer.size() - 1) next_buffer(0);
         return buffer[index++];
       }
 
       /// Returns the future next element, without increasing the index. Refills the buffer if necessary.
       R preview() {
-        if (index > buffer.size() - 1) refill(this);
+        if (index > buffer.size() - 1) next_buffer(0);
         return buffer[index];
       }
 
+      /// Number of elements returned since construction (by () or skipped by advance)
+      uint64_t position() const { return n_generated - buffer.size() + index; }
+
+      /// Skip the next n elements
+      void advance(uint64_t n) {
+        if (index + n <= buffer.size())
+          index += n;
+        else
+          next_buffer(n - (buffer.size() - index));
+      }
+
+      /// Can the state be saved and restored with get_state and set_state ?
+      bool has_state() const { return _has_state; }
+
+      /**
+   * The state of the buffered function, as a string : the state of the function, written with operator<<,
+   * followed by the position and the elements of the buffer not returned yet.
+   * Precondition : has_state()
+   */
+      std::string get_state() const {
+        std::stringstream ss;
+        impl(nullptr, op_t::write_state, 0, &ss);
+        ss << ' ' << n_generated << ' ' << buffer.size() << ' ' << index << std::setprecision(std::numeric_limits<R>::max_digits10);
+        for (auto i = index; i < buffer.size(); ++i) ss << ' ' << buffer[i];
+        return ss.str();
+      }
+
+      /**
+   * Restore a state written by get_state, for the same function.
+   * The next elements are the ones which followed when the state was written.
+   * Precondition : has_state()
+   */
+      void set_state(std::string const &state) {
+        std::stringstream ss{state};
+        impl(nullptr, op_t::read_state, 0, &ss);
+        size_t size;
+        ss >> n_generated >> size >> index;
+        buffer.resize(size);
+        for (auto i = index; i < buffer.size(); ++i) ss >> buffer[i];
+      }
+
       private:
+      void next_buffer(uint64_t n_skip) {
+        impl(this, op_t::refill, n_skip, nullptr);
+        n_generated += n_skip + buffer.size();
+      }
+
       size_t index;
+      uint64_t n_generated = 0; // number of values of the function computed or skipped, buffer included
       std::vector<R> buffer;
-      std::function<void(buffered_function *)> refill; // this refills the buffer and reset index of a buffered_function.
-                                                       // NB : cannot capture this in refill because we want the object to be copyable and movable
+      bool _has_state = false;
+      // The operations on the function, whose type is erased :
+      //  - refill : skips n_skip values, refills the buffer and resets the index.
+      //  - write_state, read_state : writes (reads) the state of the function to (from) the stream, if it can be serialized.
+      // NB : cannot capture this in impl because we want the object to be copyable and movable
+      enum class op_t { refill, write_state, read_state };
+      std::function<void(buffered_function *, op_t, uint64_t, std::stringstream *)> impl;
     };
   } // namespace utility
 } // namespace triqs
@@ -44,6 +44,12 @@ namespace triqs {
         running = false;
       }
       bool is_running() const { return running; }
+
+      /// Add the time measured by another (stopped) timer, e.g. on another thread
+      timer &operator+=(timer const &other) {
+        total_time += other.total_time;
+        return *this;
+      }
       operator double() const {
         std::chrono::duration<double> total_time_seconds(total_time);
         if (is_running()) total_time_seconds += clock_t::now() - start_time;
@@ -0,0 +1,66 @@
+// Copyright (c) 2026 Simons Foundation
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You may obtain a copy of the License at
+//     https://www.gnu.org/licenses/gpl-3.0.txt
+
+#include <triqs/test_tools/gfs.hpp>
+
+#include <triqs/atom_diag/atom_diag.hpp>
+
+#include "./hamiltonian.hpp"
+
+using namespace triqs::hilbert_space;
+using namespace triqs::atom_diag;
+
+using atom_diag_real = triqs::atom_diag::atom_diag<false>;
+
+void check_same(atom_diag_real const &ad1, atom_diag_real const &ad2, fundamental_operator_set const &fops) {
+  ASSERT_EQ(ad1.n_subspaces(), ad2.n_subspaces());
+  EXPECT_EQ(ad1.get_gs_energy(), ad2.get_gs_energy());
+  for (int sp = 0; sp < ad1.n_subspaces(); ++sp) {
+    EXPECT_EQ(ad1.get_fock_states(sp), ad2.get_fock_states(sp));
+    EXPECT_ARRAY_NEAR(ad1.get_eigensystems()[sp].eigenvalues, ad2.get_eigensystems()[sp].eigenvalues, 1e-14);
+    for (int n = 0; n < fops.size(); ++n) {
+      EXPECT_EQ(ad1.c_connection(n, sp), ad2.c_connection(n, sp));
+      EXPECT_EQ(ad1.cdag_connection(n, sp), ad2.cdag_connection(n, sp));
+      if (ad1.c_connection(n, sp) != -1) EXPECT_ARRAY_NEAR(ad1.c_matrix(n, sp), ad2.c_matrix(n, sp), 1e-14);
+      if (ad1.cdag_connection(n, sp) != -1) EXPECT_ARRAY_NEAR(ad1.cdag_matrix(n, sp), ad2.cdag_matrix(n, sp), 1e-14);
+    }
+  }
+}
+
+// The subspaces are diagonalized concurrently, with the same result
+TEST(atom_diag_real, Threads) {
+  auto fops = make_fops();
+  auto h    = make_hamiltonian<many_body_operator_real>(.5, 3.0, 0.3, .1, .2);
+
+  auto N_up = n("up", 0) + n("up", 1) + n("up", 2);
+  auto N_dn = n("dn", 0) + n("dn", 1) + n("dn", 2);
+
+  set_atom_diag_threads(1);
+  auto ad1    = atom_diag_real(h, fops);
+  auto ad1_qn = atom_diag_real(h, fops, {N_up, N_dn});
+
+  set_atom_diag_threads(4);
+  EXPECT_EQ(get_atom_diag_threads(), 4);
+  auto ad4    = atom_diag_real(h, fops);
+  auto ad4_qn = atom_diag_real(h, fops, {N_up, N_dn});
+
+  check_same(ad1, ad4, fops);
+  check_same(ad1_qn, ad4_qn, fops);
+
+  EXPECT_THROW(set_atom_diag_threads(0), triqs::runtime_error);
+  set_atom_diag_threads(1);
+}
+
+MAKE_MAIN;
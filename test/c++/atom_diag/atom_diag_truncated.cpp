@@ -0,0 +1,112 @@
+// Copyright (c) 2026 Simons Foundation
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You may obtain a copy of the License at
+//     https://www.gnu.org/licenses/gpl-3.0.txt
+
+#include <triqs/test_tools/gfs.hpp>
+
+#include <triqs/atom_diag/atom_diag.hpp>
+#include <triqs/atom_diag/functions.hpp>
+
+#include "./hamiltonian.hpp"
+
+using namespace triqs::hilbert_space;
+using namespace triqs::atom_diag;
+
+using atom_diag_real = triqs::atom_diag::atom_diag<false>;
+
+// sum_ij |m_ij|^2, which does not depend on the choice of the eigenvectors of the degenerate multiplets
+double squared_norm(atom_diag_real::matrix_t const &m) { return trace(transpose(m) * m); }
+
+auto make_qn() {
+  auto N_up = n("up", 0) + n("up", 1) + n("up", 2);
+  auto N_dn = n("dn", 0) + n("dn", 1) + n("dn", 2);
+  return std::vector<many_body_operator_real>{N_up, N_dn};
+}
+
+// With a window larger than the spectrum, the Lanczos solver (dense_dim = 2) finds all the eigenstates of the subspaces
+TEST(atom_diag_real, TruncatedFullSpectrum) {
+  auto fops = make_fops();
+  auto h    = make_hamiltonian<many_body_operator_real>(.5, 3.0, 0.3, .1, .2);
+
+  auto ad  = atom_diag_real(h, fops, make_qn());
+  auto adt = atom_diag_real(h, fops, make_qn(), atom_diag_truncation{.energy_window = 1.e6, .n_lowest = -1, .dense_dim = 2});
+
+  ASSERT_EQ(ad.n_subspaces(), adt.n_subspaces());
+  EXPECT_NEAR(ad.get_gs_energy(), adt.get_gs_energy(), 1e-10);
+  for (int sp = 0; sp < ad.n_subspaces(); ++sp) {
+    EXPECT_EQ(ad.get_fock_states(sp), adt.get_fock_states(sp));
+    EXPECT_ARRAY_NEAR(ad.get_eigensystems()[sp].eigenvalues, adt.get_eigensystems()[sp].eigenvalues, 1e-10);
+    for (int n = 0; n < fops.size(); ++n) {
+      ASSERT_EQ(ad.c_connection(n, sp), adt.c_connection(n, sp));
+      if (ad.c_connection(n, sp) != -1) EXPECT_NEAR(squared_norm(ad.c_matrix(n, sp)), squared_norm(adt.c_matrix(n, sp)), 1e-10);
+    }
+  }
+}
+
+// Energy window : the thermal averages at low temperature are unchanged
+TEST(atom_diag_real, TruncatedWindow) {
+  auto fops = make_fops();
+  auto h    = make_hamiltonian<many_body_operator_real>(.5, 3.0, 0.3, .1, .2);
+
+  double window = 2.0, beta = 20;
+  auto ad       = atom_diag_real(h, fops);
+  auto adt      = atom_diag_real(h, fops, atom_diag_truncation{.energy_window = window, .n_lowest = -1, .dense_dim = 2});
+
+  // All the eigenvalues within the window, and only them
+  std::vector<double> e_full, e_trunc;
+  for (auto const &es : ad.get_eigensystems())
+    for (double e : es.eigenvalues)
+      if (e <= window) e_full.push_back(e);
+  for (auto const &es : adt.get_eigensystems())
+    for (double e : es.eigenvalues) e_trunc.push_back(e);
+  std::sort(e_full.begin(), e_full.end());
+  std::sort(e_trunc.begin(), e_trunc.end());
+  ASSERT_EQ(e_full.size(), e_trunc.size());
+  EXPECT_LT(adt.n_subspaces(), ad.n_subspaces());
+  for (int i = 0; i < e_full.size(); ++i) EXPECT_NEAR(e_full[i], e_trunc[i], 1e-10);
+
+  auto rho  = atomic_density_matrix(ad, beta);
+  auto rhot = atomic_density_matrix(adt, beta);
+  for (auto const &op : {n("up", 0), n("dn", 1), c_dag("up", 0) * c("up", 1) + c_dag("up", 1) * c("up", 0), n("up", 2) * n("dn", 2)})
+    EXPECT_NEAR(trace_rho_op(rho, op, ad), trace_rho_op(rhot, op, adt), 1e-10);
+}
+
+// n_lowest = 1 : the lowest multiplet of each subspace
+TEST(atom_diag_real, TruncatedLowest) {
+  auto fops = make_fops();
+  auto h    = make_hamiltonian<many_body_operator_real>(.5, 3.0, 0.3, .1, .2);
+
+  auto ad  = atom_diag_real(h, fops, make_qn());
+  auto adt = atom_diag_real(h, fops, make_qn(), atom_diag_truncation{.n_lowest = 1, .dense_dim = 4});
+
+  ASSERT_EQ(ad.n_subspaces(), adt.n_subspaces());
+  EXPECT_EQ(ad.get_quantum_numbers(), adt.get_quantum_numbers());
+  // the quantum numbers of the kept eigenstates
+  auto N_up    = make_qn()[0];
+  auto qn_up   = quantum_number_eigenvalues(N_up, ad);
+  auto qn_up_t = quantum_number_eigenvalues_checked(N_up, adt);
+  for (int sp = 0; sp < ad.n_subspaces(); ++sp) {
+    auto const &e  = ad.get_eigensystems()[sp].eigenvalues;
+    auto const &et = adt.get_eigensystems()[sp].eigenvalues;
+    long n_lowest  = 1;
+    while (n_lowest < e.size() and std::abs(e(n_lowest) - e(0)) < 1e-8) ++n_lowest;
+    ASSERT_EQ(et.size(), n_lowest);
+    for (int i = 0; i < n_lowest; ++i) EXPECT_NEAR(e(i), et(i), 1e-10);
+    EXPECT_EQ(second_dim(adt.get_unitary_matrix(sp)), n_lowest);
+    ASSERT_EQ(qn_up_t[sp].size(), n_lowest);
+    for (int i = 0; i < n_lowest; ++i) EXPECT_NEAR(qn_up_t[sp][i], qn_up[sp][0], 1e-10);
+  }
+}
+
+MAKE_MAIN;
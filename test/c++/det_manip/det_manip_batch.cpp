@@ -0,0 +1,103 @@
+// Copyright (c) 2026 Simons Foundation
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You may obtain a copy of the License at
+//     https://www.gnu.org/licenses/gpl-3.0.txt
+
+#include <triqs/test_tools/arrays.hpp>
+#include <triqs/det_manip/det_manip.hpp>
+#include <random>
+
+struct fun {
+
+  using result_type   = double;
+  using argument_type = double;
+
+  double operator()(double x, double y) const {
+    const double pi   = acos(-1);
+    const double beta = 10.0;
+    const double epsi = 0.1;
+    double tau        = x - y;
+    bool s            = (tau > 0);
+    tau               = (s ? tau : beta + tau);
+    double r          = epsi + tau / beta * (1 - 2 * epsi);
+    return -2 * (pi / beta) / std::sin(pi * r);
+  }
+};
+
+using d_t              = triqs::det_manip::det_manip<fun>;
+const double precision = 1.e-10;
+
+// The ratios of the batch must be the ratios of the individual try, and any candidate can be completed
+TEST(DetManip, InsertRemoveBatch) {
+
+  std::mt19937 gen(23432);
+  std::uniform_real_distribution<> dis(0.0, 10.0);
+
+  for (long delayed : {0, 4}) {
+    auto d = d_t{fun{}, 10};
+    d.set_n_delayed_updates(delayed);
+
+    for (int n = 0; n < 40; ++n) {
+      long N = d.size(), M = 5;
+
+      // insertion
+      std::vector<long> i(M), j(M);
+      std::vector<double> x(M), y(M);
+      for (long c = 0; c < M; ++c) {
+        i[c] = gen() % (N + 1);
+        j[c] = gen() % (N + 1);
+        x[c] = dis(gen);
+        y[c] = dis(gen);
+      }
+      auto ratios = d.try_insert_batch(i, j, x, y);
+      d.reject_last_try();
+      ASSERT_EQ(long(ratios.size()), M);
+      for (long c = 0; c < M; ++c) {
+        auto r = d.try_insert(i[c], j[c], x[c], y[c]);
+        d.reject_last_try();
+        EXPECT_NEAR(r, ratios[c], precision * std::abs(r));
+      }
+
+      long c       = gen() % M;
+      auto det_old = d.determinant();
+      ratios       = d.try_insert_batch(i, j, x, y);
+      d.complete_batch_operation(c);
+      EXPECT_NEAR(d.determinant(), det_old * ratios[c], precision * std::abs(d.determinant()));
+      EXPECT_ARRAY_NEAR(nda::matrix<double>{inverse(d.matrix())}, d.inverse_matrix(), precision);
+
+      // removal, one out of three steps
+      if (n % 3 != 2 or d.size() < 2) continue;
+      N = d.size();
+      for (long c2 = 0; c2 < M; ++c2) {
+        i[c2] = gen() % N;
+        j[c2] = gen() % N;
+      }
+      ratios = d.try_remove_batch(i, j);
+      d.reject_last_try();
+      for (long c2 = 0; c2 < M; ++c2) {
+        auto r = d.try_remove(i[c2], j[c2]);
+        d.reject_last_try();
+        EXPECT_NEAR(r, ratios[c2], precision * std::abs(r));
+      }
+
+      c       = gen() % M;
+      det_old = d.determinant();
+      ratios  = d.try_remove_batch(i, j);
+      d.complete_batch_operation(c);
+      EXPECT_NEAR(d.determinant(), det_old * ratios[c], precision * std::abs(d.determinant()));
+      EXPECT_ARRAY_NEAR(nda::matrix<double>{inverse(d.matrix())}, d.inverse_matrix(), precision);
+    }
+  }
+}
+
+MAKE_MAIN;
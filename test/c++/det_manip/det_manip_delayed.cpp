@@ -0,0 +1,138 @@
+// Copyright (c) 2026 Simons Foundation
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You may obtain a copy of the License at
+//     https://www.gnu.org/licenses/gpl-3.0.txt
+
+#include <triqs/test_tools/arrays.hpp>
+#include <triqs/det_manip/det_manip.hpp>
+#include <random>
+
+struct fun {
+
+  using result_type   = double;
+  using argument_type = double;
+
+  double operator()(double x, double y) const {
+    const double pi   = acos(-1);
+    const double beta = 10.0;
+    const double epsi = 0.1;
+    double tau        = x - y;
+    bool s            = (tau > 0);
+    tau               = (s ? tau : beta + tau);
+    double r          = epsi + tau / beta * (1 - 2 * epsi);
+    return -2 * (pi / beta) / std::sin(pi * r);
+  }
+};
+
+using d_t              = triqs::det_manip::det_manip<fun>;
+const double precision = 1.e-8;
+
+// Run the same random sequence of operations with and without delayed updates
+TEST(DetManip, DelayedUpdates) {
+
+  for (long K : {1, 3, 8}) {
+    std::mt19937 gen(23432);
+    std::uniform_real_distribution<> dis(0.0, 10.0);
+
+    auto d_ref = d_t{fun{}, 10};
+    auto d     = d_t{fun{}, 10};
+    d.set_n_delayed_updates(K);
+    EXPECT_EQ(d.get_n_delayed_updates(), K);
+
+    for (int n = 0; n < 400; ++n) {
+      long N = d.size();
+      double r1 = 0, r2 = 0;
+      switch (n < 20 ? 0 : gen() % 7) {
+        case 0: {
+          long i = gen() % (N + 1), j = gen() % (N + 1);
+          double x = dis(gen), y = dis(gen);
+          r1 = d_ref.try_insert(i, j, x, y);
+          r2 = d.try_insert(i, j, x, y);
+          break;
+        }
+        case 1: {
+          if (N < 2) continue;
+          long i = gen() % N, j = gen() % N;
+          r1 = d_ref.try_remove(i, j);
+          r2 = d.try_remove(i, j);
+          break;
+        }
+        case 2: {
+          if (N < 1) continue;
+          long j   = gen() % N;
+          double y = dis(gen);
+          r1       = d_ref.try_change_col(j, y);
+          r2       = d.try_change_col(j, y);
+          break;
+        }
+        case 3: {
+          if (N < 1) continue;
+          long i   = gen() % N;
+          double x = dis(gen);
+          r1       = d_ref.try_change_row(i, x);
+          r2       = d.try_change_row(i, x);
+          break;
+        }
+        case 4: {
+          if (N < 1) continue;
+          long i = gen() % N, j = gen() % N;
+          double x = dis(gen), y = dis(gen);
+          r1 = d_ref.try_change_col_row(i, j, x, y);
+          r2 = d.try_change_col_row(i, j, x, y);
+          break;
+        }
+        case 5: {
+          long i0 = gen() % (N + 1), j0 = gen() % (N + 1);
+          double x0 = dis(gen), x1 = dis(gen), y0 = dis(gen), y1 = dis(gen);
+          r1 = d_ref.try_insert2(i0, i0 + 1, j0, j0 + 1, x0, x1, y0, y1);
+          r2 = d.try_insert2(i0, i0 + 1, j0, j0 + 1, x0, x1, y0, y1);
+          break;
+        }
+        case 6: {
+          if (N < 3) continue;
+          long i0 = gen() % (N - 1), j0 = gen() % (N - 1);
+          r1 = d_ref.try_remove2(i0, i0 + 1, j0, j0 + 1);
+          r2 = d.try_remove2(i0, i0 + 1, j0, j0 + 1);
+          break;
+        }
+      }
+
+      EXPECT_NEAR(r1, r2, precision * std::abs(r1));
+
+      // accept moves which keep the matrix well conditioned
+      if (std::abs(r1) > 1.e-2 and std::abs(r1) < 1.e2) {
+        d_ref.complete_operation();
+        d.complete_operation();
+      } else {
+        d_ref.reject_last_try();
+        d.reject_last_try();
+      }
+
+      EXPECT_NEAR(d_ref.determinant(), d.determinant(), precision * std::abs(d_ref.determinant()));
+      EXPECT_ARRAY_NEAR(d_ref.inverse_matrix(), d.inverse_matrix(), precision);
+
+      // the const accessor flushes the pending updates
+      if (n % 10 == 0) {
+        auto const &cd = d;
+        EXPECT_ARRAY_NEAR(d_ref.inverse_matrix_internal_order(), cd.inverse_matrix_internal_order(), precision);
+      }
+    }
+
+    // flush and compare with the exact inverse
+    d.flush_delayed_updates();
+    EXPECT_ARRAY_NEAR(nda::matrix<double>{inverse(d.matrix())}, d.inverse_matrix(), precision);
+    EXPECT_ARRAY_NEAR(d_ref.inverse_matrix_internal_order(), d.inverse_matrix_internal_order(), precision);
+  }
+}
+
+MAKE_MAIN;
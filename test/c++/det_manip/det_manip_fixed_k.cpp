@@ -0,0 +1,120 @@
+// Copyright (c) 2026 Simons Foundation
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You may obtain a copy of the License at
+//     https://www.gnu.org/licenses/gpl-3.0.txt
+
+#include <triqs/test_tools/arrays.hpp>
+#include <triqs/det_manip/det_manip.hpp>
+#include <random>
+#include <numeric>
+#include <algorithm>
+
+struct fun {
+
+  using result_type   = double;
+  using argument_type = double;
+
+  double operator()(double x, double y) const {
+    const double pi   = acos(-1);
+    const double beta = 10.0;
+    const double epsi = 0.1;
+    double tau        = x - y;
+    bool s            = (tau > 0);
+    tau               = (s ? tau : beta + tau);
+    double r          = epsi + tau / beta * (1 - 2 * epsi);
+    return -2 * (pi / beta) / std::sin(pi * r);
+  }
+};
+
+using d_t              = triqs::det_manip::det_manip<fun>;
+const double precision = 1.e-10;
+
+// The fixed size try_insert_k<K>/try_remove_k<K> (d) must agree with the runtime k versions (d_ref)
+// along the same sequence of moves, with or without delayed updates.
+template <size_t K> void check_fixed_k(std::mt19937 &gen, long n_delayed = 0) {
+  std::uniform_real_distribution<> dis(0.0, 10.0);
+  auto d     = d_t{fun{}, 10};
+  auto d_ref = d_t{fun{}, 10};
+  d.set_n_delayed_updates(n_delayed);
+  d_ref.set_n_delayed_updates(n_delayed);
+
+  auto check = [&](auto r, auto r_ref, auto det_old) {
+    EXPECT_NEAR(r, r_ref, precision * std::abs(r));
+    d.complete_operation();
+    d_ref.complete_operation();
+    EXPECT_NEAR(d.determinant(), det_old * r, precision * std::abs(d.determinant()));
+    EXPECT_NEAR(d.determinant(), d_ref.determinant(), precision * std::abs(d.determinant()));
+    EXPECT_ARRAY_NEAR(d.inverse_matrix(), d_ref.inverse_matrix(), precision);
+    EXPECT_ARRAY_NEAR(nda::matrix<double>{inverse(d.matrix())}, d.inverse_matrix(), precision);
+  };
+
+  for (int n = 0; n < 30; ++n) {
+    long N = d.size();
+
+    // insertion at random distinct positions (in random order)
+    std::array<long, K> i, j;
+    std::array<double, K> x, y;
+    std::vector<long> iv(N + K), jv(N + K);
+    std::iota(iv.begin(), iv.end(), 0);
+    std::iota(jv.begin(), jv.end(), 0);
+    std::shuffle(iv.begin(), iv.end(), gen);
+    std::shuffle(jv.begin(), jv.end(), gen);
+    for (size_t l = 0; l < K; ++l) {
+      i[l] = iv[l];
+      j[l] = jv[l];
+      x[l] = dis(gen);
+      y[l] = dis(gen);
+    }
+
+    auto r_ref = d_ref.try_insert_k(std::vector<long>(i.begin(), i.end()), std::vector<long>(j.begin(), j.end()),
+                                    std::vector<double>(x.begin(), x.end()), std::vector<double>(y.begin(), y.end()));
+    auto det_old = d.determinant();
+    auto r       = d.try_insert_k(i, j, x, y);
+    check(r, r_ref, det_old);
+
+    // removal, one out of three steps
+    if (n % 3 != 2) continue;
+    N = d.size();
+    iv.resize(N);
+    jv.resize(N);
+    std::iota(iv.begin(), iv.end(), 0);
+    std::iota(jv.begin(), jv.end(), 0);
+    std::shuffle(iv.begin(), iv.end(), gen);
+    std::shuffle(jv.begin(), jv.end(), gen);
+    for (size_t l = 0; l < K; ++l) {
+      i[l] = iv[l];
+      j[l] = jv[l];
+    }
+    r_ref   = d_ref.try_remove_k(std::vector<long>(i.begin(), i.end()), std::vector<long>(j.begin(), j.end()));
+    det_old = d.determinant();
+    r       = d.try_remove_k(i, j);
+    check(r, r_ref, det_old);
+  }
+}
+
+TEST(DetManip, FixedK) {
+  std::mt19937 gen(23432);
+  check_fixed_k<2>(gen);
+  check_fixed_k<3>(gen);
+  check_fixed_k<4>(gen);
+  check_fixed_k<5>(gen); // beyond the unrolled sizes : runtime k path
+}
+
+TEST(DetManip, FixedKDelayed) {
+  std::mt19937 gen(7243);
+  check_fixed_k<2>(gen, 4);
+  check_fixed_k<3>(gen, 8);
+  check_fixed_k<4>(gen, 8);
+}
+
+MAKE_MAIN;
@@ -0,0 +1,183 @@
+// Copyright (c) 2026 Simons Foundation
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You may obtain a copy of the License at
+//     https://www.gnu.org/licenses/gpl-3.0.txt
+
+#include <triqs/test_tools/arrays.hpp>
+#include <triqs/det_manip/det_manip.hpp>
+#include <random>
+
+struct fun {
+
+  using result_type   = double;
+  using argument_type = double;
+
+  double operator()(double x, double y) const {
+    const double pi   = acos(-1);
+    const double beta = 10.0;
+    const double epsi = 0.1;
+    double tau        = x - y;
+    bool s            = (tau > 0);
+    tau               = (s ? tau : beta + tau);
+    double r          = epsi + tau / beta * (1 - 2 * epsi);
+    return -2 * (pi / beta) / std::sin(pi * r);
+  }
+};
+
+using d_t = triqs::det_manip::det_manip<fun>;
+using f_t = triqs::det_manip::det_manip<fun, float>; // inverse stored in single precision
+
+// Same random sequence of operations with the inverse stored in double and single precision,
+// with n_delayed delayed updates
+void check_single_precision(long n_delayed) {
+
+  static_assert(f_t::is_mixed_precision and not d_t::is_mixed_precision);
+
+  std::mt19937 gen(23432);
+  std::uniform_real_distribution<> dis(0.0, 10.0);
+
+  auto d_ref = d_t{fun{}, 10};
+  auto d     = f_t{fun{}, 10};
+  d.set_n_operations_before_check(20);
+  d_ref.set_n_delayed_updates(n_delayed);
+  d.set_n_delayed_updates(n_delayed);
+
+  for (int n = 0; n < 500; ++n) {
+    long N    = d.size();
+    double r1 = 0, r2 = 0;
+    switch (n < 30 ? 0 : gen() % 9) {
+      case 0: {
+        long i = gen() % (N + 1), j = gen() % (N + 1);
+        double x = dis(gen), y = dis(gen);
+        r1 = d_ref.try_insert(i, j, x, y);
+        r2 = d.try_insert(i, j, x, y);
+        break;
+      }
+      case 1: {
+        if (N < 2) continue;
+        long i = gen() % N, j = gen() % N;
+        r1 = d_ref.try_remove(i, j);
+        r2 = d.try_remove(i, j);
+        break;
+      }
+      case 2: {
+        if (N < 1) continue;
+        long j   = gen() % N;
+        double y = dis(gen);
+        r1       = d_ref.try_change_col(j, y);
+        r2       = d.try_change_col(j, y);
+        break;
+      }
+      case 3: {
+        long i0 = gen() % (N + 1), j0 = gen() % (N + 1);
+        double x0 = dis(gen), x1 = dis(gen), y0 = dis(gen), y1 = dis(gen);
+        r1 = d_ref.try_insert2(i0, i0 + 1, j0, j0 + 1, x0, x1, y0, y1);
+        r2 = d.try_insert2(i0, i0 + 1, j0, j0 + 1, x0, x1, y0, y1);
+        break;
+      }
+      case 4: {
+        if (N < 1) continue;
+        long i   = gen() % N;
+        double x = dis(gen);
+        r1       = d_ref.try_change_row(i, x);
+        r2       = d.try_change_row(i, x);
+        break;
+      }
+      case 5: {
+        if (N < 1) continue;
+        long i = gen() % N, j = gen() % N;
+        double x = dis(gen), y = dis(gen);
+        r1 = d_ref.try_change_col_row(i, j, x, y);
+        r2 = d.try_change_col_row(i, j, x, y);
+        break;
+      }
+      case 6: {
+        if (N < 3) continue;
+        long i0 = gen() % (N - 1), j0 = gen() % (N - 1);
+        r1 = d_ref.try_remove2(i0, i0 + 1, j0, j0 + 1);
+        r2 = d.try_remove2(i0, i0 + 1, j0, j0 + 1);
+        break;
+      }
+      case 7: { // runtime k : products of ksi with the panels
+        long i0 = gen() % (N + 1), j0 = gen() % (N + 1);
+        std::vector<long> i{i0, i0 + 1, i0 + 2}, j{j0, j0 + 1, j0 + 2};
+        std::vector<double> x{dis(gen), dis(gen), dis(gen)}, y{dis(gen), dis(gen), dis(gen)};
+        r1 = d_ref.try_insert_k(i, j, x, y);
+        r2 = d.try_insert_k(i, j, x, y);
+        break;
+      }
+      case 8: {
+        if (N < 4) continue;
+        long i0 = gen() % (N - 2), j0 = gen() % (N - 2);
+        std::vector<long> i{i0, i0 + 1, i0 + 2}, j{j0, j0 + 1, j0 + 2};
+        r1 = d_ref.try_remove_k(i, j);
+        r2 = d.try_remove_k(i, j);
+        break;
+      }
+    }
+
+    EXPECT_NEAR(r1, r2, 1.e-4 * std::abs(r1));
+
+    if (std::abs(r1) > 1.e-2 and std::abs(r1) < 1.e2) {
+      d_ref.complete_operation();
+      d.complete_operation();
+    } else {
+      d_ref.reject_last_try();
+      d.reject_last_try();
+    }
+
+    EXPECT_NEAR(d_ref.determinant(), d.determinant(), 1.e-4 * std::abs(d_ref.determinant()));
+    EXPECT_ARRAY_NEAR(d_ref.inverse_matrix(), d.inverse_matrix(), 1.e-4);
+  }
+
+  // regeneration in double precision
+  d.regenerate();
+  EXPECT_NEAR(d_ref.determinant(), d.determinant(), 1.e-10 * std::abs(d_ref.determinant()));
+}
+
+TEST(DetManip, SinglePrecisionInverse) { check_single_precision(0); }
+
+TEST(DetManip, SinglePrecisionDelayed) { check_single_precision(8); }
+
+// Adaptive check period in single precision : shortened after warnings down to the minimum, then grows back
+TEST(DetManip, SinglePrecisionCheckPeriod) {
+
+  std::mt19937 gen(23432);
+  std::uniform_real_distribution<> dis(0.0, 10.0);
+
+  auto d = f_t{fun{}, 10};
+  d.set_n_operations_before_check(40);
+
+  auto run = [&](int n_ops) {
+    for (int n = 0; n < n_ops; ++n) {
+      long N = d.size();
+      double r = (N < 8 or gen() % 2) ? d.try_insert(gen() % (N + 1), gen() % (N + 1), dis(gen), dis(gen)) : d.try_remove(gen() % N, gen() % N);
+      if (std::abs(r) > 1.e-2 and std::abs(r) < 1.e2)
+        d.complete_operation();
+      else
+        d.reject_last_try();
+    }
+  };
+
+  // every check is above the warning threshold : the period is halved down to the minimum, then the warnings are reported
+  d.set_precision_warning(1.e-14);
+  run(400);
+  EXPECT_EQ(d.get_n_operations_before_check(), f_t::n_opts_min_before_check);
+
+  // clean checks : back to the period set by the user
+  d.set_precision_warning(1.e-3);
+  run(400);
+  EXPECT_EQ(d.get_n_operations_before_check(), 40);
+}
+
+MAKE_MAIN;
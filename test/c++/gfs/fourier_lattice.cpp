@@ -66,4 +66,59 @@ TEST(FourierLattice, Matrix) { test_fourier<2>(); }
 TEST(FourierLattice, Tensor3) { test_fourier<3>(); }
 TEST(FourierLattice, Tensor4) { test_fourier<4>(); }
 
+// Real, Hermitian and generic inputs are transformed with r2c, c2r and c2c FFTs, with the same results
+TEST(FourierLattice, RealInput) {
+  triqs::clef::placeholder<0> r_;
+  auto bl = bravais_lattice{nda::eye<double>(2)};
+
+  auto Gr = gf<cyclat, matrix_valued>{{bl, 6}, {2, 2}};
+  Gr(r_) << exp(-r_[0]) + 0.5 * r_[1];
+
+  // a tiny imaginary part forces the generic complex transform
+  auto Gr_c = Gr;
+  Gr_c.data() += 1e-300i;
+
+  auto Gk   = make_gf_from_fourier(Gr);
+  auto Gk_c = make_gf_from_fourier(Gr_c);
+  EXPECT_GF_NEAR(Gk, Gk_c, 1e-13);
+
+  // Gk is Hermitian, G(-k) = conj(G(k)) : its transform is real
+  auto Gr2 = make_gf_from_fourier(Gk);
+  EXPECT_GF_NEAR(Gr, Gr2, 1e-13);
+  EXPECT_EQ(max_element(abs(imag(Gr2.data()))), 0);
+}
+
+TEST(FourierLattice, PlanCache) {
+  triqs::clef::placeholder<0> r_;
+  auto bl = bravais_lattice{nda::eye<double>(2)};
+
+  auto Gr = gf<cyclat, matrix_valued>{{bl, 4}, {2, 2}};
+  Gr(r_) << exp(-r_[0]);
+
+  clear_fftw_plan_cache();
+  auto Gk = make_gf_from_fourier(Gr);
+  auto n  = fftw_plan_cache_size();
+  EXPECT_GT(n, 0);
+
+  // the same shape again reuses the plan
+  auto Gk2 = make_gf_from_fourier(Gr);
+  EXPECT_EQ(n, fftw_plan_cache_size());
+  EXPECT_GF_NEAR(Gk, Gk2, 1e-14);
+
+  // measured plans give the same transform, and do not touch the input
+  auto Gr_copy = Gr;
+  set_fftw_planning(fftw_planning::measure);
+  auto Gk3 = make_gf_from_fourier(Gr);
+  set_fftw_planning(fftw_planning::estimate);
+  EXPECT_GF_NEAR(Gk, Gk3, 1e-12);
+  EXPECT_ARRAY_EQ(Gr.data(), Gr_copy.data());
+
+  export_fftw_wisdom("fourier_lattice_wisdom");
+  EXPECT_TRUE(import_fftw_wisdom("fourier_lattice_wisdom"));
+  EXPECT_FALSE(import_fftw_wisdom("no_such_dir/wisdom"));
+
+  clear_fftw_plan_cache();
+  EXPECT_EQ(0, fftw_plan_cache_size());
+}
+
 MAKE_MAIN;
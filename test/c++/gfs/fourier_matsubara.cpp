@@ -135,4 +135,46 @@ TEST(Gfs, FourierMatsubaraAllFreq) {
   ASSERT_THROW(Gt1() = fourier(Gw1), triqs::runtime_error);
 }
 
+// G(tau) is real : given its moments, it can be computed from the positive frequencies only
+TEST(Gfs, FourierMatsubaraPositiveOnly) {
+  triqs::clef::placeholder<0> iw_;
+  double beta = 10, E = 1.5;
+
+  for (auto statistic : {Fermion, Boson}) {
+    auto Gw = gf<imfreq>{{beta, statistic, 200}, {2, 2}};
+    Gw(iw_) << 1 / (iw_ - E);
+
+    auto known_moments            = make_zero_tail(Gw, 4);
+    known_moments(1, ellipsis()) = 1.;
+    known_moments(2, ellipsis()) = E;
+    known_moments(3, ellipsis()) = E * E;
+
+    auto tau_mesh = mesh::imtime{beta, statistic, 2001};
+    auto Gt       = make_gf_from_fourier(Gw, tau_mesh, known_moments);
+    auto Gt_pos   = make_gf_from_fourier(positive_freq_view(Gw), tau_mesh, known_moments);
+    EXPECT_GF_NEAR(Gt, Gt_pos, 1e-12);
+    EXPECT_EQ(max_element(abs(imag(Gt_pos.data()))), 0);
+  }
+}
+
+// The threaded tail subtraction, FFT and reassembly give the serial result
+TEST(Gfs, FourierMatsubaraThreads) {
+  triqs::clef::placeholder<0> iw_;
+  double beta = 10;
+  auto Gw     = gf<imfreq>{{beta, Fermion, 500}, {8, 8}};
+  Gw(iw_) << 1 / (iw_ - 1) + 1 / (iw_ + 2) - 4.5 / (iw_ - 1.25);
+
+  auto Gt1 = make_gf_from_fourier(Gw, 4000);
+  auto Gw1 = make_gf_from_fourier(Gt1, 500);
+
+  set_fftw_threads(4);
+  auto Gt4 = make_gf_from_fourier(Gw, 4000);
+  auto Gw4 = make_gf_from_fourier(Gt4, 500);
+  set_fftw_threads(1);
+
+  EXPECT_GF_NEAR(Gt1, Gt4, 1e-12);
+  EXPECT_GF_NEAR(Gw1, Gw4, 1e-12);
+  EXPECT_THROW(set_fftw_threads(0), triqs::runtime_error);
+}
+
 MAKE_MAIN;
@@ -0,0 +1,48 @@
+// Copyright (c) 2026 Simons Foundation
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You may obtain a copy of the License at
+//     https://www.gnu.org/licenses/gpl-3.0.txt
+
+#include <triqs/test_tools/gfs.hpp>
+
+mpi::communicator world;
+
+// G(k, iw) distributed over k is transformed to G(R, iw) distributed over R, and back
+TEST(FourierLattice, Distributed) {
+  triqs::clef::placeholder<0> k_;
+  triqs::clef::placeholder<1> iw_;
+
+  auto bl      = bravais_lattice{nda::eye<double>(2)};
+  auto k_mesh  = mesh::brzone(brillouin_zone{bl}, 5);
+  auto r_mesh  = mesh::cyclat(bl, 5);
+  auto iw_mesh = mesh::imfreq{1, Fermion, 7};
+
+  auto g = gf<prod<brzone, imfreq>, matrix_valued>{{k_mesh, iw_mesh}, {2, 2}};
+  g(k_, iw_) << 1 / (iw_ - cos(k_[0]) - 0.3 * sin(k_[1]));
+  auto g_r = make_gf_from_fourier<0>(g, r_mesh);
+
+  auto [first, last] = itertools::chunk_range(0, k_mesh.size(), world.size(), world.rank());
+  auto _             = range::all;
+  auto d_k           = array<dcomplex, 4>{g.data()(range(first, last), _, _, _)};
+
+  auto d_r = make_array_from_distributed_fourier(d_k, k_mesh, r_mesh, world);
+  EXPECT_ARRAY_NEAR(d_r, g_r.data()(range(first, last), _, _, _), 1e-14);
+
+  auto d_kb = make_array_from_distributed_fourier(d_r, r_mesh, k_mesh, world);
+  EXPECT_ARRAY_NEAR(d_kb, d_k, 1e-14);
+
+  // the data do not match the chunk of the rank
+  if (world.size() > 1) EXPECT_THROW(make_array_from_distributed_fourier(g.data(), k_mesh, r_mesh, world), triqs::runtime_error);
+}
+
+MAKE_MAIN;
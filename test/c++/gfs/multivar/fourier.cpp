@@ -100,4 +100,31 @@ TEST(FourierMultivar, Matrix) { test_fourier<2>(); }  // NOLINT
 TEST(FourierMultivar, Tensor3) { test_fourier<3>(); } // NOLINT
 TEST(FourierMultivar, Tensor4) { test_fourier<4>(); } // NOLINT
 
+// The lattice transform of a middle mesh acts directly on the strided data : compare with the transforms of each slice
+TEST(FourierMultivar, StridedLattice) { // NOLINT
+  triqs::clef::placeholder<0> iw_;
+  triqs::clef::placeholder<1> k_;
+  triqs::clef::placeholder<2> t_;
+
+  auto BL      = bravais_lattice{matrix<double>{{1, 0}, {0, 1}}};
+  auto k_mesh  = mesh::brzone(brillouin_zone{BL}, 6);
+  auto iw_mesh = mesh::imfreq{1, Fermion, 5};
+  auto t_mesh  = mesh::imtime{1, Fermion, 3};
+
+  auto g = gf<prod<imfreq, brzone, imtime>, matrix_valued>{{iw_mesh, k_mesh, t_mesh}, {2, 2}};
+  g(iw_, k_, t_) << (1 + t_) / (iw_ - cos(k_[0]) - 0.3 * sin(k_[1]));
+
+  auto g_r = make_gf_from_fourier<1>(g, mesh::cyclat(BL, 6));
+  for (auto iw : iw_mesh)
+    for (auto t : t_mesh) {
+      auto g_k = gf<brzone, matrix_valued>{k_mesh, {2, 2}};
+      for (auto k : k_mesh) g_k[k] = g[iw, k, t];
+      auto g_r_slice = make_gf_from_fourier(g_k);
+      for (auto r : g_r_slice.mesh()) EXPECT_ARRAY_NEAR(g_r[iw, r, t], g_r_slice[r], 1e-14);
+    }
+
+  auto gb = make_gf_from_fourier<1>(g_r, k_mesh);
+  EXPECT_GF_NEAR(g, gb, 1e-13);
+}
+
 MAKE_MAIN;
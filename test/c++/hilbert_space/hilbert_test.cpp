@@ -21,6 +21,7 @@
 #include <triqs/test_tools/gfs.hpp>
 #include <sstream>
 #include <map>
+#include <bitset>
 
 #include <triqs/operators/many_body_operator.hpp>
 #include <triqs/hilbert_space/hilbert_space.hpp>
@@ -210,6 +211,67 @@ TEST(hilbert_space, QuarticOperators) {
   check_state(imperative_operator<hilbert_space>(quartic_op, fops)(st1), {{6, 1.0}}); // new state
 }
 
+TEST(hilbert_space, MatrixElements) {
+  fundamental_operator_set fops;
+  for (int i = 0; i < 2; ++i) fops.insert("down", i);
+  for (int i = 0; i < 2; ++i) fops.insert("up", i);
+
+  using triqs::hilbert_space::hilbert_space;
+  hilbert_space hs(fops);
+
+  using triqs::operators::c;
+  using triqs::operators::c_dag;
+  using triqs::operators::n;
+  auto H = -1.0 * c_dag("up", 0) * c_dag("down", 1) * c("up", 1) * c("down", 0) + 2.0 * n("up", 0) * n("down", 1)
+     + 0.5 * (c_dag("up", 0) * c("up", 1) + c_dag("up", 1) * c("up", 0));
+  auto opH = imperative_operator<hilbert_space>(H, fops);
+
+  // from : all the Fock states, to : those with 2 particles
+  sub_hilbert_space from(0), to(1);
+  for (int i = 0; i < hs.size(); ++i) {
+    from.add_fock_state(hs.get_fock_state(i));
+    if (std::bitset<64>(hs.get_fock_state(i)).count() == 2) to.add_fock_state(hs.get_fock_state(i));
+  }
+  EXPECT_EQ(to.find_state_index(to.get_fock_state(3)), 3);
+  EXPECT_EQ(to.find_state_index(hs.get_fock_state(1)), -1);
+
+  auto m = nda::matrix<double>::zeros({to.size(), from.size()});
+  opH.for_each_matrix_element(from, to, [&m](int i, int j, double x) { m(j, i) += x; });
+
+  // compare with the action of the operator on each Fock state, projected on to
+  auto m_ref = nda::matrix<double>::zeros({to.size(), from.size()});
+  for (int i = 0; i < from.size(); ++i) {
+    state<hilbert_space, double, false> st(hs);
+    st(i)     = 1.0;
+    auto proj = project<state<sub_hilbert_space, double, false>>(opH(st), to);
+    for (int j = 0; j < to.size(); ++j) m_ref(j, i) = proj(j);
+  }
+  EXPECT_ARRAY_NEAR(m, m_ref, 1e-15);
+  EXPECT_GT(max_element(abs(m)), 0);
+}
+
+TEST(hilbert_space, DiagonalElement) {
+  fundamental_operator_set fops;
+  for (int i = 0; i < 2; ++i) fops.insert("down", i);
+  for (int i = 0; i < 2; ++i) fops.insert("up", i);
+
+  using triqs::hilbert_space::hilbert_space;
+  hilbert_space hs(fops);
+
+  using triqs::operators::c;
+  using triqs::operators::c_dag;
+  using triqs::operators::n;
+  auto Q = -1.0 * c_dag("up", 0) * c_dag("down", 1) * c("down", 1) * c("up", 0) + 2.0 * n("up", 0) * n("down", 1) - 0.5 * n("up", 1)
+     + 0.5 * (c_dag("up", 0) * c("up", 1) + c_dag("up", 1) * c("up", 0)) + 3.0;
+  auto opQ = imperative_operator<hilbert_space>(Q, fops);
+
+  for (int i = 0; i < hs.size(); ++i) {
+    state<hilbert_space, double, false> st(hs);
+    st(i) = 1.0;
+    EXPECT_NEAR(opQ.diagonal_element(hs.get_fock_state(i)), dot_product(st, opQ(st)), 1e-15);
+  }
+}
+
 TEST(hilbert_space, StateProjection) {
   fundamental_operator_set fop;
   for (int i = 0; i < 3; ++i) fop.insert("s", i);
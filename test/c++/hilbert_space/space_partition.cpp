@@ -393,3 +393,25 @@ TEST(space_partition, Phase2) {
     }
   }
 }
+
+// The sweeps split over several threads give the same partition and matrix elements
+TEST(space_partition, Threads) {
+
+  hilbert_space hs(fops);
+  state_t st(hs);
+  imp_op_t Hop(H, fops);
+
+  space_partition<state_t, imp_op_t> SP1(st, Hop, true, imp_op_t(), 1);
+  space_partition<state_t, imp_op_t> SP4(st, Hop, true, imp_op_t(), 4);
+  EXPECT_EQ(SP1.get_matrix_elements(), SP4.get_matrix_elements());
+
+  for (int o = 0; o < 3; ++o)
+    for (auto spin : {"up", "dn"}) {
+      imp_op_t Cd(c_dag(spin, o), fops), C(c(spin, o), fops);
+      EXPECT_EQ(SP1.merge_subspaces(Cd, C), SP4.merge_subspaces(Cd, C));
+    }
+
+  ASSERT_EQ(SP1.n_subspaces(), SP4.n_subspaces());
+  for (int s = 0; s < hs.size(); ++s) EXPECT_EQ(SP1.lookup_basis_state(s), SP4.lookup_basis_state(s));
+  EXPECT_EQ(SP1.find_mappings(imp_op_t(c_dag("up", 0) * c("dn", 1), fops)), SP4.find_mappings(imp_op_t(c_dag("up", 0) * c("dn", 1), fops)));
+}
@@ -0,0 +1,140 @@
+// Copyright (c) 2026 Simons Foundation
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You may obtain a copy of the License at
+//     https://www.gnu.org/licenses/gpl-3.0.txt
+
+#include <triqs/test_tools/arrays.hpp>
+#include <triqs/mc_tools/mc_generic.hpp>
+#include <triqs/utility/callbacks.hpp>
+
+// --------------- the configuration: a spin in a field ---
+struct config_t {
+  double beta = 0.3, h = 0.5;
+  int spin    = -1;
+};
+
+// --------------- a move: flip the spin ---------------
+struct flip {
+  config_t *config;
+  double attempt() { return std::exp(-2 * config->spin * config->h * config->beta); }
+  double accept() {
+    config->spin *= -1;
+    return 1.0;
+  }
+  void reject() {}
+};
+
+//  ----------------- a measurement: the magnetization ------------
+struct compute_m {
+  config_t *config;
+  double Z = 0, M = 0;
+
+  void accumulate(double sign) {
+    Z += sign;
+    M += sign * config->spin;
+  }
+
+  void collect_results(mpi::communicator) {}
+
+  friend void h5_write(h5::group g, std::string const &name, compute_m const &m) {
+    auto gr = g.create_group(name);
+    h5_write(gr, "Z", m.Z);
+    h5_write(gr, "M", m.M);
+  }
+
+  friend void h5_read(h5::group g, std::string const &name, compute_m &m) {
+    auto gr = g.open_group(name);
+    h5_read(gr, "Z", m.Z);
+    h5_read(gr, "M", m.M);
+  }
+};
+
+using mc_t = triqs::mc_tools::mc_generic<double>;
+
+// An mc_generic on config, with its measure
+auto make_mc(std::string rng_name, config_t &config, int n_walkers, std::vector<config_t> &walker_configs) {
+  auto mc = std::make_unique<mc_t>(rng_name, 2345, 0);
+  auto setup = [&config, &walker_configs](mc_t &m, int w) {
+    auto &c = (w == 0 ? config : walker_configs[w - 1]);
+    m.add_move(flip{&c}, "flip");
+    m.add_measure(compute_m{&c}, "magnetization");
+    m.set_checkpoint_functions([&c](h5::group g) { h5_write(g, "spin", c.spin); }, [&c](h5::group g) { h5_read(g, "spin", c.spin); });
+  };
+  setup(*mc, 0);
+  walker_configs.resize(n_walkers - 1);
+  mc->set_n_walkers(n_walkers, setup);
+  return mc;
+}
+
+// The results of all walkers
+std::vector<double> results(mc_t &mc) {
+  std::vector<double> r;
+  for (int w = 0; w < mc.get_n_walkers(); ++w) {
+    auto f = h5::file("checkpoint_results.h5", 'w');
+    h5_write(f, "mc", mc.get_walker(w));
+    r.push_back(h5::read<double>(f, "mc/measures/magnetization/M"));
+    r.push_back(h5::read<double>(f, "mc/measures/magnetization/Z"));
+  }
+  r.push_back(mc.get_current_cycle_number());
+  return r;
+}
+
+// A run interrupted by a checkpoint and restored in a new mc_generic gives the same results as an uninterrupted one
+TEST(mc_generic, CheckpointRestore) {
+  for (std::string rng_name : {"", "philox4x32"}) {
+    for (int n_walkers : {1, 3}) {
+      config_t c1, c2, c3;
+      std::vector<config_t> wc1, wc2, wc3;
+
+      auto mc1 = make_mc(rng_name, c1, n_walkers, wc1);
+      mc1->warmup_and_accumulate(100, 2000, 10, triqs::utility::clock_callback(-1));
+
+      auto mc2 = make_mc(rng_name, c2, n_walkers, wc2);
+      mc2->warmup_and_accumulate(100, 1000, 10, triqs::utility::clock_callback(-1));
+      {
+        auto f = h5::file("checkpoint.h5", 'w');
+        mc2->checkpoint(f.create_group("mc"));
+      }
+
+      auto mc3 = make_mc(rng_name, c3, n_walkers, wc3);
+      {
+        auto f = h5::file("checkpoint.h5", 'r');
+        mc3->restore(f.open_group("mc"));
+      }
+      EXPECT_EQ(mc3->get_current_cycle_number(), 1100);
+      mc3->accumulate(1000, 10, triqs::utility::clock_callback(-1));
+
+      EXPECT_EQ(results(*mc1), results(*mc3));
+      EXPECT_EQ(mc1->get_acceptance_rates(), mc3->get_acceptance_rates());
+    }
+  }
+}
+
+// Periodic checkpoints during the run
+TEST(mc_generic, PeriodicCheckpoint) {
+  config_t c1, c2;
+  std::vector<config_t> wc1, wc2;
+
+  auto mc1 = make_mc("", c1, 2, wc1);
+  mc1->set_checkpoint_file("periodic_checkpoint.h5", 1.e-3);
+  mc1->accumulate(200000, 10, triqs::utility::clock_callback(-1));
+
+  // the last checkpoint can be restored
+  auto mc2 = make_mc("", c2, 2, wc2);
+  auto f   = h5::file("periodic_checkpoint.h5", 'r');
+  mc2->restore(f.open_group("mc_generic"));
+  EXPECT_GT(mc2->get_current_cycle_number(), 0);
+  EXPECT_LE(mc2->get_current_cycle_number(), 200000);
+}
+
+MAKE_MAIN;
@@ -0,0 +1,107 @@
+// Copyright (c) 2026 Simons Foundation
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You may obtain a copy of the License at
+//     https://www.gnu.org/licenses/gpl-3.0.txt
+
+#include <triqs/test_tools/arrays.hpp>
+#include <triqs/mc_tools/mc_generic.hpp>
+#include <triqs/utility/callbacks.hpp>
+#include <chrono>
+#include <thread>
+
+// --------------- the configuration: a spin in a field ---
+struct config_t {
+  double beta, h;
+  int spin = -1;
+};
+
+// --------------- a move: flip the spin. Slower on odd ranks ---------------
+struct flip {
+  config_t *config;
+  int delay_us = 0;
+  double attempt() {
+    if (delay_us > 0) std::this_thread::sleep_for(std::chrono::microseconds(delay_us));
+    return std::exp(-2 * config->spin * config->h * config->beta);
+  }
+  double accept() {
+    config->spin *= -1;
+    return 1.0;
+  }
+  void reject() {}
+};
+
+//  ----------------- a measurement: the magnetization ------------
+struct compute_m {
+  config_t *config;
+  double *m_result;
+  double Z = 0, M = 0;
+
+  void accumulate(double sign) {
+    Z += sign;
+    M += sign * config->spin;
+  }
+
+  void collect_results(mpi::communicator c) {
+    Z         = mpi::all_reduce(Z, c);
+    M         = mpi::all_reduce(M, c);
+    *m_result = M / Z;
+  }
+};
+
+mpi::communicator world;
+
+// The ranks run at different speeds, and together do the requested total number of cycles
+TEST(mc_generic, CollectiveStop) {
+
+  long n_cycles = 2000;
+  config_t config{0.3, 0.5};
+  double m_result = 0;
+
+  triqs::mc_tools::mc_generic<double> mc("", 374982 + world.rank() * 273894, 0);
+  mc.add_move(flip{&config, (world.rank() % 2 == 1 ? 50 : 0)}, "flip move");
+  mc.add_measure(compute_m{&config, &m_result}, "magnetization measure");
+  mc.set_collective_stop(true);
+
+  mc.warmup(10, 10, triqs::utility::clock_callback(-1));
+  EXPECT_EQ(mc.get_current_cycle_number(), 10);
+
+  int status = mc.accumulate(n_cycles, 10, triqs::utility::clock_callback(-1));
+  EXPECT_EQ(status, 0);
+
+  long n_local = mc.get_current_cycle_number();
+  long n_total = mpi::all_reduce(n_local, world);
+  EXPECT_GE(n_total, n_cycles);
+
+  mc.collect_results(world);
+  EXPECT_NEAR(m_result, std::tanh(config.beta * config.h), 0.1);
+}
+
+// A stop requested on one rank stops all of them
+TEST(mc_generic, CollectiveStopRequest) {
+
+  config_t config{0.3, 0.5};
+  double m_result = 0;
+
+  triqs::mc_tools::mc_generic<double> mc("", 1234 + world.rank(), 0);
+  mc.add_move(flip{&config}, "flip move");
+  mc.add_measure(compute_m{&config, &m_result}, "magnetization measure");
+  mc.set_collective_stop(true);
+
+  long n_stop = 500;
+  auto stop   = [&]() { return world.rank() == 0 and mc.get_current_cycle_number() >= n_stop; };
+  int status  = mc.accumulate(-1, 10, stop);
+  EXPECT_EQ(status, 1);
+  if (world.rank() == 0) { EXPECT_GE(mc.get_current_cycle_number(), n_stop); }
+}
+
+MAKE_MAIN;
@@ -0,0 +1,201 @@
+// Copyright (c) 2026 Simons Foundation
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You may obtain a copy of the License at
+//     https://www.gnu.org/licenses/gpl-3.0.txt
+
+#include <triqs/test_tools/arrays.hpp>
+#include <triqs/mc_tools/mc_generic.hpp>
+#include <triqs/utility/callbacks.hpp>
+#include <limits>
+#include <set>
+
+// --------------- the configuration: a spin in a field. beta and h are shared by all walkers ---
+struct params_t {
+  double beta, h;
+};
+
+struct config_t {
+  params_t const *params;
+  int spin = -1;
+};
+
+// --------------- a move: flip the spin ---------------
+struct flip {
+  config_t *config;
+  double attempt() { return std::exp(-2 * config->spin * config->params->h * config->params->beta); }
+  double accept() {
+    config->spin *= -1;
+    return 1.0;
+  }
+  void reject() {}
+};
+
+//  ----------------- a measurement: the magnetization ------------
+struct compute_m {
+  config_t *config;
+  double *m_result;
+  double Z = 0, M = 0;
+
+  void accumulate(double sign) {
+    Z += sign;
+    M += sign * config->spin;
+  }
+
+  void merge(compute_m const &other) {
+    Z += other.Z;
+    M += other.M;
+  }
+
+  void collect_results(mpi::communicator c) {
+    Z         = mpi::all_reduce(Z, c);
+    M         = mpi::all_reduce(M, c);
+    *m_result = M / Z;
+  }
+};
+
+// The same measure, which can be reset. collect_results does not modify the data, so that it can be called after each run
+struct compute_m_reset {
+  config_t *config;
+  double *Z_result;
+  double Z = 0, M = 0;
+
+  void accumulate(double sign) {
+    Z += sign;
+    M += sign * config->spin;
+  }
+
+  void merge(compute_m_reset const &other) {
+    Z += other.Z;
+    M += other.M;
+  }
+
+  void reset() { Z = M = 0; }
+
+  void collect_results(mpi::communicator c) { *Z_result = mpi::all_reduce(Z, c); }
+};
+
+// The same measure, without merge
+struct compute_m_no_merge {
+  config_t *config;
+  void accumulate(double) {}
+  void collect_results(mpi::communicator) {}
+};
+
+mpi::communicator world;
+
+TEST(mc_generic, MultiWalker) {
+
+  int n_walkers = 4, n_cycles = 20000;
+  params_t params{0.3, 0.5};
+
+  // one configuration per walker
+  std::vector<config_t> configs(n_walkers, config_t{&params});
+  double m_result = 0;
+
+  triqs::mc_tools::mc_generic<double> mc("", 374982 + world.rank() * 273894, (world.rank() == 0 ? 3 : 0));
+  mc.add_move(flip{&configs[0]}, "flip move");
+  mc.add_measure(compute_m{&configs[0], &m_result}, "magnetization measure");
+
+  mc.set_n_walkers(n_walkers, [&](auto &walker, int w) {
+    walker.add_move(flip{&configs[w]}, "flip move");
+    walker.add_measure(compute_m{&configs[w], &m_result}, "magnetization measure");
+  });
+  EXPECT_EQ(mc.get_n_walkers(), n_walkers);
+  EXPECT_EQ(&mc.get_walker(0), &mc);
+
+  mc.warmup_and_accumulate(100, n_cycles, 10, triqs::utility::clock_callback(-1));
+
+  // all walkers have run all cycles
+  for (int w = 0; w < n_walkers; ++w) EXPECT_EQ(mc.get_walker(w).get_current_cycle_number(), n_cycles + 100);
+
+  mc.collect_results(world);
+
+  // measures are merged from all walkers on all nodes
+  double bh = params.beta * params.h;
+  EXPECT_NEAR(m_result, std::tanh(bh), 0.02);
+
+  // the acceptance rate is collected over all walkers
+  EXPECT_NEAR(mc.get_acceptance_rates()["flip move"], std::exp(-bh) / std::cosh(bh), 0.02);
+}
+
+// run, collect_results, run, collect_results : the data of each run are merged once
+TEST(mc_generic, MultiWalkerTwoRuns) {
+
+  int n_walkers = 3, n_cycles = 1000;
+  params_t params{0.3, 0.5};
+  std::vector<config_t> configs(n_walkers, config_t{&params});
+  double Z_result = 0;
+
+  triqs::mc_tools::mc_generic<double> mc("", 1234, 0);
+  mc.add_move(flip{&configs[0]}, "flip move");
+  mc.add_measure(compute_m_reset{&configs[0], &Z_result}, "measure");
+  mc.set_n_walkers(n_walkers, [&](auto &walker, int w) {
+    walker.add_move(flip{&configs[w]}, "flip move");
+    walker.add_measure(compute_m_reset{&configs[w], &Z_result}, "measure");
+  });
+
+  mc.warmup_and_accumulate(10, n_cycles, 10, triqs::utility::clock_callback(-1));
+  mc.collect_results(world);
+  EXPECT_EQ(Z_result, n_walkers * n_cycles * world.size());
+
+  mc.accumulate(n_cycles, 10, triqs::utility::clock_callback(-1));
+  mc.collect_results(world);
+  EXPECT_EQ(Z_result, 2 * n_walkers * n_cycles * world.size());
+
+  // without reset, the data of the walkers can not be merged a second time
+  std::vector<config_t> configs2(2, config_t{&params});
+  triqs::mc_tools::mc_generic<double> mc2("", 1234, 0);
+  mc2.add_move(flip{&configs2[0]}, "flip move");
+  mc2.add_measure(compute_m{&configs2[0], &Z_result}, "measure");
+  mc2.set_n_walkers(2, [&](auto &walker, int w) {
+    walker.add_move(flip{&configs2[w]}, "flip move");
+    walker.add_measure(compute_m{&configs2[w], &Z_result}, "measure");
+  });
+  mc2.warmup_and_accumulate(0, 100, 10, triqs::utility::clock_callback(-1));
+  mc2.collect_results(world);
+  mc2.accumulate(100, 10, triqs::utility::clock_callback(-1));
+  EXPECT_THROW(mc2.collect_results(world), triqs::runtime_error);
+}
+
+TEST(mc_generic, MultiWalkerNoMerge) {
+
+  params_t params{0.3, 0.5};
+  std::vector<config_t> configs(2, config_t{&params});
+
+  triqs::mc_tools::mc_generic<double> mc("", 1234, 0);
+  mc.add_move(flip{&configs[0]}, "flip move");
+  mc.add_measure(compute_m_no_merge{&configs[0]}, "measure");
+  mc.set_n_walkers(2, [&](auto &walker, int w) {
+    walker.add_move(flip{&configs[w]}, "flip move");
+    walker.add_measure(compute_m_no_merge{&configs[w]}, "measure");
+  });
+
+  mc.warmup_and_accumulate(0, 100, 10, triqs::utility::clock_callback(-1));
+  EXPECT_THROW(mc.collect_results(world), triqs::runtime_error);
+}
+
+// The walkers of several ranks (walker 0 on the stream rank) use distinct streams,
+// and a seed close to the maximal int does not overflow
+TEST(mc_generic, MultiWalkerStreams) {
+
+  std::set<uint64_t> streams;
+  for (int rank = 0; rank < 3; ++rank) {
+    triqs::mc_tools::mc_generic<double> mc("philox4x32", std::numeric_limits<int>::max(), 0);
+    mc.get_rng() = mc.get_rng().split(rank);
+    mc.set_n_walkers(4, [](auto &, int) {});
+    for (int w = 0; w < mc.get_n_walkers(); ++w) streams.insert(mc.get_walker(w).get_rng().stream_id());
+  }
+  EXPECT_EQ(streams.size(), 12);
+}
+
+MAKE_MAIN;
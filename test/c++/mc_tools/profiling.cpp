@@ -0,0 +1,121 @@
+// Copyright (c) 2026 Simons Foundation
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You may obtain a copy of the License at
+//     https://www.gnu.org/licenses/gpl-3.0.txt
+
+#include <triqs/test_tools/arrays.hpp>
+#include <triqs/mc_tools/mc_generic.hpp>
+#include <triqs/utility/callbacks.hpp>
+#include <chrono>
+#include <thread>
+
+// --------------- the configuration: a spin in a field ---
+struct config_t {
+  double beta, h;
+  int spin = -1;
+};
+
+// --------------- a move: flip the spin, with an expensive attempt if delay_us > 0 ---------------
+struct flip {
+  config_t *config;
+  int delay_us = 0;
+  double attempt() {
+    if (delay_us > 0) std::this_thread::sleep_for(std::chrono::microseconds(delay_us));
+    return std::exp(-2 * config->spin * config->h * config->beta);
+  }
+  double accept() {
+    config->spin *= -1;
+    return 1.0;
+  }
+  void reject() {}
+};
+struct slow_flip : flip {};
+
+//  ----------------- a measurement: the magnetization ------------
+struct compute_m {
+  config_t *config;
+  double M = 0;
+  void accumulate(double sign) { M += sign * config->spin; }
+  void merge(compute_m const &other) { M += other.M; }
+  void collect_results(mpi::communicator c) { M = mpi::all_reduce(M, c); }
+};
+
+mpi::communicator world;
+
+// Check the profile of a run with a cheap and an expensive move
+template <typename MC> void check_profile(MC &mc, int n_walkers, std::vector<config_t> &configs) {
+  int n_duty = 0;
+  mc.add_move(flip{&configs[0]}, "flip");
+  mc.add_move(slow_flip{{&configs[0], 20}}, "slow flip");
+  mc.add_measure(compute_m{&configs[0]}, "magnetization");
+  mc.set_after_cycle_duty([&n_duty]() { ++n_duty; });
+  if (n_walkers > 1)
+    mc.set_n_walkers(n_walkers, [&](auto &walker, int w) {
+      walker.add_move(flip{&configs[w]}, "flip");
+      walker.add_move(slow_flip{{&configs[w], 20}}, "slow flip");
+      walker.add_measure(compute_m{&configs[w]}, "magnetization");
+    });
+  mc.set_profiling(true);
+  mc.warmup_and_accumulate(10, 200, 5, triqs::utility::clock_callback(-1));
+  mc.collect_results(world);
+
+  auto const &p = mc.get_profile();
+  ASSERT_EQ(p.moves.size(), 2);
+  auto const &fast = p.moves.at("flip");
+  auto const &slow = p.moves.at("slow flip");
+
+  // all proposals of the accumulation are counted, on all walkers and ranks
+  EXPECT_EQ(fast.n_proposed + slow.n_proposed, uint64_t(200 * 5 * n_walkers * world.size()));
+  EXPECT_NEAR(double(slow.n_accepted) / slow.n_proposed, mc.get_acceptance_rates()["slow flip"], 1.e-12);
+
+  // the expensive move is expensive per proposal
+  EXPECT_GT(slow.attempt / slow.n_proposed, 1.e-5);
+  EXPECT_GT(slow.attempt / slow.n_proposed, 5 * fast.attempt / fast.n_proposed);
+  EXPECT_GT(p.rng_metropolis, 0);
+  EXPECT_GT(p.after_cycle_duty, 0);
+  EXPECT_EQ(p.measures.count("magnetization"), 1);
+  EXPECT_FALSE(p.report().empty());
+
+  h5::file file("profiling.h5", 'w');
+  h5_write(file, "profile", p);
+}
+
+TEST(mc_generic, Profiling) {
+  std::vector<config_t> configs(1, config_t{0.3, 0.5});
+  triqs::mc_tools::mc_generic<double> mc("", 1234 + world.rank(), 0);
+  check_profile(mc, 1, configs);
+}
+
+TEST(mc_generic, ProfilingWalkers) {
+  std::vector<config_t> configs(3, config_t{0.3, 0.5});
+  triqs::mc_tools::mc_generic<double> mc("", 1234 + world.rank(), 0);
+  check_profile(mc, 3, configs);
+}
+
+TEST(static_mc_generic, Profiling) {
+  std::vector<config_t> configs(1, config_t{0.3, 0.5});
+  triqs::mc_tools::static_mc_generic<double, flip, slow_flip> mc("", 1234 + world.rank(), 0);
+  check_profile(mc, 1, configs);
+}
+
+// Without profiling, the moves are not timed
+TEST(mc_generic, NoProfiling) {
+  config_t config{0.3, 0.5};
+  triqs::mc_tools::mc_generic<double> mc("", 1234, 0);
+  mc.add_move(flip{&config}, "flip");
+  mc.warmup_and_accumulate(0, 100, 5, triqs::utility::clock_callback(-1));
+  mc.collect_results(world);
+  EXPECT_TRUE(mc.get_profile().moves.empty());
+}
+
+MAKE_MAIN;
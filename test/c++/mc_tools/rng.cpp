@@ -18,9 +18,12 @@
 // Authors: Michel Ferrero, Olivier Parcollet, Nils Wentzell
 
 #include <triqs/test_tools/arrays.hpp>
+#include <algorithm>
 #include <random>
 #include <vector>
 #include <triqs/mc_tools/MersenneRNG.hpp>
+#include <triqs/mc_tools/philox.hpp>
+#include <triqs/mc_tools/random_generator.hpp>
 #include <boost/random/uniform_real.hpp>
 #include <boost/random/mersenne_twister.hpp>
 #include <boost/random/lagged_fibonacci.hpp>
@@ -59,6 +62,93 @@ TEST(Random, Mersenne) {
   for (int i = 0; i < 100; ++i) EXPECT_EQ(result[i], gb());
 }
 
+TEST(Random, Philox) {
+
+  using triqs::mc_tools::philox4x32;
+
+  // Known answers of the Random123 library
+  auto r = philox4x32::bijection({0, 0, 0, 0}, 0, 0);
+  EXPECT_EQ(r, (std::array<uint32_t, 4>{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}));
+  r = philox4x32::bijection({0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}, 0xa4093822, 0x299f31d0);
+  EXPECT_EQ(r, (std::array<uint32_t, 4>{0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}));
+
+  // discard is equivalent to drawing
+  philox4x32 g1(1352, 3), g2(1352, 3);
+  for (int i = 0; i < 7; ++i) g1();
+  g2.discard(7);
+  EXPECT_EQ(g1, g2);
+  for (int i = 0; i < 1001; ++i) g1();
+  g2.discard(1001);
+  for (int i = 0; i < 10; ++i) EXPECT_EQ(g1(), g2());
+
+  // fill_uniform gives the same numbers as the scalar path, for any alignment
+  for (int shift : {0, 1, 2, 5}) {
+    philox4x32 g3(1352), g4(1352);
+    g3.discard(shift);
+    g4.discard(shift);
+    std::vector<double> v(100);
+    g3.fill_uniform(v.data(), v.data() + v.size());
+    for (auto x : v) {
+      double y;
+      g4.fill_uniform(&y, &y + 1);
+      EXPECT_EQ(x, y);
+      EXPECT_TRUE(x >= 0 and x < 1);
+    }
+    EXPECT_EQ(g3, g4);
+  }
+
+  // streams are reproducible and different
+  auto s1 = g1.split(12), s2 = g2.split(12), s3 = g1.split(13);
+  EXPECT_EQ(s1, s2);
+  EXPECT_EQ(s1.stream_id(), 12);
+  int n_equal = 0;
+  for (int i = 0; i < 100; ++i) n_equal += (s1() == s3());
+  EXPECT_LT(n_equal, 2);
+}
+
+TEST(Random, CounterBasedRandomGenerator) {
+
+  auto names = triqs::mc_tools::random_generator_names_list();
+  EXPECT_NE(std::find(names.begin(), names.end(), "philox4x32"), names.end());
+
+  triqs::mc_tools::random_generator R("philox4x32", 1352);
+  EXPECT_TRUE(R.is_counter_based());
+  EXPECT_FALSE(triqs::mc_tools::random_generator("mt19937", 1352).is_counter_based());
+
+  // split gives a reproducible sequence
+  auto R1 = R.split(4), R2 = triqs::mc_tools::random_generator("philox4x32", 1352, 4);
+  double mean = 0;
+  int N       = 100000;
+  for (int i = 0; i < N; ++i) {
+    double x = R1();
+    EXPECT_EQ(x, R2());
+    mean += x / N;
+  }
+  EXPECT_NEAR(mean, 0.5, 0.01);
+
+  EXPECT_THROW(triqs::mc_tools::random_generator("mt19937", 1352).split(1), triqs::runtime_error);
+}
+
+// The state of the generators is saved and restored exactly, in the middle of the buffer
+TEST(Random, State) {
+
+  auto names = triqs::mc_tools::random_generator_names_list();
+  names.push_back(""); // the default RandMT
+  for (auto const &name : names) {
+    triqs::mc_tools::random_generator R(name, 1352);
+    if (not R.has_state()) continue;
+    for (int i = 0; i < 2345; ++i) R();
+    auto state = R.get_state();
+
+    triqs::mc_tools::random_generator R2(name, 1);
+    R2.set_state(state);
+    EXPECT_EQ(R.position(), R2.position());
+    for (int i = 0; i < 3000; ++i) EXPECT_EQ(R(), R2());
+  }
+  EXPECT_TRUE(triqs::mc_tools::random_generator("mt19937", 1352).has_state());
+  EXPECT_TRUE(triqs::mc_tools::random_generator("", 1352).has_state());
+}
+
 #ifdef RANDOM_TEST_UNIFORM
 TEST(Random, MersenneUniform) {
 
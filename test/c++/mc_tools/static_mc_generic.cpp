@@ -0,0 +1,118 @@
+// Copyright (c) 2026 Simons Foundation
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You may obtain a copy of the License at
+//     https://www.gnu.org/licenses/gpl-3.0.txt
+
+#include <triqs/test_tools/arrays.hpp>
+#include <triqs/mc_tools/mc_generic.hpp>
+#include <triqs/utility/callbacks.hpp>
+#include <random>
+
+// --------------- the configuration: a spin in a field ---
+struct config_t {
+  double beta, h;
+  int spin = -1;
+};
+
+// --------------- a move: flip the spin ---------------
+struct flip {
+  config_t *config;
+  double attempt() { return std::exp(-2 * config->spin * config->h * config->beta); }
+  double accept() {
+    config->spin *= -1;
+    return 1.0;
+  }
+  void reject() {}
+};
+
+// --------------- a move which does nothing ---------------
+struct identity {
+  double attempt() { return 1.0; }
+  double accept() { return 1.0; }
+  void reject() {}
+};
+
+//  ----------------- a measurement: the magnetization ------------
+struct compute_m {
+  config_t *config;
+  double *m_result;
+  double Z = 0, M = 0;
+
+  void accumulate(double sign) {
+    Z += sign;
+    M += sign * config->spin;
+  }
+
+  void collect_results(mpi::communicator c) {
+    Z         = mpi::all_reduce(Z, c);
+    M         = mpi::all_reduce(M, c);
+    *m_result = M / Z;
+  }
+};
+
+mpi::communicator world;
+
+TEST(mc_generic, AliasTable) {
+  std::vector<double> w{1, 2, 3, 0, 4};
+  auto table = triqs::mc_tools::alias_table{w};
+  EXPECT_EQ(table.size(), w.size());
+
+  std::mt19937 gen(2837);
+  std::uniform_real_distribution<> dis(0.0, 1.0);
+  std::vector<double> freq(w.size(), 0);
+  long n = 1000000;
+  for (long k = 0; k < n; ++k) freq[table(dis(gen))] += 1.0 / n;
+
+  for (size_t i = 0; i < w.size(); ++i) EXPECT_NEAR(freq[i], w[i] / 10, 0.005);
+  EXPECT_EQ(freq[3], 0);
+}
+
+// With a single move, the static and type erased versions draw the same random numbers
+TEST(mc_generic, StaticSameAsDynamic) {
+  double m1 = 0, m2 = 0;
+  config_t config1{0.3, 0.5}, config2{0.3, 0.5};
+
+  triqs::mc_tools::mc_generic<double> mc1("", 2345, 0);
+  mc1.add_move(flip{&config1}, "flip");
+  mc1.add_measure(compute_m{&config1, &m1}, "magnetization");
+  mc1.warmup_and_accumulate(10, 10000, 10, triqs::utility::clock_callback(-1));
+  mc1.collect_results(world);
+
+  triqs::mc_tools::static_mc_generic<double, flip> mc2("", 2345, 0);
+  mc2.add_move(flip{&config2}, "flip");
+  mc2.add_measure(compute_m{&config2, &m2}, "magnetization");
+  mc2.warmup_and_accumulate(10, 10000, 10, triqs::utility::clock_callback(-1));
+  mc2.collect_results(world);
+
+  EXPECT_EQ(m1, m2);
+  EXPECT_EQ(mc1.get_acceptance_rates(), mc2.get_acceptance_rates());
+}
+
+TEST(mc_generic, StaticSeveralMoves) {
+  double m = 0;
+  config_t config{0.3, 0.5};
+
+  triqs::mc_tools::static_mc_generic<double, flip, identity> mc("", 2345, 0);
+  mc.add_move(identity{}, "identity", 3.0);
+  mc.add_move(flip{&config}, "flip", 1.0);
+  mc.add_measure(compute_m{&config, &m}, "magnetization");
+  mc.warmup_and_accumulate(10, 40000, 10, triqs::utility::clock_callback(-1));
+  mc.collect_results(world);
+
+  double bh = config.beta * config.h;
+  EXPECT_NEAR(m, std::tanh(bh), 0.02);
+  EXPECT_NEAR(mc.get_acceptance_rates()["flip"], std::exp(-bh) / std::cosh(bh), 0.02);
+  EXPECT_EQ(mc.get_acceptance_rates()["identity"], 1.0);
+}
+
+MAKE_MAIN;
@@ -0,0 +1,135 @@
+// Copyright (c) 2026 Simons Foundation
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You may obtain a copy of the License at
+//     https://www.gnu.org/licenses/gpl-3.0.txt
+
+#include <triqs/test_tools/arrays.hpp>
+#include <triqs/mc_tools/mc_generic.hpp>
+#include <triqs/stat/accumulator.hpp>
+#include <triqs/utility/callbacks.hpp>
+
+using triqs::stat::accumulator;
+
+// --------------- the configuration: a spin in a field ---
+struct config_t {
+  double beta, h;
+  int spin = -1;
+};
+
+// --------------- a move: flip the spin ---------------
+struct flip {
+  config_t *config;
+  double attempt() { return std::exp(-2 * config->spin * config->h * config->beta); }
+  double accept() {
+    config->spin *= -1;
+    return 1.0;
+  }
+  void reject() {}
+};
+
+// --------------- a slow move: flip the spin with probability p. Then tau = (1 - 2p) / 2p ---------------
+struct slow_flip {
+  config_t *config;
+  double p;
+  double attempt() { return p; }
+  double accept() {
+    config->spin *= -1;
+    return 1.0;
+  }
+  void reject() {}
+};
+
+//  ----------------- a measurement: the magnetization, with an accumulator ------------
+struct compute_m {
+  config_t *config;
+  accumulator<double> *acc;
+  void accumulate(double sign) { *acc << sign * config->spin; }
+  void collect_results(mpi::communicator) {}
+};
+
+// 1 + m / 2, with a mean 1 for h = 0 : its error is its relative error
+struct compute_shifted_m {
+  config_t *config;
+  accumulator<double> *acc;
+  void accumulate(double sign) { *acc << sign * (1 + 0.5 * config->spin); }
+  void collect_results(mpi::communicator) {}
+};
+
+mpi::communicator world;
+
+// The accumulation stops when the relative error of the magnetization is below the target
+TEST(mc_generic, TargetError) {
+  for (bool coll : {false, true}) {
+    config_t config{0.3, 0.5};
+    accumulator<double> acc{0.0, -1, 0};
+    triqs::mc_tools::mc_generic<double> mc("", 1234 + world.rank(), 0);
+    mc.add_move(flip{&config}, "flip");
+    mc.add_measure(compute_m{&config, &acc}, "magnetization");
+    mc.set_collective_stop(coll);
+    mc.set_target_error([&acc]() { return acc.relative_error(); }, 0.01, 50);
+
+    mc.warmup(100, 1, triqs::utility::clock_callback(-1), world);
+    int status = mc.accumulate(-1, 1, triqs::utility::clock_callback(-1), world);
+    EXPECT_EQ(status, 0);
+    EXPECT_LT(acc.relative_error(), 0.01);
+    if (not coll) { EXPECT_EQ(acc.data_input_count() % 50, 0); }
+    EXPECT_GT(acc.data_input_count(), 1000);
+
+    // the estimates of the accumulator are consistent. The flips anticorrelate the spin: tau < 0
+    double tau = acc.tau_int();
+    EXPECT_GT(tau, -0.5);
+    EXPECT_LT(tau, 0);
+    EXPECT_NEAR(acc.effective_sample_size(), acc.data_input_count() / (1 + 2 * tau), 1.e-6);
+  }
+}
+
+// Without reaching the target error, the run stops after its number of cycles
+TEST(mc_generic, TargetErrorNotReached) {
+  config_t config{0.3, 0.5};
+  accumulator<double> acc{0.0, -1, 0};
+  triqs::mc_tools::mc_generic<double> mc("", 1234, 0);
+  mc.add_move(flip{&config}, "flip");
+  mc.add_measure(compute_m{&config, &acc}, "magnetization");
+  mc.set_target_error([&acc]() { return acc.relative_error(); }, 1.e-6, 10);
+  EXPECT_EQ(mc.accumulate(1000, 1, triqs::utility::clock_callback(-1)), 0);
+  EXPECT_EQ(acc.data_input_count(), 1000);
+}
+
+// A strongly correlated series (tau = 24) does not stop as soon as the error of the unbinned data is below target,
+// but only when the binning errors have reached a plateau
+TEST(mc_generic, TargetErrorCorrelated) {
+  config_t config{0.3, 0.0};
+  accumulator<double> acc{0.0, -1, 0};
+  triqs::mc_tools::mc_generic<double> mc("", 4321, 0);
+  mc.add_move(slow_flip{&config, 0.02}, "slow flip");
+  mc.add_measure(compute_shifted_m{&config, &acc}, "shifted magnetization");
+
+  double target       = 0.05;
+  long count_unbinned = -1; // first check where the unbinned error is below target
+  mc.set_target_error(
+     [&]() {
+       auto [errors, counts] = acc.log_bin_errors();
+       if (count_unbinned < 0 and errors[0] > 0 and errors[0] <= target) count_unbinned = acc.data_input_count();
+       return acc.relative_error();
+     },
+     target, 10);
+
+  EXPECT_EQ(mc.accumulate(-1, 1, triqs::utility::clock_callback(-1)), 0);
+  EXPECT_TRUE(acc.has_plateau());
+  EXPECT_LT(acc.relative_error(), target);
+  EXPECT_GT(count_unbinned, 0);
+  EXPECT_GT(acc.data_input_count(), 5 * count_unbinned);
+  EXPECT_GT(acc.data_input_count(), 1000);
+}
+
+MAKE_MAIN;
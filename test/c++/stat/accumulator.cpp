@@ -23,6 +23,7 @@
 #include <triqs/stat/jackknife.hpp>
 #include <triqs/test_tools/arrays.hpp>
 #include <typeinfo>
+#include <random>
 
 using namespace triqs::stat;
 using namespace triqs::stat::details;
@@ -442,6 +443,203 @@ TEST(Stat, Accumulator_Chaining) {
   EXPECT_EQ(my_acc.data_input_count(), 4);
 }
 
+// Array valued data are binned element-wise in place: same result as one scalar accumulator per element,
+// for contiguous arrays, views with another layout and lazy expressions
+TEST(Stat, Accumulator_ArrayElementWise) {
+  using dcomplex = std::complex<double>;
+  using A        = nda::array<dcomplex, 2>;
+  A zero(3, 4);
+  zero = 0;
+  accumulator<A> acc{zero, -1, 7, 3};
+  std::vector<accumulator<dcomplex>> acc_s(12, accumulator<dcomplex>{0, -1, 7, 3});
+
+  std::mt19937 gen(1234);
+  std::uniform_real_distribution<> dis(-1.0, 1.0);
+  A x(3, 4);
+  nda::array<dcomplex, 2> xt(4, 3);
+  for (int n = 0; n < 2000; ++n) {
+    for (auto [i, j] : itertools::product_range(3, 4)) xt(j, i) = x(i, j) = dcomplex(dis(gen), dis(gen));
+    switch (n % 3) {
+      case 0: acc << x; break;
+      case 1: acc << nda::transpose(xt); break;
+      case 2: acc << 2.0 * x - x; break;
+    }
+    for (auto [i, j] : itertools::product_range(3, 4)) acc_s[4 * i + j] << x(i, j);
+  }
+
+  auto [errors, counts] = acc.log_bin_errors();
+  auto const &bins      = acc.linear_bins();
+  for (auto [i, j] : itertools::product_range(3, 4)) {
+    auto [errors_s, counts_s] = acc_s[4 * i + j].log_bin_errors();
+    ASSERT_EQ(errors.size(), errors_s.size());
+    EXPECT_EQ(counts, counts_s);
+    for (size_t n = 0; n < errors.size(); ++n) EXPECT_NEAR(errors[n](i, j), errors_s[n], 1.e-13);
+    auto const &bins_s = acc_s[4 * i + j].linear_bins();
+    ASSERT_EQ(bins.size(), bins_s.size());
+    for (size_t n = 0; n < bins.size(); ++n) EXPECT_COMPLEX_NEAR(bins[n](i, j), bins_s[n], 1.e-13);
+  }
+}
+
+// Merging: when the first accumulator holds a multiple of the largest bin capacities,
+// the result is the one of a single accumulator fed with all the data, also for the data added after the merge
+TEST(Stat, Accumulator_Merge) {
+  std::mt19937 gen(4321);
+  std::uniform_real_distribution<> dis(-1.0, 1.0);
+  double y    = 0;
+  auto series = [&](long n) {
+    vec_d r;
+    for (long i = 0; i < n; ++i) r.push_back(y = 0.8 * y + dis(gen));
+    return r;
+  };
+  auto xa = series(1024), xb = series(777), xc = series(3000);
+
+  accumulator<double> acc_a{0.0, -1, -1, 4}, acc_b{0.0, -1, -1, 4}, acc_all{0.0, -1, -1, 4};
+  for (auto x : xa) acc_a << x;
+  for (auto x : xb) acc_b << x;
+  for (auto const &v : {xa, xb})
+    for (auto x : v) acc_all << x;
+
+  auto check = [&]() {
+    EXPECT_EQ(acc_a.data_input_count(), acc_all.data_input_count());
+    auto [errors, counts]         = acc_a.log_bin_errors();
+    auto [errors_all, counts_all] = acc_all.log_bin_errors();
+    EXPECT_EQ(counts, counts_all);
+    ASSERT_EQ(errors.size(), errors_all.size());
+    for (size_t n = 0; n < errors.size(); ++n) EXPECT_NEAR(errors[n], errors_all[n], 1.e-13);
+    ASSERT_EQ(acc_a.linear_bins().size(), acc_all.linear_bins().size());
+    for (size_t n = 0; n < acc_a.linear_bins().size(); ++n) EXPECT_NEAR(acc_a.linear_bins()[n], acc_all.linear_bins()[n], 1.e-13);
+  };
+
+  acc_a.merge(acc_b);
+  check();
+  for (auto x : xc) {
+    acc_a << x;
+    acc_all << x;
+  }
+  check();
+
+  // Otherwise, the errors at level 0 and the counts are still exact
+  accumulator<double> acc_c{0.0, -1, 5, 3}, acc_d{0.0, -1, 5, 3}, acc_cd{0.0, -1, 5, 3};
+  for (auto x : xb) acc_c << x;
+  for (auto x : xc) acc_d << x;
+  for (auto const &v : {xb, xc})
+    for (auto x : v) acc_cd << x;
+  acc_c.merge(acc_d);
+  auto [errors, counts]       = acc_c.log_bin_errors();
+  auto [errors_cd, counts_cd] = acc_cd.log_bin_errors();
+  EXPECT_EQ(counts, counts_cd);
+  EXPECT_NEAR(errors[0], errors_cd[0], 1.e-13);
+  EXPECT_EQ(acc_c.linear_bins().size(), 5);
+
+  accumulator<double> acc_e{0.0, -1, 4, 3};
+  EXPECT_THROW(acc_c.merge(acc_e), triqs::runtime_error);
+}
+
+// Merging accumulators whose numbers of data points are not multiples of the bin capacity :
+// the bins hold the numbers of data points of a single accumulator fed with the same data, before and after compression.
+TEST(Stat, Accumulator_MergePartialBins) {
+  std::mt19937 gen(1234);
+  std::uniform_real_distribution<> dis(-1.0, 1.0);
+  auto series = [&](long n) {
+    vec_d r;
+    for (long i = 0; i < n; ++i) r.push_back(dis(gen));
+    return r;
+  };
+  auto xa = series(779), xb = series(1003), xc = series(1001); // 779 % 4 + 1003 % 4 = 6 > 4
+
+  // sum of the data from the bins : all bins are full, except the last one
+  auto bin_sum = [](accumulator<double> const &acc) {
+    auto const &bins = acc.linear_bins();
+    long cap = acc.lin_bin_capacity(), n = bins.size();
+    double r = bins.back() * double(acc.data_input_count() - (n - 1) * cap);
+    for (long i = 0; i < n - 1; ++i) r += bins[i] * double(cap);
+    return r;
+  };
+
+  for (int n_lin_bins_max : {-1, 300}) {
+    accumulator<double> acc_a{0.0, -1, n_lin_bins_max, 4}, acc_b{0.0, -1, n_lin_bins_max, 4}, acc_all{0.0, -1, n_lin_bins_max, 4};
+    for (auto x : xa) acc_a << x;
+    for (auto x : xb) acc_b << x;
+    for (auto const &v : {xa, xb})
+      for (auto x : v) acc_all << x;
+
+    auto check = [&]() {
+      EXPECT_EQ(acc_a.data_input_count(), acc_all.data_input_count());
+      EXPECT_EQ(acc_a.lin_bin_capacity(), acc_all.lin_bin_capacity());
+      EXPECT_EQ(acc_a.n_lin_bins(), acc_all.n_lin_bins());
+      EXPECT_NEAR(bin_sum(acc_a), bin_sum(acc_all), 1.e-10);
+    };
+
+    acc_a.merge(acc_b);
+    check();
+    // the full bins of the first accumulator are unchanged (no compression)
+    if (n_lin_bins_max < 0)
+      for (size_t n = 0; n < xa.size() / 4; ++n) EXPECT_NEAR(acc_a.linear_bins()[n], acc_all.linear_bins()[n], 1.e-13);
+    for (auto x : xc) {
+      acc_a << x;
+      acc_all << x;
+    }
+    check();
+  }
+}
+
+// Autocorrelation estimates on an AR(1) series x_{i+1} = phi x_i + noise, for which tau = phi / (1 - phi)
+TEST(Stat, Accumulator_TauInt) {
+  double phi = 0.8;
+  std::mt19937 gen(987);
+  std::normal_distribution<> dis(0.0, 1.0);
+  using A = nda::array<double, 1>;
+  accumulator<A> acc{A(2), -1, 0};
+  A x(2);
+  x = 0;
+  for (long i = 0; i < (1 << 18); ++i) {
+    x(0) = phi * x(0) + dis(gen);
+    x(1) = 1 + dis(gen); // no correlation
+    acc << x;
+  }
+  auto tau = acc.tau_int(256);
+  EXPECT_EQ(acc.plateau_level(256), 10);
+  EXPECT_NEAR(tau(0), phi / (1 - phi), 1.0);
+  EXPECT_NEAR(tau(1), 0, 0.2);
+
+  auto ess = acc.effective_sample_size(256);
+  EXPECT_NEAR(ess(0), (1 << 18) / (1 + 2 * tau(0)), 1.e-6);
+
+  // the relative error is the one of the element with the largest error over mean : x(0) has a zero mean
+  EXPECT_GT(acc.relative_error(64), 1);
+  accumulator<double> acc1{0.0, -1, 0};
+  for (long i = 0; i < (1 << 18); ++i) acc1 << 1 + dis(gen);
+  EXPECT_NEAR(acc1.relative_error(64), 1 / std::sqrt(1 << 18), 0.2 / std::sqrt(1 << 18));
+
+  // no data
+  accumulator<double> acc2{0.0, -1, 0};
+  EXPECT_EQ(acc2.relative_error(), std::numeric_limits<double>::infinity());
+  EXPECT_THROW((void)accumulator<double>(0.0, 0, 1).tau_int(), triqs::runtime_error);
+}
+
+// A strongly correlated series (tau ~ 100) : as long as the bins are not large compared to tau, the errors grow with the level,
+// there is no plateau and the relative error is +infinity, although the error of the unbinned data is small.
+TEST(Stat, Accumulator_RelativeErrorPlateau) {
+  double phi = 0.99, y = 0;
+  std::mt19937 gen(4242);
+  std::normal_distribution<> dis(0.0, 1.0);
+  accumulator<double> acc{0.0, -1, 0};
+  auto add = [&](long n) {
+    for (long i = 0; i < n; ++i) acc << 10 + (y = phi * y + dis(gen));
+  };
+
+  add(4096);
+  EXPECT_FALSE(acc.has_plateau());
+  EXPECT_EQ(acc.relative_error(), std::numeric_limits<double>::infinity());
+  auto [errors, counts] = acc.log_bin_errors();
+  EXPECT_LT(errors[0], errors[acc.plateau_level()] / 3);
+
+  add(1 << 20);
+  EXPECT_TRUE(acc.has_plateau(128));
+  double rel_error = std::sqrt((1 + phi) / (1 - phi) / (1 - phi * phi) / acc.data_input_count()) / 10;
+  EXPECT_NEAR(acc.relative_error(128), rel_error, 0.2 * rel_error);
+}
+
 // *****************************************************************************
 // tau_estimate_from_errors
 
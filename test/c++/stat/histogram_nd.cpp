@@ -0,0 +1,110 @@
+// Copyright (c) 2026 Simons Foundation
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You may obtain a copy of the License at
+//     https://www.gnu.org/licenses/gpl-3.0.txt
+
+#include <triqs/test_tools/arrays.hpp>
+#include <triqs/stat/histogram_nd.hpp>
+#include <limits>
+#include <random>
+
+using namespace triqs::stat;
+
+TEST(histogram_nd, basic) {
+
+  histogram_nd<2> h{{0, 0}, {10, 1}, {11, 3}};
+  h << std::array{0.0, 0.0} << std::array{1.2, 0.3} << std::array{1.4, 0.2} << std::array{10.0, 1.0} << std::array{-1.0, 0.5}
+    << std::array{5.0, 1.5};
+  h.push({3.0, 0.6}, 2.5);
+
+  nda::array<double, 2> true_h(11, 3);
+  true_h()        = 0;
+  true_h(0, 0)    = 1;
+  true_h(1, 1)    = 1;
+  true_h(1, 0)    = 1;
+  true_h(10, 2)   = 1;
+  true_h(3, 1)    = 2.5;
+
+  EXPECT_ARRAY_NEAR(true_h, h.data());
+  EXPECT_EQ(5, h.n_data_pts());
+  EXPECT_EQ(2, h.n_lost_pts());
+  EXPECT_EQ(0.5, h.mesh_point(1, 1));
+  EXPECT_EQ(std::make_pair(0.0, 10.0), h.limits(0));
+  EXPECT_ARRAY_NEAR(true_h / 6.5, pdf(h).data());
+
+  auto h2 = h + h;
+  EXPECT_ARRAY_NEAR(2 * true_h, h2.data());
+  EXPECT_EQ(10, h2.n_data_pts());
+  EXPECT_THROW(h + histogram_nd<2>({0, 0}, {10, 1}, {11, 4}), triqs::runtime_error);
+
+  h.clear();
+  EXPECT_EQ(0, h.n_data_pts());
+  EXPECT_ARRAY_NEAR(0 * true_h, h.data());
+}
+
+TEST(histogram_nd, push_batch) {
+
+  std::mt19937 gen(3);
+  std::normal_distribution<double> distr(0.5, 0.4);
+  std::vector<std::array<double, 3>> xs(50000);
+  std::vector<double> ws(xs.size());
+  for (auto &x : xs) x = {distr(gen), distr(gen), distr(gen)};
+  for (auto &w : ws) w = distr(gen);
+
+  histogram_nd<3> h{{0, 0, 0}, {1, 1, 1}, {6, 5, 4}}, hw = h;
+  for (auto const &x : xs) h << x;
+  for (int i = 0; i < xs.size(); ++i) hw.push(xs[i], ws[i]);
+
+  auto h_batch = histogram_nd<3>{{0, 0, 0}, {1, 1, 1}, {6, 5, 4}}, hw_batch = h_batch;
+  h_batch.push_batch(xs, 4);
+  hw_batch.push_batch(xs, ws, 4);
+
+  EXPECT_EQ(h, h_batch);
+  EXPECT_ARRAY_NEAR(hw.data(), hw_batch.data(), 1e-10);
+  EXPECT_EQ(hw.n_data_pts(), hw_batch.n_data_pts());
+  EXPECT_EQ(hw.n_lost_pts(), hw_batch.n_lost_pts());
+}
+
+TEST(histogram_nd, nan) {
+
+  double nan = std::numeric_limits<double>::quiet_NaN();
+  std::vector<std::array<double, 2>> xs{{nan, 0.5}, {5.0, nan}, {nan, nan}, {5.0, 0.5}};
+  std::vector<double> ws{1.0, 2.0, 3.0, 4.0};
+
+  histogram_nd<2> h{{0, 0}, {10, 1}, {11, 3}}, hw = h, h_batch = h, hw_batch = h;
+  for (auto const &x : xs) h << x;
+  for (int i = 0; i < xs.size(); ++i) hw.push(xs[i], ws[i]);
+  h_batch.push_batch(xs);
+  hw_batch.push_batch(xs, ws);
+
+  nda::array<double, 2> true_h(11, 3);
+  true_h()     = 0;
+  true_h(5, 1) = 1;
+  EXPECT_ARRAY_NEAR(true_h, h.data());
+  EXPECT_ARRAY_NEAR(4 * true_h, hw.data());
+  EXPECT_EQ(1, h.n_data_pts());
+  EXPECT_EQ(3, h.n_lost_pts());
+  EXPECT_EQ(h, h_batch);
+  EXPECT_EQ(hw, hw_batch);
+}
+
+TEST(histogram_nd, hdf5) {
+
+  histogram_nd<2> h{{0, -1}, {10, 1}, {11, 3}};
+  h << std::array{1.2, 0.3} << std::array{20.0, 0.0};
+
+  auto h_r = rw_h5(h, "histogram_nd", "h");
+  EXPECT_EQ(h, h_r);
+}
+
+MAKE_MAIN;
@@ -22,6 +22,8 @@
 #include <triqs/arrays.hpp>
 #include <triqs/stat/histograms.hpp>
 #include <triqs/test_tools/arrays.hpp>
+#include <limits>
+#include <random>
 using namespace triqs::stat;
 namespace arrays = triqs::arrays;
 
@@ -158,6 +160,67 @@ TEST(histogram, cdf) {
   EXPECT_ARRAY_NEAR(true_cdf_hi1, cdf_hi1.data());
 }
 
+TEST(histogram, push_batch) {
+
+  std::vector<double> data{-10, -0.05, 1.1, 2.0, 2.2, 2.9, 3.4, 5, 9, 10.0, 10.5, 12.1, 32.2};
+  histogram hd1{0, 10, 21};
+  hd1.push_batch(data);
+  EXPECT_EQ(make_hd1(), hd1);
+
+  // large batches, on several threads
+  std::mt19937 gen(2);
+  std::normal_distribution<double> distr(5, 3);
+  std::vector<double> xs(100000);
+  for (auto &x : xs) x = distr(gen);
+
+  histogram h{0, 10, 51}, h_batch{0, 10, 51}, h_threads{0, 10, 51};
+  for (auto x : xs) h << x;
+  h_batch.push_batch(xs);
+  h_threads.push_batch(xs, 4);
+  EXPECT_EQ(h, h_batch);
+  EXPECT_EQ(h, h_threads);
+}
+
+TEST(histogram, weighted) {
+
+  std::vector<double> xs{-1, 0, 0.2, 1.1, 2.0, 5, 9.9, 10.0, 12};
+  std::vector<double> ws{5, 1, 2, 0.5, 1.5, 3, 1, 2, 7};
+
+  histogram h{0, 10}, h_batch{0, 10};
+  for (int i = 0; i < xs.size(); ++i) h.push(xs[i], ws[i]);
+  h_batch.push_batch(xs, ws);
+
+  nda::vector<double> true_h = {3, 0.5, 1.5, 0, 0, 3, 0, 0, 0, 0, 3};
+  EXPECT_ARRAY_NEAR(true_h, h.data());
+  EXPECT_EQ(7, h.n_data_pts());
+  EXPECT_EQ(2, h.n_lost_pts());
+  EXPECT_EQ(h, h_batch);
+
+  EXPECT_ARRAY_NEAR(true_h / 11.0, pdf(h).data());
+  EXPECT_THROW(h_batch.push_batch(xs, std::span{ws}.subspan(1)), triqs::runtime_error);
+}
+
+TEST(histogram, nan) {
+
+  double nan = std::numeric_limits<double>::quiet_NaN();
+  std::vector<double> xs{nan, 2.0, -nan, 9.9};
+  std::vector<double> ws{5, 1.5, 2, 1};
+
+  histogram h{0, 10}, hw{0, 10}, h_batch{0, 10}, hw_batch{0, 10};
+  for (auto x : xs) h << x;
+  for (int i = 0; i < xs.size(); ++i) hw.push(xs[i], ws[i]);
+  h_batch.push_batch(xs);
+  hw_batch.push_batch(xs, ws);
+
+  nda::vector<double> true_h = {0, 0, 1.5, 0, 0, 0, 0, 0, 0, 0, 1};
+  EXPECT_ARRAY_NEAR(true_h, hw.data());
+  EXPECT_EQ(2, h.n_data_pts());
+  EXPECT_EQ(2, h.n_lost_pts());
+  EXPECT_EQ(2, hw.n_lost_pts());
+  EXPECT_EQ(h, h_batch);
+  EXPECT_EQ(hw, hw_batch);
+}
+
 // ------------------------
 
 MAKE_MAIN;
@@ -31,6 +31,7 @@
 #include <boost/random/mersenne_twister.hpp>
 #include <boost/random/normal_distribution.hpp>
 #include <itertools/itertools.hpp>
+#include <atomic>
 using namespace triqs::stat;
 using namespace triqs::gfs;
 using namespace triqs::arrays;
@@ -199,6 +200,56 @@ TEST(Binned, array) {
   expect_near(d2, xd(1, 0));
 }
 
+//------------------------------------------------------
+
+// f is evaluated once per sample, and the result does not depend on the number of threads
+TEST(Stat, ResamplingThreads) {
+
+  accumulator<double> a{0.0, 0, 100, 1}, b{0.0, 0, 100, 1};
+  {
+    boost::variate_generator<boost::mt19937, boost::normal_distribution<>> generator((boost::mt19937(seed)), (boost::normal_distribution<>()));
+    for (long i = 0; i < 100; ++i) {
+      a << generator();
+      b << 3 + generator();
+    }
+  }
+
+  std::atomic<long> n_calls = 0;
+  auto a_b                  = [&n_calls](auto const &val1, auto const &val2) {
+    ++n_calls;
+    return val1 / val2;
+  };
+
+  auto [x, d, xj, xn] = jackknife_mpi(world, a_b, a, b);
+  EXPECT_EQ(n_calls, 100 + 1);
+
+  for (int n_threads : {2, 3, 7}) {
+    auto [x1, d1, xj1, xn1] = jackknife_mpi(world, resampling_params{.n_threads = n_threads}, a_b, a, b);
+    EXPECT_NEAR(x, x1, 1.e-13);
+    EXPECT_NEAR(d, d1, 1.e-13);
+    EXPECT_NEAR(xj, xj1, 1.e-13);
+    expect_near(xn, xn1);
+  }
+
+  // bootstrap : reproducible, independent of the number of threads, with the same error as the jackknife
+  n_calls                 = 0;
+  auto [y, e, yb, yn]     = bootstrap(resampling_params{.n_samples = 2000}, a_b, a, b);
+  EXPECT_EQ(n_calls, 2000 + 1);
+  auto [y1, e1, yb1, yn1] = bootstrap(resampling_params{.n_threads = 4, .n_samples = 2000}, a_b, a, b);
+  EXPECT_NEAR(e, e1, 1.e-13);
+  EXPECT_NEAR(yb, yb1, 1.e-13);
+  expect_near(yn, xn);
+  EXPECT_NEAR(e / d, 1, 0.1);
+  EXPECT_NEAR(y, x, d);
+
+  // the bins are all on this node
+  auto [y2, e2, yb2, yn2] = bootstrap_mpi(world, resampling_params{.n_threads = 3, .n_samples = 2000}, a_b, a, b);
+  if (world.size() == 1) {
+    EXPECT_NEAR(e, e2, 1.e-13);
+    EXPECT_NEAR(yb, yb2, 1.e-13);
+  }
+}
+
 /*
 //------------------------------------------------------
 
@@ -0,0 +1,72 @@
+// Copyright (c) 2026 Simons Foundation
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You may obtain a copy of the License at
+//     https://www.gnu.org/licenses/gpl-3.0.txt
+
+#include <triqs/stat/sharded_accumulator.hpp>
+#include <triqs/test_tools/arrays.hpp>
+#include <random>
+#include <thread>
+
+using namespace triqs::stat;
+
+// Each thread pushes its own series, while snapshots are taken.
+// The final snapshot has the counts and the errors at level 0 of one accumulator fed with all the data.
+TEST(Stat, ShardedAccumulator_Threads) {
+  int n_threads = 4;
+  long n        = 20000;
+  auto series   = [n](int seed) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<> dis(-1.0, 1.0);
+    std::vector<double> r;
+    double y = 0;
+    for (long i = 0; i < n; ++i) r.push_back(y = 0.8 * y + dis(gen));
+    return r;
+  };
+
+  sharded_accumulator<double> acc{0.0, n_threads, -1, 64, 1};
+  EXPECT_EQ(acc.n_shards(), n_threads);
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < n_threads; ++t)
+    threads.emplace_back([&, t] {
+      for (auto x : series(t)) acc.push(t, x);
+    });
+  for (int k = 0; k < 20; ++k) EXPECT_LE(acc.snapshot().data_input_count(), n_threads * n);
+  for (auto &th : threads) th.join();
+
+  accumulator<double> acc_all{0.0, -1, 64, 1};
+  double sum = 0;
+  for (int t = 0; t < n_threads; ++t)
+    for (auto x : series(t)) {
+      acc_all << x;
+      sum += x;
+    }
+
+  auto snap = acc.snapshot();
+  EXPECT_EQ(snap.data_input_count(), n_threads * n);
+  auto [errors, counts]         = snap.log_bin_errors();
+  auto [errors_all, counts_all] = acc_all.log_bin_errors();
+  EXPECT_EQ(counts, counts_all);
+  EXPECT_NEAR(errors[0], errors_all[0], 1.e-12);
+
+  // The linear bins are full, except the last one
+  auto const &bins = snap.linear_bins();
+  long cap = snap.lin_bin_capacity(), n_full = (bins.size() - 1) * cap;
+  double s = 0;
+  for (size_t i = 0; i + 1 < bins.size(); ++i) s += bins[i] * cap;
+  s += bins.back() * (n_threads * n - n_full);
+  EXPECT_NEAR(s, sum, 1.e-8);
+}
+
+MAKE_MAIN;
@@ -27,5 +27,29 @@ TEST(BufferedFunction, All) {
   };
   auto gen = triqs::utility::buffered_function<double>(f, 5);
   for (int u = 0; u < 22; ++u) EXPECT_EQ(gen(), u * u);
+  EXPECT_FALSE(gen.has_state());
+}
+
+// A function whose state can be written and read
+struct counter {
+  long x = 0;
+  double operator()() { return 0.5 * x++; }
+  friend std::ostream &operator<<(std::ostream &os, counter const &c) { return os << c.x; }
+  friend std::istream &operator>>(std::istream &is, counter &c) { return is >> c.x; }
+};
+
+TEST(BufferedFunction, State) {
+  auto gen = triqs::utility::buffered_function<double>(counter{}, 5);
+  EXPECT_TRUE(gen.has_state());
+  for (int u = 0; u < 13; ++u) gen();
+  auto state = gen.get_state();
+
+  auto gen2 = triqs::utility::buffered_function<double>(counter{}, 5);
+  gen2.set_state(state);
+  EXPECT_EQ(gen.position(), gen2.position());
+  for (int u = 13; u < 30; ++u) {
+    EXPECT_EQ(gen2(), 0.5 * u);
+    EXPECT_EQ(gen(), 0.5 * u);
+  }
 }
 MAKE_MAIN;